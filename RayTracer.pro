@@ -0,0 +1,16 @@
+# ----------------------------------------------------
+# Builds the engine library, then the GUI, the headless renderer and the
+# benchmark
+# ----------------------------------------------------
+
+TEMPLATE = subdirs
+CONFIG += ordered
+SUBDIRS = engine gui cli bench
+
+engine.file = RayTracerEngine.pro
+gui.file = RayTracerCPU.pro
+gui.depends = engine
+cli.file = RayTracerCLI.pro
+cli.depends = engine
+bench.file = RayTracerBench.pro
+bench.depends = engine
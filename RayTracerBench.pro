@@ -0,0 +1,18 @@
+# ----------------------------------------------------
+# Benchmark of the engine, writes the results as JSON
+# ----------------------------------------------------
+
+TEMPLATE = app
+TARGET = RayTracerBench
+DESTDIR = ./release
+CONFIG += console release
+CONFIG -= qt app_bundle
+INCLUDEPATH += .
+DEPENDPATH += .
+OBJECTS_DIR += release/bench
+
+include(RayTracerEngine.pri)
+LIBS += $$engineLibrary()
+PRE_TARGETDEPS += $$engineLibrary()
+
+SOURCES += ./rtbench.cpp
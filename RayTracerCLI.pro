@@ -0,0 +1,18 @@
+# ----------------------------------------------------
+# Headless renderer, renders an OBJ model to an image file without Qt
+# ----------------------------------------------------
+
+TEMPLATE = app
+TARGET = RayTracerCLI
+DESTDIR = ./release
+CONFIG += console release
+CONFIG -= qt app_bundle
+INCLUDEPATH += .
+DEPENDPATH += .
+OBJECTS_DIR += release/cli
+
+include(RayTracerEngine.pri)
+LIBS += $$engineLibrary()
+PRE_TARGETDEPS += $$engineLibrary()
+
+SOURCES += ./rtcli.cpp
@@ -0,0 +1,55 @@
+# ----------------------------------------------------
+# The ray tracing engine, it does not depend on Qt.
+# Included by the engine library and the programs linking it.
+# ----------------------------------------------------
+
+# the tile renderer uses std::thread
+*-g++*|*clang*:QMAKE_CXXFLAGS += -std=c++11
+unix:LIBS += -lpthread
+
+# qmake CONFIG+=single_precision builds the float engine, double is the default
+single_precision:DEFINES += RT_SINGLE_PRECISION
+
+# qmake CONFIG+=stats counts the traversal statistics, see stats.h
+stats:DEFINES += RT_STATS
+
+ENGINE_HEADERS = ./AccessObj.h \
+    ./arena.h \
+    ./bvh.h \
+    ./Camera.h \
+    ./common.h \
+    ./framebuffer.h \
+    ./mappedfile.h \
+    ./material.h \
+    ./MathDefs.h \
+    ./objfile.h \
+    ./Point3D.h \
+    ./primitive.h \
+    ./raytracer.h \
+    ./scene.h \
+    ./scenecache.h \
+    ./simd.h \
+    ./stats.h \
+    ./threadpool.h \
+    ./twister.h
+ENGINE_SOURCES = ./AccessObj.cpp \
+    ./arena.cpp \
+    ./bvh.cpp \
+    ./Camera.cpp \
+    ./framebuffer.cpp \
+    ./mappedfile.cpp \
+    ./material.cpp \
+    ./objfile.cpp \
+    ./Point3D.cpp \
+    ./primitive.cpp \
+    ./raytracer.cpp \
+    ./scene.cpp \
+    ./scenecache.cpp \
+    ./threadpool.cpp \
+    ./twister.cpp
+
+# link the engine library built by RayTracerEngine.pro
+defineReplace(engineLibrary) {
+    win32:return(./release/RayTracerEngine.lib)
+    return(./release/libRayTracerEngine.a)
+}
@@ -0,0 +1,16 @@
+# ----------------------------------------------------
+# Static library of the ray tracing engine, without Qt
+# ----------------------------------------------------
+
+TEMPLATE = lib
+TARGET = RayTracerEngine
+DESTDIR = ./release
+CONFIG += staticlib release
+CONFIG -= qt
+INCLUDEPATH += .
+DEPENDPATH += .
+OBJECTS_DIR += release/engine
+
+include(RayTracerEngine.pri)
+HEADERS += $$ENGINE_HEADERS
+SOURCES += $$ENGINE_SOURCES
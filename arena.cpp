@@ -0,0 +1,104 @@
+/********************************************************************
+	created:	2026/10/17
+	file name:	arena.cpp
+	author:		maxint lnychina@gmail.com
+*********************************************************************/
+
+#include "arena.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace RayTracer {
+
+// ------------------------------------------------------------------------------
+// MemoryArena class implementation
+// ------------------------------------------------------------------------------
+
+MemoryArena::MemoryArena()
+: mCurrent(0)
+{
+}
+
+MemoryArena::~MemoryArena()
+{
+	release();
+}
+
+void* MemoryArena::alloc(size_t aSize, size_t aAlign)
+{
+	assert(aAlign > 0 && aAlign <= RT_ARENA_ALIGN && (aAlign & (aAlign - 1)) == 0);
+
+	// the blocks after the current one are free ones kept by reset()
+	for (; mCurrent<mBlocks.size(); ++mCurrent)
+	{
+		Block &block = mBlocks[mCurrent];
+		size_t offset = (block.mUsed + aAlign - 1) & ~(aAlign - 1);
+		if (offset + aSize <= block.mSize)
+		{
+			block.mUsed = offset + aSize;
+			return block.mData + offset;
+		}
+	}
+
+	_addBlock(std::max(aSize, static_cast<size_t>(RT_ARENA_BLOCKSIZE)));
+	Block &block = mBlocks.back();
+	block.mUsed = aSize;
+	return block.mData;
+}
+
+void MemoryArena::_addBlock(size_t aSize)
+{
+	// NOTE: malloc() aligns to 16 only, round up the size instead of
+	// depending on aligned allocation of the compiler
+	Block block;
+	block.mSize = (aSize + RT_ARENA_ALIGN - 1) & ~static_cast<size_t>(RT_ARENA_ALIGN - 1);
+	char *raw = static_cast<char*>(malloc(block.mSize + RT_ARENA_ALIGN + sizeof(void*)));
+	if (!raw)
+		throw std::bad_alloc();
+	size_t addr = reinterpret_cast<size_t>(raw + sizeof(void*));
+	block.mData = reinterpret_cast<char*>((addr + RT_ARENA_ALIGN - 1) & ~static_cast<size_t>(RT_ARENA_ALIGN - 1));
+	reinterpret_cast<char**>(block.mData)[-1] = raw;
+	block.mUsed = 0;
+	mBlocks.push_back(block);
+	mCurrent = mBlocks.size() - 1;
+}
+
+void MemoryArena::reset()
+{
+	if (mBlocks.size() > 1)
+	{
+		size_t total = getReserved();
+		release();
+		_addBlock(total);
+	}
+	for (size_t i=0; i<mBlocks.size(); ++i)
+		mBlocks[i].mUsed = 0;
+	mCurrent = 0;
+}
+
+void MemoryArena::release()
+{
+	for (size_t i=0; i<mBlocks.size(); ++i)
+		free(reinterpret_cast<char**>(mBlocks[i].mData)[-1]);
+	mBlocks.clear();
+	mCurrent = 0;
+}
+
+size_t MemoryArena::getUsed() const
+{
+	size_t used = 0;
+	for (size_t i=0; i<mBlocks.size(); ++i)
+		used += mBlocks[i].mUsed;
+	return used;
+}
+
+size_t MemoryArena::getReserved() const
+{
+	size_t size = 0;
+	for (size_t i=0; i<mBlocks.size(); ++i)
+		size += mBlocks[i].mSize;
+	return size;
+}
+
+}; // namespace RayTracer
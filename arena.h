@@ -0,0 +1,156 @@
+/********************************************************************
+	created:	2026/10/17
+	file name:	arena.h
+	author:		maxint lnychina@gmail.com
+*********************************************************************/
+
+#ifndef _RT_ARENA_H_
+#define _RT_ARENA_H_
+
+#include "common.h"
+#include <new>
+#include <vector>
+#include <cassert>
+
+#define RT_ARENA_BLOCKSIZE	(1 << 20)	// bytes of a block, larger requests get their own
+#define RT_ARENA_ALIGN		64			// arrays start on a cache line
+
+namespace RayTracer {
+
+// ------------------------------------------------------------------------------
+// Scene lifetime memory arena
+// ------------------------------------------------------------------------------
+
+/**	Hands out memory from a few large blocks by bumping a pointer. Nothing
+	is freed one by one: reset() forgets all the allocations at once and
+	keeps the memory for the next scene, release() gives it back.
+	The destructors of the objects in the arena are never run.
+ */
+class MemoryArena
+{
+public:
+	MemoryArena();
+	~MemoryArena();
+
+	/**	Allocate uninitialized memory
+	\param
+		aSize	bytes
+		aAlign	power of 2, at most RT_ARENA_ALIGN
+	 */
+	void* alloc(size_t aSize, size_t aAlign = RT_ARENA_ALIGN);
+
+	/**	Forget all the allocations. The blocks are kept, merged into one if
+		there were several, so the next scene of the same size is contiguous.
+	 */
+	void reset();
+
+	/**	Forget all the allocations and free the blocks
+	 */
+	void release();
+
+	/// bytes handed out since the last reset
+	size_t getUsed() const;
+	/// bytes of the blocks
+	size_t getReserved() const;
+
+private:
+	struct Block
+	{
+		char* mData;
+		size_t mSize;
+		size_t mUsed;
+	};
+
+	void _addBlock(size_t aSize);
+
+private:
+	std::vector<Block> mBlocks;
+	/// the block allocated from, the ones before it are full
+	size_t mCurrent;
+
+	// non-copyable
+	MemoryArena(const MemoryArena&);
+	MemoryArena& operator=(const MemoryArena&);
+};
+
+// ------------------------------------------------------------------------------
+// Fixed capacity array in an arena
+// ------------------------------------------------------------------------------
+
+/**	A vector without growth: the capacity is allocated from an arena once
+	and the elements are constructed in place. It never frees and never
+	runs destructors, the arena owns the memory.
+ */
+template <typename T>
+class ArenaArray
+{
+public:
+	ArenaArray() : mData(0), mSize(0), mCapacity(0) {}
+
+	/**	Allocate room for @aCapacity elements, the array is empty afterwards
+	 */
+	void create(MemoryArena& aArena, int aCapacity)
+	{
+		mData = aCapacity > 0 ? static_cast<T*>(aArena.alloc(aCapacity * sizeof(T))) : 0;
+		mSize = 0;
+		mCapacity = aCapacity;
+	}
+
+	/**	Allocate and copy the elements of @aSrc
+	 */
+	void assign(MemoryArena& aArena, const std::vector<T>& aSrc)
+	{
+		create(aArena, static_cast<int>(aSrc.size()));
+		for (size_t i=0; i<aSrc.size(); ++i)
+			push_back(aSrc[i]);
+	}
+
+	/**	Refer to @aSize elements kept elsewhere, e.g. in a mapped file,
+		instead of allocating. They must outlive the array and are only read.
+	 */
+	void attach(const T* aData, int aSize)
+	{
+		mData = const_cast<T*>(aData);
+		mSize = mCapacity = aSize;
+	}
+
+	/**	Drop the elements, the memory stays in the arena
+	 */
+	void clear()
+	{
+		mData = 0;
+		mSize = mCapacity = 0;
+	}
+
+	void push_back(const T& aVal)
+	{
+		assert(mSize < mCapacity);
+		new (mData + mSize) T(aVal);
+		++mSize;
+	}
+
+	/// grow to @aSize default constructed elements
+	void resize(int aSize)
+	{
+		assert(aSize <= mCapacity);
+		for (; mSize<aSize; ++mSize)
+			new (mData + mSize) T();
+	}
+
+	T& operator[] (int i)				{ return mData[i]; }
+	const T& operator[] (int i) const	{ return mData[i]; }
+	T& back()							{ return mData[mSize - 1]; }
+
+	int size() const					{ return mSize; }
+	int capacity() const				{ return mCapacity; }
+	bool empty() const					{ return mSize == 0; }
+
+private:
+	T* mData;
+	int mSize;
+	int mCapacity;
+};
+
+}; // namespace RayTracer
+
+#endif // _RT_ARENA_H_
@@ -0,0 +1,1340 @@
+/********************************************************************
+	created:	2026/10/17
+	file name:	bvh.cpp
+	author:		maxint lnychina@gmail.com
+*********************************************************************/
+
+#include "bvh.h"
+#include "raytracer.h"
+#include "primitive.h"
+#include "simd.h"
+#include "threadpool.h"
+
+#include <algorithm>
+
+namespace RayTracer {
+
+// cost of visiting a node relative to one primitive test
+static const Real BVH_TRAVERSAL_COST = 1.0f;
+
+// items of a subtree built by one task, smaller inputs are built at once
+static const int BVH_MIN_TASK = 4096;
+static const int BVH_TASKS_PER_THREAD = 8;
+
+// bits of the Morton codes per axis, and of a radix sort digit
+static const int BVH_MORTON_BITS = 10;
+static const int BVH_RADIX_BITS = 10;
+static const int BVH_RADIX = 1 << BVH_RADIX_BITS;
+
+static inline Real halfArea(const Vec3& aMin, const Vec3& aMax)
+{
+	Vec3 d = aMax - aMin;
+	return d.x * d.y + d.y * d.z + d.z * d.x;
+}
+
+/// orders build items by the centre on one axis
+class CentreLess
+{
+public:
+	explicit CentreLess(int aAxis) : mAxis(aAxis) {}
+	template <typename T>
+	bool operator() (const T& a, const T& b) const
+	{
+		return a.mCentre[mAxis] < b.mCentre[mAxis];
+	}
+private:
+	int mAxis;
+};
+
+// ------------------------------------------------------------------------------
+// BVH class implementation
+// ------------------------------------------------------------------------------
+
+BVH::BVH()
+{}
+
+BVH::~BVH()
+{
+	clear();
+}
+
+void BVH::clear()
+{
+	mNodes.clear();
+	mPrims.clear();
+	mBlocks.clear();
+}
+
+void BVH::build(const PrimArray& aPrims, MemoryArena& aArena, ThreadPool* aPool)
+{
+	clear();
+	if (aPrims.empty())
+		return;
+
+	const int count = static_cast<int>(aPrims.size());
+	const int numThreads = aPool ? aPool->getNumThreads() : 1;
+	// NOTE: a few tasks per thread, the subtrees are not equally expensive
+	const int taskSize = std::max(BVH_MIN_TASK, count / (numThreads * BVH_TASKS_PER_THREAD));
+
+	std::vector<BuildItem> items(count);
+	// a binary tree has less than 2n nodes
+	std::vector<Node> nodes;
+	nodes.reserve(2 * items.size());
+	if (numThreads == 1 || count <= 2 * taskSize)
+	{
+		_initItems(&aPrims[0], count, &items[0]);
+		_build(items, nodes, 0, count, 0);
+	}
+	else
+	{
+		const int chunk = (count + numThreads - 1) / numThreads;
+		for (int i=0; i<count; i+=chunk)
+		{
+			aPool->submit(std::bind(&BVH::_initItems, &aPrims[i], 
+				std::min(chunk, count - i), &items[i]));
+		}
+		aPool->wait();
+
+		// the tasks work on disjoint ranges of the items
+		std::vector<Node> top;
+		std::vector<BuildTask> tasks;
+		_buildTop(items, top, 0, count, 0, taskSize, tasks, *aPool);
+		for (size_t i=0; i<tasks.size(); ++i)
+			aPool->submit(std::bind(&BVH::_buildTask, this, &items, &tasks[i]));
+		aPool->wait();
+		_gather(top, tasks, 0, nodes, false);
+	}
+	_store(nodes, items, aArena);
+}
+
+void BVH::_store(std::vector<Node>& aNodes, const std::vector<BuildItem>& aItems, 
+				 MemoryArena& aArena)
+{
+	// leaves index the items in their final order
+	PrimArray prims(aItems.size());
+	for (size_t i=0; i<aItems.size(); ++i)
+		prims[i] = aItems[i].mPrim;
+
+	std::vector<TriangleBlock> blocks;
+	_buildBlocks(aNodes, prims, blocks);
+
+	// NOTE: copied at their final size, the 2n nodes reserved by the 
+	// builders are freed
+	mNodes.assign(aArena, aNodes);
+	mPrims.assign(aArena, prims);
+	mBlocks.assign(aArena, blocks);
+}
+
+void BVH::_initItems(const Primitive* const* aPrims, int aCount, BuildItem* aItems)
+{
+	for (int i=0; i<aCount; ++i)
+	{
+		const AABB &box = aPrims[i]->getAABB();
+		aItems[i].mMin = box.getMin();
+		aItems[i].mMax = box.getMax();
+		aItems[i].mCentre = 0.5f * (box.getMin() + box.getMax());
+		aItems[i].mPrim = aPrims[i];
+	}
+}
+
+void BVH::_buildBlocks(std::vector<Node>& aNodes, PrimArray& aPrims, 
+					   std::vector<TriangleBlock>& aBlocks) const
+{
+	// at most a block per leaf more than the triangles fill
+	size_t numBlocks = aPrims.size() / RT_SIMD_WIDTH;
+	size_t i;
+	for (i=0; i<aNodes.size(); ++i)
+	{
+		if (aNodes[i].mCount > 0)
+			++numBlocks;
+	}
+	aBlocks.reserve(numBlocks);
+
+	PrimArray tris;
+	for (i=0; i<aNodes.size(); ++i)
+	{
+		Node &node = aNodes[i];
+		node.mBlock = static_cast<int>(aBlocks.size());
+		node.mNumBlocks = 0;
+		node.mNumScalar = node.mCount;
+		if (node.mCount == 0)
+			continue;
+
+		// stable, each group keeps its order of the build
+		const Primitive **first = &aPrims[0] + node.mOffset;
+		const Primitive **last = first + node.mCount;
+		tris.clear();
+		const Primitive **it, **out = first;
+		for (it=first; it!=last; ++it)
+		{
+			if ((*it)->getType() == Primitive::PT_TRIANGLE)
+				tris.push_back(*it);
+			else
+				*out++ = *it;
+		}
+		std::copy(tris.begin(), tris.end(), out);
+		node.mNumScalar = static_cast<int>(out - first);
+
+		for (size_t k=0; k<tris.size(); ++k)
+		{
+			if (k % RT_SIMD_WIDTH == 0)
+			{
+				aBlocks.push_back(TriangleBlock());
+				++node.mNumBlocks;
+			}
+			aBlocks.back().set(static_cast<int>(k % RT_SIMD_WIDTH), 
+				static_cast<const TrianglePrim*>(tris[k]));
+		}
+	}
+}
+
+bool BVH::_attach(const Node* aNodes, int aNumNodes, const int* aPrims, int aNumPrims,
+				  const ArenaArray<const Primitive*>& aTable, MemoryArena& aArena)
+{
+	clear();
+	if (!_checkNodes(aNodes, aNumNodes, aPrims, aNumPrims, aTable))
+		return false;
+	mNodes.attach(aNodes, aNumNodes);
+	mPrims.create(aArena, aNumPrims);
+	for (int i=0; i<aNumPrims; ++i)
+		mPrims.push_back(aTable[aPrims[i]]);
+
+	// the leaves keep the places of their blocks, the triangles follow the
+	// other primitives as _buildBlocks() left them
+	int numBlocks = 0;
+	for (int i=0; i<aNumNodes; ++i)
+	{
+		if (aNodes[i].mCount > 0)
+			numBlocks = std::max(numBlocks, aNodes[i].mBlock + aNodes[i].mNumBlocks);
+	}
+	mBlocks.create(aArena, numBlocks);
+	mBlocks.resize(numBlocks);
+	for (int i=0; i<aNumNodes; ++i)
+	{
+		const Node &node = aNodes[i];
+		if (node.mCount <= 0)
+			continue;
+		for (int k=0; k<node.mCount-node.mNumScalar; ++k)
+		{
+			const Primitive *tri = mPrims[node.mOffset + node.mNumScalar + k];
+			mBlocks[node.mBlock + k / RT_SIMD_WIDTH].set(k % RT_SIMD_WIDTH, 
+				static_cast<const TrianglePrim*>(tri));
+		}
+	}
+	return true;
+}
+
+bool BVH::_checkNodes(const Node* aNodes, int aNumNodes, const int* aPrims, int aNumPrims,
+					  const ArenaArray<const Primitive*>& aTable)
+{
+	if (aNumNodes == 0)
+		return true;
+
+	// walk from the root, every node must be reached once
+	std::vector<char> visited(aNumNodes, 0);
+	std::vector<std::pair<int, int> > stack;	// node, depth
+	stack.push_back(std::make_pair(0, 0));
+	int numVisited = 0;
+	while (!stack.empty())
+	{
+		const int idx = stack.back().first;
+		const int depth = stack.back().second;
+		stack.pop_back();
+		if (visited[idx] || depth >= RT_BVH_STACKSIZE)
+			return false;
+		visited[idx] = 1;
+		++numVisited;
+
+		const Node &node = aNodes[idx];
+		if (node.mCount > 0)
+		{
+			const int numTris = node.mCount - node.mNumScalar;
+			if (node.mOffset < 0 || node.mOffset > aNumPrims - node.mCount ||
+				node.mNumScalar < 0 || numTris < 0 || node.mBlock < 0 ||
+				node.mNumBlocks != (numTris + RT_SIMD_WIDTH - 1) / RT_SIMD_WIDTH ||
+				node.mBlock > aNumPrims - node.mNumBlocks)
+				return false;
+			for (int k=node.mNumScalar; k<node.mCount; ++k)
+			{
+				if (aTable[aPrims[node.mOffset + k]]->getType() != Primitive::PT_TRIANGLE)
+					return false;
+			}
+		}
+		else
+		{
+			// children follow their parent, so the walk can not loop
+			if (node.mCount < 0 || node.mAxis < 0 || node.mAxis > 2 ||
+				idx + 1 >= aNumNodes || node.mOffset <= idx + 1 || node.mOffset >= aNumNodes)
+				return false;
+			stack.push_back(std::make_pair(idx + 1, depth + 1));
+			stack.push_back(std::make_pair(node.mOffset, depth + 1));
+		}
+	}
+	return numVisited == aNumNodes;
+}
+
+int BVH::_build(std::vector<BuildItem>& aItems, std::vector<Node>& aNodes, 
+				int aBegin, int aEnd, int aDepth) const
+{
+	int idx = static_cast<int>(aNodes.size());
+	aNodes.push_back(Node());
+
+	int count = aEnd - aBegin;
+	BuildBounds bounds;
+	_computeBounds(&aItems[aBegin], count, &bounds);
+	aNodes[idx].mMin = bounds.mMin;
+	aNodes[idx].mMax = bounds.mMax;
+	aNodes[idx].mOffset = aBegin;
+	aNodes[idx].mCount = count;
+	aNodes[idx].mAxis = 0;
+
+	// NOTE: the depth is bounded so the traversal stack cannot overflow
+	if (count <= RT_BVH_LEAFSIZE || aDepth >= RT_BVH_STACKSIZE - 1)
+		return idx;
+
+	BuildBins bins;
+	_binItems(&aItems[aBegin], count, &bounds, &bins);
+	int axis, mid;
+	if (!_split(aItems, aBegin, aEnd, bounds, bins, axis, mid))
+		return idx;
+
+	_build(aItems, aNodes, aBegin, mid, aDepth + 1);
+	int right = _build(aItems, aNodes, mid, aEnd, aDepth + 1);
+	aNodes[idx].mOffset = right;
+	aNodes[idx].mCount = 0;
+	aNodes[idx].mAxis = axis;
+	return idx;
+}
+
+int BVH::_buildTop(std::vector<BuildItem>& aItems, std::vector<Node>& aNodes, 
+				   int aBegin, int aEnd, int aDepth, int aTaskSize, 
+				   std::vector<BuildTask>& aTasks, ThreadPool& aPool) const
+{
+	int idx = static_cast<int>(aNodes.size());
+	aNodes.push_back(Node());
+
+	int count = aEnd - aBegin;
+	if (count <= aTaskSize)
+	{
+		aNodes[idx].mOffset = static_cast<int>(aTasks.size());
+		aNodes[idx].mCount = -1;
+		aTasks.push_back(BuildTask());
+		aTasks.back().mBegin = aBegin;
+		aTasks.back().mEnd = aEnd;
+		aTasks.back().mDepth = aDepth;
+		return idx;
+	}
+
+	// the bounds and the bins of every chunk are merged in order, min and 
+	// max give the same bins as a single thread would
+	const int numChunks = std::min(aPool.getNumThreads(), count / BVH_MIN_TASK);
+	const int chunk = (count + numChunks - 1) / numChunks;
+	std::vector<BuildBounds> chunkBounds(numChunks);
+	std::vector<BuildBins> chunkBins(numChunks);
+	int c;
+	for (c=0; c<numChunks; ++c)
+	{
+		const int first = aBegin + c * chunk;
+		aPool.submit(std::bind(&BVH::_computeBounds, &aItems[first], 
+			std::min(chunk, aEnd - first), &chunkBounds[c]));
+	}
+	aPool.wait();
+
+	BuildBounds bounds = chunkBounds[0];
+	for (c=1; c<numChunks; ++c)
+		_mergeBounds(bounds, chunkBounds[c]);
+	aNodes[idx].mMin = bounds.mMin;
+	aNodes[idx].mMax = bounds.mMax;
+	aNodes[idx].mOffset = aBegin;
+	aNodes[idx].mCount = count;
+	aNodes[idx].mAxis = 0;
+
+	for (c=0; c<numChunks; ++c)
+	{
+		const int first = aBegin + c * chunk;
+		aPool.submit(std::bind(&BVH::_binItems, &aItems[first], 
+			std::min(chunk, aEnd - first), &bounds, &chunkBins[c]));
+	}
+	aPool.wait();
+	for (c=1; c<numChunks; ++c)
+		_mergeBins(chunkBins[0], chunkBins[c]);
+
+	// NOTE: partitioned by this thread, in parallel the order of the items 
+	// and so the tree would differ from the one of a single thread
+	int axis, mid;
+	if (!_split(aItems, aBegin, aEnd, bounds, chunkBins[0], axis, mid))
+		return idx;
+
+	_buildTop(aItems, aNodes, aBegin, mid, aDepth + 1, aTaskSize, aTasks, aPool);
+	int right = _buildTop(aItems, aNodes, mid, aEnd, aDepth + 1, aTaskSize, aTasks, aPool);
+	aNodes[idx].mOffset = right;
+	aNodes[idx].mCount = 0;
+	aNodes[idx].mAxis = axis;
+	return idx;
+}
+
+void BVH::_buildTask(std::vector<BuildItem>* aItems, BuildTask* aTask) const
+{
+	aTask->mNodes.reserve(2 * (aTask->mEnd - aTask->mBegin));
+	_build(*aItems, aTask->mNodes, aTask->mBegin, aTask->mEnd, aTask->mDepth);
+}
+
+void BVH::_gather(const std::vector<Node>& aTop, std::vector<BuildTask>& aTasks,
+				  int aIdx, std::vector<Node>& aNodes, bool aRefit)
+{
+	const int idx = static_cast<int>(aNodes.size());
+	const Node &node = aTop[aIdx];
+	if (node.mCount < 0)
+	{
+		// the inner nodes of a task refer to their second child by the
+		// index in the task
+		aTasks[node.mOffset].mRoot = idx;
+		const std::vector<Node> &sub = aTasks[node.mOffset].mNodes;
+		for (size_t i=0; i<sub.size(); ++i)
+		{
+			aNodes.push_back(sub[i]);
+			if (sub[i].mCount == 0)
+				aNodes.back().mOffset += idx;
+		}
+		return;
+	}
+
+	aNodes.push_back(node);
+	if (node.mCount == 0)
+	{
+		_gather(aTop, aTasks, aIdx + 1, aNodes, aRefit);
+		const int right = static_cast<int>(aNodes.size());
+		_gather(aTop, aTasks, node.mOffset, aNodes, aRefit);
+
+		Node &parent = aNodes[idx];
+		parent.mOffset = right;
+		if (aRefit)
+		{
+			parent.mMin = Min(aNodes[idx + 1].mMin, aNodes[right].mMin);
+			parent.mMax = Max(aNodes[idx + 1].mMax, aNodes[right].mMax);
+		}
+	}
+}
+
+void BVH::_computeBounds(const BuildItem* aItems, int aCount, BuildBounds* aBounds)
+{
+	// bins are laid over the bounds of the centres, not of the primitives
+	BuildBounds &bounds = *aBounds;
+	bounds.mMin = aItems[0].mMin;
+	bounds.mMax = aItems[0].mMax;
+	bounds.mCentreMin = bounds.mCentreMax = aItems[0].mCentre;
+	for (int i=1; i<aCount; ++i)
+	{
+		bounds.mMin.Min(aItems[i].mMin);
+		bounds.mMax.Max(aItems[i].mMax);
+		bounds.mCentreMin.Min(aItems[i].mCentre);
+		bounds.mCentreMax.Max(aItems[i].mCentre);
+	}
+}
+
+void BVH::_mergeBounds(BuildBounds& aBounds, const BuildBounds& aOther)
+{
+	aBounds.mMin.Min(aOther.mMin);
+	aBounds.mMax.Max(aOther.mMax);
+	aBounds.mCentreMin.Min(aOther.mCentreMin);
+	aBounds.mCentreMax.Max(aOther.mCentreMax);
+}
+
+void BVH::_binItems(const BuildItem* aItems, int aCount, const BuildBounds* aBounds, 
+					BuildBins* aBins)
+{
+	const Vec3 &cMin = aBounds->mCentreMin;
+	const Vec3 &cMax = aBounds->mCentreMax;
+	for (int axis=0; axis<3; ++axis)
+	{
+		BuildBins::Bin *bins = aBins->mBins[axis];
+		int b;
+		for (b=0; b<RT_BVH_BINS; ++b)
+			bins[b].mCount = 0;
+
+		Real extent = cMax[axis] - cMin[axis];
+		if (extent <= 0)
+			continue;
+
+		Real scale = RT_BVH_BINS / extent;
+		for (int i=0; i<aCount; ++i)
+		{
+			const BuildItem &item = aItems[i];
+			b = std::min(RT_BVH_BINS - 1,
+				static_cast<int>((item.mCentre[axis] - cMin[axis]) * scale));
+			BuildBins::Bin &bin = bins[b];
+			if (bin.mCount++ == 0)
+			{
+				bin.mMin = item.mMin;
+				bin.mMax = item.mMax;
+			}
+			else
+			{
+				bin.mMin.Min(item.mMin);
+				bin.mMax.Max(item.mMax);
+			}
+		}
+	}
+}
+
+void BVH::_mergeBins(BuildBins& aBins, const BuildBins& aOther)
+{
+	for (int axis=0; axis<3; ++axis) for (int b=0; b<RT_BVH_BINS; ++b)
+	{
+		BuildBins::Bin &bin = aBins.mBins[axis][b];
+		const BuildBins::Bin &other = aOther.mBins[axis][b];
+		if (other.mCount == 0)
+			continue;
+		if (bin.mCount == 0)
+		{
+			bin = other;
+			continue;
+		}
+		bin.mMin.Min(other.mMin);
+		bin.mMax.Max(other.mMax);
+		bin.mCount += other.mCount;
+	}
+}
+
+bool BVH::_split(std::vector<BuildItem>& aItems, int aBegin, int aEnd, 
+				 const BuildBounds& aBounds, const BuildBins& aBins, int& aAxis, int& aMid) const
+{
+	int count = aEnd - aBegin;
+	Real pos;
+	aMid = aBegin;
+	if (_findSplit(aBins, aBounds, count, aAxis, pos))
+	{
+		BuildItem *first = &aItems[0] + aBegin;
+		BuildItem *last = &aItems[0] + aEnd;
+		BuildItem *split = first;
+		for (BuildItem *it=first; it!=last; ++it)
+		{
+			if (it->mCentre[aAxis] < pos)
+				std::swap(*it, *split++);
+		}
+		aMid = aBegin + static_cast<int>(split - first);
+	}
+	else if (count <= RT_BVH_LEAFSIZE * 4)
+	{
+		return false;
+	}
+
+	// too many primitives for a leaf and no useful split, halve them
+	if (aMid == aBegin || aMid == aEnd)
+	{
+		Vec3 dim = aBounds.mMax - aBounds.mMin;
+		aAxis = (dim.x > dim.y && dim.x > dim.z) ? 0 : ((dim.y > dim.z) ? 1 : 2);
+		aMid = (aBegin + aEnd) / 2;
+		std::nth_element(aItems.begin() + aBegin, aItems.begin() + aMid,
+			aItems.begin() + aEnd, CentreLess(aAxis));
+	}
+	return true;
+}
+
+bool BVH::_findSplit(const BuildBins& aBins, const BuildBounds& aBounds, int aCount,
+					 int& aAxis, Real& aPos) const
+{
+	Real bestCost = static_cast<Real>(aCount);	// cost of a leaf
+	Real rArea = 1.0f / halfArea(aBounds.mMin, aBounds.mMax);
+	bool found = false;
+
+	for (int axis=0; axis<3; ++axis)
+	{
+		Real extent = aBounds.mCentreMax[axis] - aBounds.mCentreMin[axis];
+		if (extent <= 0)
+			continue;
+
+		const BuildBins::Bin *bins = aBins.mBins[axis];
+		Real scale = RT_BVH_BINS / extent;
+		int b;
+
+		// sweep from the right to get the cost of every right side
+		Real rightArea[RT_BVH_BINS];
+		int rightCount[RT_BVH_BINS];
+		Vec3 tMin, tMax;
+		int n = 0;
+		for (b=RT_BVH_BINS-1; b>0; --b)
+		{
+			if (bins[b].mCount > 0)
+			{
+				if (n == 0)
+				{
+					tMin = bins[b].mMin;
+					tMax = bins[b].mMax;
+				}
+				else
+				{
+					tMin.Min(bins[b].mMin);
+					tMax.Max(bins[b].mMax);
+				}
+				n += bins[b].mCount;
+			}
+			rightCount[b] = n;
+			rightArea[b] = (n > 0) ? halfArea(tMin, tMax) : 0;
+		}
+
+		// then from the left, splitting between bin b-1 and b
+		n = 0;
+		for (b=1; b<RT_BVH_BINS; ++b)
+		{
+			const BuildBins::Bin &bin = bins[b-1];
+			if (bin.mCount > 0)
+			{
+				if (n == 0)
+				{
+					tMin = bin.mMin;
+					tMax = bin.mMax;
+				}
+				else
+				{
+					tMin.Min(bin.mMin);
+					tMax.Max(bin.mMax);
+				}
+				n += bin.mCount;
+			}
+			if (n == 0 || rightCount[b] == 0)
+				continue;
+
+			Real cost = BVH_TRAVERSAL_COST +
+				(n * halfArea(tMin, tMax) + rightCount[b] * rightArea[b]) * rArea;
+			if (cost < bestCost)
+			{
+				bestCost = cost;
+				aAxis = axis;
+				aPos = aBounds.mCentreMin[axis] + b / scale;
+				found = true;
+			}
+		}
+	}
+	return found;
+}
+
+RTResult BVH::intersect(const Ray& aRay, HitRecord& aHit, RenderStats& aStats) const
+{
+	if (mNodes.empty())
+		return MISS;
+	RT_STAT(aStats, STAT_TRAVERSALS, 1);
+
+	const Vec3 &orig = aRay.getOrigin();
+	const Vec3 &dir = aRay.getDir();
+	// NOTE: a zero component gives an infinite slab, which is what we want
+	Vec3 invDir(1.0f / dir.x, 1.0f / dir.y, 1.0f / dir.z);
+	int dirNeg[3] = { invDir.x < 0, invDir.y < 0, invDir.z < 0 };
+
+	int stack[RT_BVH_STACKSIZE];
+	int top = 0;
+	int idx = 0;
+	bool found = false;
+	while (1)
+	{
+		const Node &node = mNodes[idx];
+		RT_STAT(aStats, STAT_BVH_NODES, 1);
+
+		// slab test against the current search distance
+		Real tNear = 0, tFar = aHit.mDist;
+		for (int i=0; i<3; ++i)
+		{
+			Real t0 = ((dirNeg[i] ? node.mMax[i] : node.mMin[i]) - orig[i]) * invDir[i];
+			Real t1 = ((dirNeg[i] ? node.mMin[i] : node.mMax[i]) - orig[i]) * invDir[i];
+			if (t0 > tNear) tNear = t0;
+			if (t1 < tFar) tFar = t1;
+		}
+
+		if (tNear <= tFar)
+		{
+			if (node.mCount > 0)
+			{
+				RT_STAT(aStats, STAT_PRIM_TESTS, node.mCount);
+				int i;
+				for (i=0; i<node.mNumScalar; ++i)
+				{
+					if (mPrims[node.mOffset + i]->intersect(aRay, aHit) != MISS)
+						found = true;
+				}
+				for (i=0; i<node.mNumBlocks; ++i)
+				{
+					if (mBlocks[node.mBlock + i].intersect(aRay, aHit) != MISS)
+						found = true;
+				}
+			}
+			else
+			{
+				// visit the child nearer to the ray origin first
+				if (dirNeg[node.mAxis])
+				{
+					stack[top++] = idx + 1;
+					idx = node.mOffset;
+				}
+				else
+				{
+					stack[top++] = node.mOffset;
+					idx = idx + 1;
+				}
+				continue;
+			}
+		}
+
+		if (top == 0)
+			break;
+		idx = stack[--top];
+	}
+	return found ? aHit.mResult : MISS;
+}
+
+Occlusion BVH::findOcclusion(const Ray& aRay, Real aMaxDist, const Primitive*& aOccluder, 
+							 RenderStats& aStats) const
+{
+	if (mNodes.empty())
+		return OC_NONE;
+	RT_STAT(aStats, STAT_TRAVERSALS, 1);
+
+	const Vec3 &orig = aRay.getOrigin();
+	const Vec3 &dir = aRay.getDir();
+	Vec3 invDir(1.0f / dir.x, 1.0f / dir.y, 1.0f / dir.z);
+	int dirNeg[3] = { invDir.x < 0, invDir.y < 0, invDir.z < 0 };
+
+	int stack[RT_BVH_STACKSIZE];
+	int top = 0;
+	int idx = 0;
+	Occlusion result = OC_NONE;
+	while (1)
+	{
+		const Node &node = mNodes[idx];
+		RT_STAT(aStats, STAT_BVH_NODES, 1);
+
+		Real tNear = 0, tFar = aMaxDist;
+		for (int i=0; i<3; ++i)
+		{
+			Real t0 = ((dirNeg[i] ? node.mMax[i] : node.mMin[i]) - orig[i]) * invDir[i];
+			Real t1 = ((dirNeg[i] ? node.mMin[i] : node.mMax[i]) - orig[i]) * invDir[i];
+			if (t0 > tNear) tNear = t0;
+			if (t1 < tFar) tFar = t1;
+		}
+
+		if (tNear <= tFar)
+		{
+			if (node.mCount > 0)
+			{
+				RT_STAT(aStats, STAT_PRIM_TESTS, node.mCount);
+				int i;
+				for (i=0; i<node.mNumScalar && result!=OC_OPAQUE; ++i)
+				{
+					const Primitive *prim = mPrims[node.mOffset + i];
+					HitRecord hit(aMaxDist);
+					if (prim->intersect(aRay, hit) != MISS)
+					{
+						result = std::max(result, prim->getOcclusion());
+						if (result == OC_OPAQUE)
+							aOccluder = prim;
+					}
+				}
+				for (i=0; i<node.mNumBlocks && result!=OC_OPAQUE; ++i)
+				{
+					result = std::max(result, 
+						mBlocks[node.mBlock + i].findOcclusion(aRay, aMaxDist, aOccluder));
+				}
+				if (result == OC_OPAQUE)
+					break;
+			}
+			else
+			{
+				// any order would do, the nearer child is more likely to block
+				if (dirNeg[node.mAxis])
+				{
+					stack[top++] = idx + 1;
+					idx = node.mOffset;
+				}
+				else
+				{
+					stack[top++] = node.mOffset;
+					idx = idx + 1;
+				}
+				continue;
+			}
+		}
+
+		if (top == 0)
+			break;
+		idx = stack[--top];
+	}
+	return result;
+}
+
+int BVH::intersectPacket(const RayPacket& aPacket, PacketHit& aHit, RenderStats& aStats) const
+{
+	if (mNodes.empty())
+		return 0;
+	RT_STAT(aStats, STAT_TRAVERSALS, 1);
+
+	int stack[RT_BVH_STACKSIZE];
+	int stackMask[RT_BVH_STACKSIZE];
+	int top = 0;
+	int idx = 0;
+	int mask = aPacket.getActive();
+	int hitMask = 0;
+	while (1)
+	{
+		const Node &node = mNodes[idx];
+		RT_STAT(aStats, STAT_BVH_NODES, 1);
+		// NOTE: a ray missing the parent box misses the children as well
+		int active = _intersectBox(node, aPacket, aHit, mask);
+		if (active)
+		{
+			if (node.mCount > 0)
+			{
+				RT_STAT(aStats, STAT_PRIM_TESTS, node.mCount);
+				for (int i=0; i<node.mCount; ++i)
+					hitMask |= mPrims[node.mOffset + i]->intersectPacket(aPacket, aHit, active);
+			}
+			else
+			{
+				// the rays share the direction signs, so they agree on the order
+				stackMask[top] = active;
+				if (aPacket.isDirNeg(node.mAxis))
+				{
+					stack[top++] = idx + 1;
+					idx = node.mOffset;
+				}
+				else
+				{
+					stack[top++] = node.mOffset;
+					idx = idx + 1;
+				}
+				mask = active;
+				continue;
+			}
+		}
+
+		if (top == 0)
+			break;
+		--top;
+		idx = stack[top];
+		mask = stackMask[top];
+	}
+	return hitMask;
+}
+
+int BVH::_intersectBox(const Node& aNode, const RayPacket& aPacket, 
+					   const PacketHit& aHit, int aMask) const
+{
+	const SimdReal bMin[3] = { SimdReal(aNode.mMin.x), SimdReal(aNode.mMin.y), SimdReal(aNode.mMin.z) };
+	const SimdReal bMax[3] = { SimdReal(aNode.mMax.x), SimdReal(aNode.mMax.y), SimdReal(aNode.mMax.z) };
+	const int laneBits = (1 << RT_SIMD_WIDTH) - 1;
+
+	int result = 0;
+	for (int i=0; i<RayPacket::SIZE; i+=RT_SIMD_WIDTH)
+	{
+		int lanes = (aMask >> i) & laneBits;
+		if (!lanes)
+			continue;
+
+		SimdReal tNear(Real(0));
+		SimdReal tFar = SimdReal::load(&aHit.mDist[i]);
+		for (int k=0; k<3; ++k)
+		{
+			SimdReal orig = SimdReal::load(&aPacket.mOrigin[k][i]);
+			SimdReal invDir = SimdReal::load(&aPacket.mInvDir[k][i]);
+			SimdReal t0 = (bMin[k] - orig) * invDir;
+			SimdReal t1 = (bMax[k] - orig) * invDir;
+			// NOTE: a NaN from 0 * inf keeps the previous bound
+			tNear = simdMax(simdMin(t0, t1), tNear);
+			tFar = simdMin(simdMax(t0, t1), tFar);
+		}
+		result |= (movemask(tNear <= tFar) & lanes) << i;
+	}
+	return result;
+}
+
+// ------------------------------------------------------------------------------
+// Linear BVH
+// ------------------------------------------------------------------------------
+
+/// spread the lower 10 bits of @v to every third bit
+static inline unsigned int _expandBits(unsigned int v)
+{
+	v = (v * 0x00010001u) & 0xFF0000FFu;
+	v = (v * 0x00000101u) & 0x0F00F00Fu;
+	v = (v * 0x00000011u) & 0xC30C30C3u;
+	v = (v * 0x00000005u) & 0x49249249u;
+	return v;
+}
+
+static inline int _lowestBit(int v)
+{
+	int i = 0;
+	while (!(v & (1 << i)))
+		++i;
+	return i;
+}
+
+/// chunks of the parallel steps of the linear build, one without a pool
+static int _numChunks(const ThreadPool* aPool, int aCount)
+{
+	return aPool ? std::max(1, std::min(aPool->getNumThreads(), aCount / BVH_MIN_TASK)) : 1;
+}
+
+/// run a task on @aPool, or at once without it
+static void _run(ThreadPool* aPool, const ThreadPool::Task& aTask)
+{
+	if (aPool)
+		aPool->submit(aTask);
+	else
+		aTask(0);
+}
+
+void BVH::buildLinear(const PrimArray& aPrims, MemoryArena& aArena, ThreadPool* aPool, bool aTreelets)
+{
+	clear();
+	if (aPrims.empty())
+		return;
+
+	const int count = static_cast<int>(aPrims.size());
+	const int numThreads = aPool ? aPool->getNumThreads() : 1;
+	const int taskSize = std::max(BVH_MIN_TASK, count / (numThreads * BVH_TASKS_PER_THREAD));
+	ThreadPool *pool = (numThreads > 1 && count > 2 * taskSize) ? aPool : NULL;
+	const int numChunks = _numChunks(pool, count);
+	const int chunk = (count + numChunks - 1) / numChunks;
+	int c;
+
+	std::vector<BuildItem> items(count);
+	for (c=0; c<numChunks; ++c)
+	{
+		const int first = c * chunk;
+		_run(pool, std::bind(&BVH::_initItems, &aPrims[first], 
+			std::min(chunk, count - first), &items[first]));
+	}
+	if (pool)
+		pool->wait();
+
+	std::vector<BuildBounds> chunkBounds(numChunks);
+	for (c=0; c<numChunks; ++c)
+	{
+		const int first = c * chunk;
+		_run(pool, std::bind(&BVH::_computeBounds, &items[first], 
+			std::min(chunk, count - first), &chunkBounds[c]));
+	}
+	if (pool)
+		pool->wait();
+	BuildBounds bounds = chunkBounds[0];
+	for (c=1; c<numChunks; ++c)
+		_mergeBounds(bounds, chunkBounds[c]);
+
+	std::vector<MortonItem> codes(count);
+	for (c=0; c<numChunks; ++c)
+	{
+		const int first = c * chunk;
+		_run(pool, std::bind(&BVH::_mortonCodes, &items[first], 
+			std::min(chunk, count - first), first, &bounds, &codes[first]));
+	}
+	if (pool)
+		pool->wait();
+	_radixSort(codes, pool);
+
+	std::vector<BuildItem> sorted(count);
+	for (c=0; c<numChunks; ++c)
+	{
+		const int first = c * chunk;
+		_run(pool, std::bind(&BVH::_sortItems, &codes[first], 
+			std::min(chunk, count - first), &items[0], &sorted[first]));
+	}
+	if (pool)
+		pool->wait();
+	std::vector<BuildItem>().swap(items);
+
+	std::vector<Node> nodes;
+	nodes.reserve(2 * sorted.size());
+	std::vector<BuildTask> tasks;
+	if (pool)
+	{
+		// the top is only a few binary searches, the tasks build the rest
+		std::vector<Node> top;
+		_buildLinear(codes, top, 0, count, 0, taskSize, &tasks);
+		for (size_t i=0; i<tasks.size(); ++i)
+			pool->submit(std::bind(&BVH::_buildLinearTask, &codes, &sorted, &tasks[i]));
+		pool->wait();
+		_gather(top, tasks, 0, nodes, true);
+	}
+	else
+	{
+		_buildLinear(codes, nodes, 0, count, 0, 0, NULL);
+		_refit(nodes, 0, static_cast<int>(nodes.size()), &sorted[0]);
+	}
+
+	if (aTreelets)
+	{
+		TreeletTree tree;
+		tree.mNodes = nodes;
+		tree.mLeft.resize(nodes.size());
+		tree.mRight.resize(nodes.size());
+		tree.mCost.resize(nodes.size());
+
+		// the subtrees of the tasks first, then the top above them
+		for (size_t i=0; i<tasks.size(); ++i)
+		{
+			const int root = tasks[i].mRoot;
+			_run(pool, std::bind(&BVH::_optimizeTreelets, &tree, root, 
+				root + static_cast<int>(tasks[i].mNodes.size()), 
+				static_cast<const std::vector<BuildTask>*>(NULL)));
+		}
+		if (pool)
+			pool->wait();
+		_optimizeTreelets(&tree, 0, static_cast<int>(nodes.size()), &tasks);
+
+		// NOTE: restructuring may deepen the tree, it is only used while
+		// the traversal stack holds it
+		std::vector<Node> optimized;
+		optimized.reserve(nodes.size());
+		if (_flatten(tree, 0, 0, optimized) < RT_BVH_STACKSIZE)
+			nodes.swap(optimized);
+	}
+	_store(nodes, sorted, aArena);
+}
+
+void BVH::_mortonCodes(const BuildItem* aItems, int aCount, int aFirst, 
+					   const BuildBounds* aBounds, MortonItem* aCodes)
+{
+	const unsigned int maxCell = (1 << BVH_MORTON_BITS) - 1;
+	const Vec3 &cMin = aBounds->mCentreMin;
+	Vec3 scale;
+	for (int k=0; k<3; ++k)
+	{
+		Real extent = aBounds->mCentreMax[k] - cMin[k];
+		scale[k] = (extent > 0) ? (1 << BVH_MORTON_BITS) / extent : 0;
+	}
+
+	for (int i=0; i<aCount; ++i)
+	{
+		unsigned int cell[3];
+		for (int k=0; k<3; ++k)
+		{
+			cell[k] = std::min(maxCell, 
+				static_cast<unsigned int>((aItems[i].mCentre[k] - cMin[k]) * scale[k]));
+		}
+		// x takes the highest bit of every three
+		aCodes[i].mCode = (_expandBits(cell[0]) << 2) | (_expandBits(cell[1]) << 1) | 
+			_expandBits(cell[2]);
+		aCodes[i].mItem = aFirst + i;
+	}
+}
+
+void BVH::_radixSort(std::vector<MortonItem>& aCodes, ThreadPool* aPool)
+{
+	const int count = static_cast<int>(aCodes.size());
+	const int numChunks = _numChunks(aPool, count);
+	const int chunk = (count + numChunks - 1) / numChunks;
+	std::vector<MortonItem> temp(count);
+	std::vector<int> hist(numChunks * BVH_RADIX);
+	int c;
+
+	for (int shift=0; shift<3*BVH_MORTON_BITS; shift+=BVH_RADIX_BITS)
+	{
+		for (c=0; c<numChunks; ++c)
+		{
+			const int first = c * chunk;
+			_run(aPool, std::bind(&BVH::_radixCount, &aCodes[first], 
+				std::min(chunk, count - first), shift, &hist[c * BVH_RADIX]));
+		}
+		if (aPool)
+			aPool->wait();
+
+		// the chunks write a digit one after another, the sort is stable
+		int offset = 0;
+		for (int d=0; d<BVH_RADIX; ++d) for (c=0; c<numChunks; ++c)
+		{
+			const int n = hist[c * BVH_RADIX + d];
+			hist[c * BVH_RADIX + d] = offset;
+			offset += n;
+		}
+
+		for (c=0; c<numChunks; ++c)
+		{
+			const int first = c * chunk;
+			_run(aPool, std::bind(&BVH::_radixScatter, &aCodes[first], 
+				std::min(chunk, count - first), shift, &hist[c * BVH_RADIX], &temp[0]));
+		}
+		if (aPool)
+			aPool->wait();
+		aCodes.swap(temp);
+	}
+}
+
+void BVH::_radixCount(const MortonItem* aCodes, int aCount, int aShift, int* aHist)
+{
+	std::fill(aHist, aHist + BVH_RADIX, 0);
+	for (int i=0; i<aCount; ++i)
+		++aHist[(aCodes[i].mCode >> aShift) & (BVH_RADIX - 1)];
+}
+
+void BVH::_radixScatter(const MortonItem* aCodes, int aCount, int aShift, 
+						int* aOffsets, MortonItem* aOut)
+{
+	for (int i=0; i<aCount; ++i)
+		aOut[aOffsets[(aCodes[i].mCode >> aShift) & (BVH_RADIX - 1)]++] = aCodes[i];
+}
+
+void BVH::_sortItems(const MortonItem* aCodes, int aCount, 
+					 const BuildItem* aItems, BuildItem* aOut)
+{
+	for (int i=0; i<aCount; ++i)
+		aOut[i] = aItems[aCodes[i].mItem];
+}
+
+int BVH::_buildLinear(const std::vector<MortonItem>& aCodes, std::vector<Node>& aNodes, 
+					  int aBegin, int aEnd, int aDepth, int aTaskSize, std::vector<BuildTask>* aTasks)
+{
+	int idx = static_cast<int>(aNodes.size());
+	aNodes.push_back(Node());
+
+	int count = aEnd - aBegin;
+	if (aTasks && count <= aTaskSize)
+	{
+		aNodes[idx].mOffset = static_cast<int>(aTasks->size());
+		aNodes[idx].mCount = -1;
+		aTasks->push_back(BuildTask());
+		aTasks->back().mBegin = aBegin;
+		aTasks->back().mEnd = aEnd;
+		aTasks->back().mDepth = aDepth;
+		return idx;
+	}
+
+	// the bounds are left to _refit()
+	aNodes[idx].mOffset = aBegin;
+	aNodes[idx].mCount = count;
+	aNodes[idx].mAxis = 0;
+	if (count <= RT_BVH_LEAFSIZE || aDepth >= RT_BVH_STACKSIZE - 1)
+		return idx;
+
+	int axis = 0, mid;
+	const unsigned int first = aCodes[aBegin].mCode;
+	const unsigned int last = aCodes[aEnd - 1].mCode;
+	if (first == last)
+	{
+		// all in one cell, halved
+		mid = (aBegin + aEnd) / 2;
+	}
+	else
+	{
+		// the codes share the bits above the highest different one, the
+		// first code with it set starts the second child
+		int bit = 31;
+		while (!(((first ^ last) >> bit) & 1))
+			--bit;
+		axis = 2 - bit % 3;
+
+		int lo = aBegin + 1, hi = aEnd - 1;
+		while (lo < hi)
+		{
+			int m = (lo + hi) / 2;
+			if ((aCodes[m].mCode >> bit) & 1)
+				hi = m;
+			else
+				lo = m + 1;
+		}
+		mid = lo;
+	}
+
+	_buildLinear(aCodes, aNodes, aBegin, mid, aDepth + 1, aTaskSize, aTasks);
+	int right = _buildLinear(aCodes, aNodes, mid, aEnd, aDepth + 1, aTaskSize, aTasks);
+	aNodes[idx].mOffset = right;
+	aNodes[idx].mCount = 0;
+	aNodes[idx].mAxis = axis;
+	return idx;
+}
+
+void BVH::_buildLinearTask(const std::vector<MortonItem>* aCodes, 
+						   const std::vector<BuildItem>* aItems, BuildTask* aTask)
+{
+	aTask->mNodes.reserve(2 * (aTask->mEnd - aTask->mBegin));
+	_buildLinear(*aCodes, aTask->mNodes, aTask->mBegin, aTask->mEnd, aTask->mDepth, 0, NULL);
+	_refit(aTask->mNodes, 0, static_cast<int>(aTask->mNodes.size()), &(*aItems)[0]);
+}
+
+void BVH::_refit(std::vector<Node>& aNodes, int aFirst, int aLast, const BuildItem* aItems)
+{
+	for (int i=aLast-1; i>=aFirst; --i)
+	{
+		Node &node = aNodes[i];
+		if (node.mCount > 0)
+		{
+			const BuildItem *item = aItems + node.mOffset;
+			node.mMin = item->mMin;
+			node.mMax = item->mMax;
+			for (int k=1; k<node.mCount; ++k)
+			{
+				node.mMin.Min(item[k].mMin);
+				node.mMax.Max(item[k].mMax);
+			}
+		}
+		else
+		{
+			// the children come after their parent
+			node.mMin = Min(aNodes[i + 1].mMin, aNodes[node.mOffset].mMin);
+			node.mMax = Max(aNodes[i + 1].mMax, aNodes[node.mOffset].mMax);
+		}
+	}
+}
+
+void BVH::_optimizeTreelets(TreeletTree* aTree, int aFirst, int aLast, 
+							const std::vector<BuildTask>* aSkip)
+{
+	TreeletTree &tree = *aTree;
+	// the ranges of the tasks follow the depth-first order of their roots
+	int k = aSkip ? static_cast<int>(aSkip->size()) - 1 : -1;
+	for (int i=aLast-1; i>=aFirst; --i)
+	{
+		while (k >= 0 && (*aSkip)[k].mRoot > i)
+			--k;
+		if (k >= 0 && i < (*aSkip)[k].mRoot + static_cast<int>((*aSkip)[k].mNodes.size()))
+		{
+			i = (*aSkip)[k].mRoot;
+			continue;
+		}
+
+		// the treelets below have kept their roots, so the children have
+		const Node &node = tree.mNodes[i];
+		const Real area = halfArea(node.mMin, node.mMax);
+		if (node.mCount > 0)
+		{
+			tree.mLeft[i] = tree.mRight[i] = -1;
+			tree.mCost[i] = area * node.mCount;
+			continue;
+		}
+		tree.mLeft[i] = i + 1;
+		tree.mRight[i] = node.mOffset;
+		tree.mCost[i] = BVH_TRAVERSAL_COST * area + tree.mCost[i + 1] + tree.mCost[node.mOffset];
+		_optimizeTreelet(tree, i);
+	}
+}
+
+void BVH::_optimizeTreelet(TreeletTree& aTree, int aRoot)
+{
+	int leaves[RT_BVH_TREELET];
+	int inner[RT_BVH_TREELET - 1];
+	int numLeaves = 2, numInner = 1;
+	leaves[0] = aTree.mLeft[aRoot];
+	leaves[1] = aTree.mRight[aRoot];
+	inner[0] = aRoot;
+
+	// open the largest inner node until the treelet is full
+	while (numLeaves < RT_BVH_TREELET)
+	{
+		int best = -1;
+		Real bestArea = 0;
+		for (int k=0; k<numLeaves; ++k)
+		{
+			const Node &node = aTree.mNodes[leaves[k]];
+			Real area = halfArea(node.mMin, node.mMax);
+			if (aTree.mLeft[leaves[k]] >= 0 && (best < 0 || area > bestArea))
+			{
+				best = k;
+				bestArea = area;
+			}
+		}
+		if (best < 0)
+			break;
+		const int opened = leaves[best];
+		inner[numInner++] = opened;
+		leaves[best] = aTree.mLeft[opened];
+		leaves[numLeaves++] = aTree.mRight[opened];
+	}
+	if (numLeaves < 3)
+		return;
+
+	// the lowest cost of every subset of the leaves, a subset is split
+	// into two with its lowest leaf in the first one
+	const int numSets = 1 << numLeaves;
+	Vec3 setMin[1 << RT_BVH_TREELET], setMax[1 << RT_BVH_TREELET];
+	Real cost[1 << RT_BVH_TREELET];
+	int part[1 << RT_BVH_TREELET];
+	for (int s=1; s<numSets; ++s)
+	{
+		const int low = s & -s;
+		if (s == low)
+		{
+			const int leaf = leaves[_lowestBit(s)];
+			setMin[s] = aTree.mNodes[leaf].mMin;
+			setMax[s] = aTree.mNodes[leaf].mMax;
+			cost[s] = aTree.mCost[leaf];
+			continue;
+		}
+		setMin[s] = Min(setMin[low], setMin[s ^ low]);
+		setMax[s] = Max(setMax[low], setMax[s ^ low]);
+
+		Real best = -1;
+		for (int p=(s-1)&s; p; p=(p-1)&s)
+		{
+			if (!(p & low))
+				continue;
+			Real c = cost[p] + cost[s ^ p];
+			if (best < 0 || c < best)
+			{
+				best = c;
+				part[s] = p;
+			}
+		}
+		cost[s] = BVH_TRAVERSAL_COST * halfArea(setMin[s], setMax[s]) + best;
+	}
+
+	// NOTE: a margin against rounding, equal treelets are not rebuilt
+	const int all = numSets - 1;
+	if (cost[all] >= aTree.mCost[aRoot] * 0.999f)
+		return;
+
+	// rebuild from the root, which keeps its index
+	int stackSet[RT_BVH_TREELET], stackNode[RT_BVH_TREELET];
+	int top = 0, next = 1;
+	stackSet[top] = all;
+	stackNode[top++] = aRoot;
+	while (top > 0)
+	{
+		--top;
+		const int s = stackSet[top];
+		const int n = stackNode[top];
+		int sets[2] = { part[s], s ^ part[s] };
+
+		// the first child is the lower one on the axis they are apart most
+		Vec3 d = (setMin[sets[1]] + setMax[sets[1]]) - (setMin[sets[0]] + setMax[sets[0]]);
+		Vec3 dist(fabs(d.x), fabs(d.y), fabs(d.z));
+		int axis = (dist.x > dist.y && dist.x > dist.z) ? 0 : ((dist.y > dist.z) ? 1 : 2);
+		if (d[axis] < 0)
+			std::swap(sets[0], sets[1]);
+
+		int children[2];
+		for (int k=0; k<2; ++k)
+		{
+			const int set = sets[k];
+			if ((set & (set - 1)) == 0)
+			{
+				children[k] = leaves[_lowestBit(set)];
+			}
+			else
+			{
+				children[k] = inner[next++];
+				stackSet[top] = set;
+				stackNode[top++] = children[k];
+			}
+		}
+
+		Node &node = aTree.mNodes[n];
+		node.mMin = setMin[s];
+		node.mMax = setMax[s];
+		node.mAxis = axis;
+		aTree.mLeft[n] = children[0];
+		aTree.mRight[n] = children[1];
+		aTree.mCost[n] = cost[s];
+	}
+}
+
+int BVH::_flatten(const TreeletTree& aTree, int aIdx, int aDepth, std::vector<Node>& aNodes)
+{
+	const int idx = static_cast<int>(aNodes.size());
+	aNodes.push_back(aTree.mNodes[aIdx]);
+	if (aTree.mLeft[aIdx] < 0)
+		return aDepth;
+
+	int depth = _flatten(aTree, aTree.mLeft[aIdx], aDepth + 1, aNodes);
+	aNodes[idx].mOffset = static_cast<int>(aNodes.size());
+	return std::max(depth, _flatten(aTree, aTree.mRight[aIdx], aDepth + 1, aNodes));
+}
+
+}; // namespace RayTracer
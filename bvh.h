@@ -0,0 +1,319 @@
+/********************************************************************
+	created:	2026/10/17
+	file name:	bvh.h
+	author:		maxint lnychina@gmail.com
+*********************************************************************/
+
+#ifndef _RT_BVH_H_
+#define _RT_BVH_H_
+
+#include "common.h"
+#include "arena.h"
+#include <vector>
+
+#define RT_BVH_BINS			16
+#define RT_BVH_LEAFSIZE		4
+#define RT_BVH_STACKSIZE	64
+#define RT_BVH_TREELET		5		// leaves of a treelet restructured by buildLinear()
+
+namespace RayTracer {
+
+class Ray;
+class RayPacket;
+class Primitive;
+class HitRecord;
+class PacketHit;
+class TriangleBlock;
+class RenderStats;
+class ThreadPool;
+
+// ------------------------------------------------------------------------------
+// Bounding volume hierarchy, built with the binned surface area heuristic
+// ------------------------------------------------------------------------------
+
+class BVH
+{
+public:
+	typedef std::vector<const Primitive*> PrimArray;
+
+	BVH();
+	~BVH();
+
+	/**	Build the hierarchy over the primitives, the old one is forgotten.
+		The nodes are packed into @aArena once built, next to the leaf 
+		primitives and the triangle blocks.
+		The top of the hierarchy is split with the bins filled in parallel,
+		the subtrees below it are built as parallel tasks. The tree is the
+		same as the one built by a single thread.
+	\param
+		aPool	idle pool running the tasks, NULL builds on the calling
+				thread as do small inputs
+	 */
+	void build(const PrimArray& aPrims, MemoryArena& aArena, ThreadPool* aPool = NULL);
+
+	/**	Build a linear BVH, much faster than build() but slower to trace. 
+		The primitives are sorted by the Morton codes of their centres with 
+		a parallel radix sort and every node is split at the highest bit 
+		its codes differ in.
+	\param
+		aPool		idle pool running the tasks, NULL builds on the calling
+					thread as do small inputs
+		aTreelets	restructure the treelets of every node by the SAH
+					afterwards, which gains back much of the tracing speed
+	 */
+	void buildLinear(const PrimArray& aPrims, MemoryArena& aArena, ThreadPool* aPool = NULL,
+		bool aTreelets = false);
+
+	/**	Forget the nodes, their arena is reset by the owner
+	 */
+	void clear();
+
+	/**	Find the nearest intersection
+	\param
+		aRay	light ray
+		aHit	the nearest intersection, aHit.mDist limits the search
+		aStats	counters of the calling thread
+	\return
+		MISS if nothing is closer than aHit.mDist, otherwise aHit.mResult
+	 */
+	RTResult intersect(const Ray& aRay, HitRecord& aHit, RenderStats& aStats) const;
+
+	/**	Any-hit query of a shadow ray, the traversal stops at the first 
+		opaque primitive
+	\param
+		aRay		shadow ray
+		aMaxDist	distance to the light
+		aOccluder	set to the opaque primitive found
+		aStats		counters of the calling thread
+	\return
+		the strongest occlusion found closer than @aMaxDist
+	 */
+	Occlusion findOcclusion(const Ray& aRay, Real aMaxDist, const Primitive*& aOccluder, 
+		RenderStats& aStats) const;
+
+	/**	Find the nearest intersections of the active rays of a packet, a node 
+		is visited when any of them hits its box
+	\return
+		mask of the lanes hit
+	 */
+	int intersectPacket(const RayPacket& aPacket, PacketHit& aHit, RenderStats& aStats) const;
+
+	int getNumOfNodes() const
+	{
+		return mNodes.size();
+	}
+
+private:
+	friend class SceneCache;
+
+	/// a leaf holds mCount primitives from mOffset, an inner node has its
+	/// first child next to it and the second one at mOffset.
+	/// The triangles of a leaf are also packed into mNumBlocks blocks from 
+	/// mBlock, the other mNumScalar primitives come first in the leaf.
+	struct Node
+	{
+		Vec3 mMin, mMax;
+		int mOffset;
+		int mCount;
+		int mAxis;
+		int mBlock;
+		int mNumBlocks;
+		int mNumScalar;
+	};
+
+	/// primitive bounds cached while building
+	struct BuildItem
+	{
+		Vec3 mMin, mMax;
+		Vec3 mCentre;
+		const Primitive* mPrim;
+	};
+
+	/// bounds of a range of items, of their boxes and of their centres
+	struct BuildBounds
+	{
+		Vec3 mMin, mMax;
+		Vec3 mCentreMin, mCentreMax;
+	};
+
+	/// items binned by their centres on every axis
+	struct BuildBins
+	{
+		struct Bin
+		{
+			Vec3 mMin, mMax;
+			int mCount;
+		};
+		Bin mBins[3][RT_BVH_BINS];
+	};
+
+	/// a subtree below the top of the hierarchy, built by one task into
+	/// its own nodes
+	struct BuildTask
+	{
+		int mBegin, mEnd;
+		int mDepth;
+		std::vector<Node> mNodes;
+		int mRoot;		// index of its root once gathered
+	};
+
+	/// a build item keyed by the Morton code of its centre
+	struct MortonItem
+	{
+		unsigned int mCode;
+		int mItem;
+	};
+
+	/// the hierarchy with explicit children while its treelets are 
+	/// restructured, the cost of a subtree is its SAH cost times its area
+	struct TreeletTree
+	{
+		std::vector<Node> mNodes;
+		std::vector<int> mLeft, mRight;
+		std::vector<Real> mCost;
+	};
+
+	/**	Recursively build the subtree of the items [aBegin, aEnd)
+	\return
+		index of the subtree root
+	 */
+	int _build(std::vector<BuildItem>& aItems, std::vector<Node>& aNodes, 
+		int aBegin, int aEnd, int aDepth) const;
+
+	/**	Build the top of the hierarchy, filling the bins of a node in
+		parallel. The ranges of at most @aTaskSize items are left to
+		@aTasks, their nodes have a count of -1 and the task at mOffset.
+	 */
+	int _buildTop(std::vector<BuildItem>& aItems, std::vector<Node>& aNodes, 
+		int aBegin, int aEnd, int aDepth, int aTaskSize, 
+		std::vector<BuildTask>& aTasks, ThreadPool& aPool) const;
+
+	/**	Build the subtree of a task
+	 */
+	void _buildTask(std::vector<BuildItem>* aItems, BuildTask* aTask) const;
+
+	/**	Copy the top nodes from @aIdx in depth-first order into @aNodes,
+		the nodes of the tasks replacing their placeholders
+	\param
+		aRefit	bound the top nodes by their children, they are not yet
+	 */
+	static void _gather(const std::vector<Node>& aTop, std::vector<BuildTask>& aTasks,
+		int aIdx, std::vector<Node>& aNodes, bool aRefit);
+
+	/**	Pack the leaf primitives and the triangle blocks of the nodes 
+		built over @aItems into @aArena
+	 */
+	void _store(std::vector<Node>& aNodes, const std::vector<BuildItem>& aItems, 
+		MemoryArena& aArena);
+
+	static void _initItems(const Primitive* const* aPrims, int aCount, BuildItem* aItems);
+	static void _computeBounds(const BuildItem* aItems, int aCount, BuildBounds* aBounds);
+	static void _mergeBounds(BuildBounds& aBounds, const BuildBounds& aOther);
+	static void _binItems(const BuildItem* aItems, int aCount, const BuildBounds* aBounds, 
+		BuildBins* aBins);
+	static void _mergeBins(BuildBins& aBins, const BuildBins& aOther);
+
+	/**	Split the items [aBegin, aEnd) of a node by the binned SAH
+	\param
+		aMid	the first item of the second child
+	\return
+		false	a leaf is cheaper than any split
+	 */
+	bool _split(std::vector<BuildItem>& aItems, int aBegin, int aEnd, 
+		const BuildBounds& aBounds, const BuildBins& aBins, int& aAxis, int& aMid) const;
+
+	/**	Choose the split plane by the binned SAH
+	\return
+		false	a leaf is cheaper than any split
+	 */
+	bool _findSplit(const BuildBins& aBins, const BuildBounds& aBounds, int aCount,
+		int& aAxis, Real& aPos) const;
+
+	// linear BVH
+
+	static void _mortonCodes(const BuildItem* aItems, int aCount, int aFirst, 
+		const BuildBounds* aBounds, MortonItem* aCodes);
+
+	/**	Sort by the codes, 10 bits a pass, the chunks of a pass are counted 
+		and scattered in parallel
+	 */
+	static void _radixSort(std::vector<MortonItem>& aCodes, ThreadPool* aPool);
+	static void _radixCount(const MortonItem* aCodes, int aCount, int aShift, int* aHist);
+	static void _radixScatter(const MortonItem* aCodes, int aCount, int aShift, 
+		int* aOffsets, MortonItem* aOut);
+	static void _sortItems(const MortonItem* aCodes, int aCount, 
+		const BuildItem* aItems, BuildItem* aOut);
+
+	/**	Recursively split the sorted codes [aBegin, aEnd) at their highest
+		different bit. With @aTasks the ranges of at most @aTaskSize codes 
+		are left to them as in _buildTop().
+	\return
+		index of the subtree root
+	 */
+	static int _buildLinear(const std::vector<MortonItem>& aCodes, std::vector<Node>& aNodes, 
+		int aBegin, int aEnd, int aDepth, int aTaskSize, std::vector<BuildTask>* aTasks);
+	static void _buildLinearTask(const std::vector<MortonItem>* aCodes, 
+		const std::vector<BuildItem>* aItems, BuildTask* aTask);
+
+	/**	Bound the nodes [aFirst, aLast) of a depth-first tree by their 
+		children, from the last one
+	 */
+	static void _refit(std::vector<Node>& aNodes, int aFirst, int aLast, const BuildItem* aItems);
+
+	/**	Restructure the treelet of every node in [aFirst, aLast), from the
+		last one so the children are done before their parents. The ranges 
+		of @aSkip are left out.
+	 */
+	static void _optimizeTreelets(TreeletTree* aTree, int aFirst, int aLast, 
+		const std::vector<BuildTask>* aSkip);
+
+	/**	Grow a treelet of up to RT_BVH_TREELET leaves from @aRoot and 
+		replace it by the one of the lowest SAH cost over the same leaves
+	 */
+	static void _optimizeTreelet(TreeletTree& aTree, int aRoot);
+
+	/**	Copy the subtree of @aIdx into @aNodes in depth-first order
+	\return
+		depth of the deepest leaf
+	 */
+	static int _flatten(const TreeletTree& aTree, int aIdx, int aDepth, std::vector<Node>& aNodes);
+
+	/**	Move the triangles of every leaf behind the other primitives and 
+		pack them into TriangleBlocks
+	 */
+	void _buildBlocks(std::vector<Node>& aNodes, PrimArray& aPrims, 
+		std::vector<TriangleBlock>& aBlocks) const;
+
+	/**	Use nodes built before, e.g. mapped from a cache file, without
+		copying. The leaf primitives are @aTable[@aPrims[i]] and the triangle 
+		blocks are made again from them.
+	\return
+		false if the nodes are not a tree the traversal can walk, the
+		hierarchy is left empty then
+	 */
+	bool _attach(const Node* aNodes, int aNumNodes, const int* aPrims, int aNumPrims,
+		const ArenaArray<const Primitive*>& aTable, MemoryArena& aArena);
+
+	/**	Whether the nodes are a tree in depth first order, no deeper than
+		the traversal stack, whose leaves lie in @aNumPrims primitives and
+		whose blocks hold only triangles
+	 */
+	static bool _checkNodes(const Node* aNodes, int aNumNodes, const int* aPrims, int aNumPrims,
+		const ArenaArray<const Primitive*>& aTable);
+
+	/**	Slab test of the lanes in @aMask against a node
+	\return
+		mask of the lanes entering the box before their current hit
+	 */
+	int _intersectBox(const Node& aNode, const RayPacket& aPacket, 
+		const PacketHit& aHit, int aMask) const;
+
+private:
+	ArenaArray<Node> mNodes;
+	ArenaArray<const Primitive*> mPrims;
+	ArenaArray<TriangleBlock> mBlocks;
+};
+
+}; // namespace RayTracer
+
+#endif // _RT_BVH_H_
@@ -1,72 +1,113 @@
-/********************************************************************
-	created:	2010/04/22
-	file name:	common.h
-	author:		maxint lnychina@gmail.com
-*********************************************************************/
-
-#ifndef _RT_COMMON_H_
-#define _RT_COMMON_H_
-
-#include <string>
-#include <iostream>
-
-#define HIGH_PRECISION
-
-#include "MathDefs.h"
-
-// ------------------------------------------------------------------------------
-// Useful Macros
-// ------------------------------------------------------------------------------
-
-#ifndef RT_PI
-#define RT_PI				3.141592653589793239462f
-#endif
-
-#ifndef RT_CLAMP
-#define RT_CLAMP(x,x1,x2) std::max(Real(x1), std::min(Real(x2), Real(x)))
-#endif
-
-#define RT_TRACEDEPTH		6
-#define RT_GRIDSIZE			32
-#define RT_GRIDSHIFT		5
-
-#ifndef SAFE_DELETE
-#define SAFE_DELETE(p) if(p) { delete (p); (p)=0; }
-#endif
-
-#ifndef SAFE_DELETE_ARRAY
-#define SAFE_DELETE_ARRAY(p) if(p) { delete[] (p); (p)=0; }
-#endif
-
-namespace RayTracer {
-
-#ifdef HIGH_PRECISION
-	typedef double Real;
-#else
-	typedef float Real;
-#endif
-
-inline Real rtRand( Real a_Range ) { return ((Real)rand() / RAND_MAX) * a_Range; }
-
-/// Intersection method return values
-enum RTResult
-{
-	INPRIM	= -1,	// Ray started inside primitive
-	MISS	= 0,	// Ray missed primitive
-	HIT		= 1		// Ray hit primitive
-};
-
-// ------------------------------------------------------------------------------
-// Useful type definitions
-// ------------------------------------------------------------------------------
-
-typedef Vector3<Real>	Color;
-typedef Vector3<Real>	Vec3;
-typedef Plane_<Real>	Plane;
-typedef AABB_<Real>		AABB;
-typedef Matrix_<Real>	Matrix;
-typedef std::string		String;
-
-}; // namespace RayTracer
-
+/********************************************************************
+	created:	2010/04/22
+	file name:	common.h
+	author:		maxint lnychina@gmail.com
+*********************************************************************/
+
+#ifndef _RT_COMMON_H_
+#define _RT_COMMON_H_
+
+#include <string>
+#include <iostream>
+
+// NOTE: Real is double unless RT_SINGLE_PRECISION is defined for the float build
+#ifndef RT_SINGLE_PRECISION
+#define HIGH_PRECISION
+#endif
+
+#include "MathDefs.h"
+
+// ------------------------------------------------------------------------------
+// Useful Macros
+// ------------------------------------------------------------------------------
+
+#ifndef RT_PI
+#define RT_PI				3.141592653589793239462f
+#endif
+
+#ifndef RT_CLAMP
+#define RT_CLAMP(x,x1,x2) std::max(Real(x1), std::min(Real(x2), Real(x)))
+#endif
+
+#define RT_TRACEDEPTH		6
+#define FAR_DISTANCE		1000000.0f
+#define RT_PACKETSIZE		16		// primary rays traced together: 4, 8 or 16
+#define RT_GRIDDENSITY		4		// cells per primitive of the regular grid
+#define RT_GRIDMAXSIZE		256		// most cells on one axis of the regular grid
+#define RT_WELD_EPSILON		1e-6f	// closer obj normals and texcoords are merged
+
+#ifndef SAFE_DELETE
+#define SAFE_DELETE(p) if(p) { delete (p); (p)=0; }
+#endif
+
+#ifndef SAFE_DELETE_ARRAY
+#define SAFE_DELETE_ARRAY(p) if(p) { delete[] (p); (p)=0; }
+#endif
+
+namespace RayTracer {
+
+#ifdef HIGH_PRECISION
+	typedef double Real;
+#else
+	typedef float Real;
+#endif
+
+inline Real rtRand( Real a_Range ) { return ((Real)rand() / RAND_MAX) * a_Range; }
+
+/// Intersection method return values
+enum RTResult
+{
+	INPRIM	= -1,	// Ray started inside primitive
+	MISS	= 0,	// Ray missed primitive
+	HIT		= 1		// Ray hit primitive
+};
+
+/// How much a shadow ray is blocked, ordered by strength
+enum Occlusion
+{
+	OC_NONE			= 0,	// Nothing between the point and the light
+	OC_TRANSLUCENT	= 1,	// Only refractive primitives in between
+	OC_OPAQUE		= 2		// Blocked
+};
+
+/// Kinds of rays counted by the renderer
+enum RayType
+{
+	RAY_PRIMARY		= 0,	// Camera rays, the antialiasing ones included
+	RAY_SHADOW		= 1,	// Shadow rays towards the lights
+	RAY_REFLECTION	= 2,	// Mirror reflection rays
+	RAY_REFRACTION	= 3,	// Transmitted rays
+	RAY_GLOSSY		= 4,	// Jittered rays of diffuse reflection
+	RAY_TYPES		= 5
+};
+
+/// Acceleration structures of the scene
+enum AccelType
+{
+	AT_GRID	= 0,	// Regular grid
+	AT_BVH	= 1,	// Bounding volume hierarchy
+	AT_LBVH	= 2		// Linear BVH of Morton codes, the fastest to build
+};
+
+/// Antialiasing of the primary rays
+enum AntiAlias
+{
+	AA_NONE		= 0,	// One ray per pixel
+	AA_EDGE		= 1,	// 2 x 2 rays where the primitive differs from the left or upper pixel
+	AA_ADAPTIVE	= 2		// Recursive subdivision of a shared sample lattice
+};
+
+// ------------------------------------------------------------------------------
+// Useful type definitions
+// ------------------------------------------------------------------------------
+
+typedef Vector3<Real>	Color;
+typedef Vector3<Real>	Vec3;
+typedef Plane_<Real>	Plane;
+typedef AABB_<Real>		AABB;
+typedef Matrix_<Real>	Matrix;
+typedef std::string		String;
+
+}; // namespace RayTracer
+
 #endif // _RT_COMMON_H_
\ No newline at end of file
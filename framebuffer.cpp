@@ -0,0 +1,378 @@
+/********************************************************************
+	created:	2026/10/17
+	file name:	framebuffer.cpp
+	author:		maxint lnychina@gmail.com
+*********************************************************************/
+
+#include "framebuffer.h"
+
+#include <fstream>
+#include <algorithm>
+#include <cctype>
+
+namespace RayTracer {
+
+// little endian fields of BMP and TGA headers
+static unsigned int _readU16(const unsigned char* p)
+{
+	return p[0] | (p[1] << 8);
+}
+
+static unsigned int _readU32(const unsigned char* p)
+{
+	return p[0] | (p[1] << 8) | (p[2] << 16) | ((unsigned int)p[3] << 24);
+}
+
+static void _writeU16(std::ostream& os, unsigned int v)
+{
+	os.put((char)(v & 0xff));
+	os.put((char)((v >> 8) & 0xff));
+}
+
+static void _writeU32(std::ostream& os, unsigned int v)
+{
+	_writeU16(os, v & 0xffff);
+	_writeU16(os, v >> 16);
+}
+
+static String _lowerExtension(const String& aFilename)
+{
+	String::size_type dot = aFilename.rfind('.');
+	if (dot == String::npos)
+		return String();
+	String ext = aFilename.substr(dot + 1);
+	for (size_t i=0; i<ext.size(); ++i)
+		ext[i] = (char)tolower((unsigned char)ext[i]);
+	return ext;
+}
+
+// ------------------------------------------------------------------------------
+// FrameBuffer class implementation
+// ------------------------------------------------------------------------------
+
+FrameBuffer::FrameBuffer()
+: mWidth(0)
+, mHeight(0)
+{
+}
+
+FrameBuffer::FrameBuffer(int aWidth, int aHeight)
+: mWidth(0)
+, mHeight(0)
+{
+	resize(aWidth, aHeight);
+}
+
+void FrameBuffer::resize(int aWidth, int aHeight)
+{
+	mWidth = std::max(aWidth, 0);
+	mHeight = std::max(aHeight, 0);
+	mPixels.assign(mWidth * mHeight, makePixel(0, 0, 0));
+}
+
+void FrameBuffer::fill(Pixel aPixel)
+{
+	std::fill(mPixels.begin(), mPixels.end(), aPixel);
+}
+
+bool FrameBuffer::load(const String& aFilename)
+{
+	std::ifstream ifs(aFilename.c_str(), std::ios::binary);
+	if (!ifs)
+		return false;
+	std::vector<unsigned char> data((std::istreambuf_iterator<char>(ifs)),
+		std::istreambuf_iterator<char>());
+
+	if (data.size() >= 2 && data[0] == 'P' && data[1] >= '2' && data[1] <= '6')
+		return _loadPNM(data);
+	if (data.size() >= 2 && data[0] == 'B' && data[1] == 'M')
+		return _loadBMP(data);
+	// TGA has no magic, it is the last guess
+	return _loadTGA(data);
+}
+
+bool FrameBuffer::save(const String& aFilename) const
+{
+	String ext = _lowerExtension(aFilename);
+	if (ext != "ppm" && ext != "bmp" && ext != "tga")
+		return false;
+
+	std::ofstream ofs(aFilename.c_str(), std::ios::binary);
+	if (!ofs)
+		return false;
+
+	std::vector<char> row(mWidth * 3);
+	if (ext == "ppm")
+	{
+		ofs << "P6\n" << mWidth << " " << mHeight << "\n255\n";
+		for (int y=0; y<mHeight; ++y)
+		{
+			const Pixel *src = getRow(y);
+			for (int x=0; x<mWidth; ++x)
+			{
+				row[x*3 + 0] = (char)pixelRed(src[x]);
+				row[x*3 + 1] = (char)pixelGreen(src[x]);
+				row[x*3 + 2] = (char)pixelBlue(src[x]);
+			}
+			ofs.write(&row[0], row.size());
+		}
+	}
+	else if (ext == "bmp")
+	{
+		const int stride = (mWidth * 3 + 3) & ~3;
+		row.resize(stride, 0);
+		_writeU16(ofs, 'B' | ('M' << 8));
+		_writeU32(ofs, 54 + stride * mHeight);
+		_writeU32(ofs, 0);
+		_writeU32(ofs, 54);
+		_writeU32(ofs, 40);			// BITMAPINFOHEADER
+		_writeU32(ofs, mWidth);
+		_writeU32(ofs, mHeight);	// bottom up
+		_writeU16(ofs, 1);
+		_writeU16(ofs, 24);
+		_writeU32(ofs, 0);			// BI_RGB
+		_writeU32(ofs, stride * mHeight);
+		_writeU32(ofs, 2835);		// 72 dpi
+		_writeU32(ofs, 2835);
+		_writeU32(ofs, 0);
+		_writeU32(ofs, 0);
+		for (int y=mHeight-1; y>=0; --y)
+		{
+			const Pixel *src = getRow(y);
+			for (int x=0; x<mWidth; ++x)
+			{
+				row[x*3 + 0] = (char)pixelBlue(src[x]);
+				row[x*3 + 1] = (char)pixelGreen(src[x]);
+				row[x*3 + 2] = (char)pixelRed(src[x]);
+			}
+			ofs.write(&row[0], stride);
+		}
+	}
+	else
+	{
+		const unsigned char header[12] = { 0, 0, 2 };	// raw true color
+		ofs.write((const char*)header, sizeof(header));
+		_writeU16(ofs, mWidth);
+		_writeU16(ofs, mHeight);
+		ofs.put(24);
+		ofs.put(0x20);	// top left origin
+		for (int y=0; y<mHeight; ++y)
+		{
+			const Pixel *src = getRow(y);
+			for (int x=0; x<mWidth; ++x)
+			{
+				row[x*3 + 0] = (char)pixelBlue(src[x]);
+				row[x*3 + 1] = (char)pixelGreen(src[x]);
+				row[x*3 + 2] = (char)pixelRed(src[x]);
+			}
+			ofs.write(&row[0], row.size());
+		}
+	}
+	return ofs.good();
+}
+
+bool FrameBuffer::_loadPNM(const std::vector<unsigned char>& aData)
+{
+	const char type = aData[1];
+	const bool ascii = (type == '2' || type == '3');
+	const bool gray = (type == '2' || type == '5');
+	if (type == '4')
+		return false;	// bitmaps are not worth it
+
+	// width, height and max value, separated by blanks and comments
+	size_t pos = 2;
+	int header[3];
+	for (int i=0; i<3; ++i)
+	{
+		while (pos < aData.size() && (isspace(aData[pos]) || aData[pos] == '#'))
+		{
+			if (aData[pos] == '#')
+				while (pos < aData.size() && aData[pos] != '\n') ++pos;
+			else
+				++pos;
+		}
+		if (pos >= aData.size() || !isdigit(aData[pos]))
+			return false;
+		header[i] = 0;
+		while (pos < aData.size() && isdigit(aData[pos]))
+			header[i] = header[i] * 10 + (aData[pos++] - '0');
+	}
+	const int w = header[0], h = header[1], maxVal = header[2];
+	if (w <= 0 || h <= 0 || maxVal <= 0 || maxVal > 65535)
+		return false;
+	++pos;	// the single blank before the binary raster
+
+	const int channels = gray ? 1 : 3;
+	const int bytes = (maxVal > 255) ? 2 : 1;
+	if (!ascii && aData.size() - std::min(pos, aData.size()) < (size_t)w * h * channels * bytes)
+		return false;
+
+	std::vector<Pixel> pixels(w * h);
+	for (int i=0; i<w*h; ++i)
+	{
+		int c[3];
+		for (int k=0; k<channels; ++k)
+		{
+			int v = 0;
+			if (ascii)
+			{
+				while (pos < aData.size() && !isdigit(aData[pos])) ++pos;
+				if (pos >= aData.size())
+					return false;
+				while (pos < aData.size() && isdigit(aData[pos]))
+					v = v * 10 + (aData[pos++] - '0');
+			}
+			else if (bytes == 2)
+			{
+				v = (aData[pos] << 8) | aData[pos + 1];
+				pos += 2;
+			}
+			else
+			{
+				v = aData[pos++];
+			}
+			c[k] = std::min(v, maxVal) * 255 / maxVal;
+		}
+		pixels[i] = gray ? makePixel(c[0], c[0], c[0]) : makePixel(c[0], c[1], c[2]);
+	}
+
+	mWidth = w;
+	mHeight = h;
+	mPixels.swap(pixels);
+	return true;
+}
+
+bool FrameBuffer::_loadBMP(const std::vector<unsigned char>& aData)
+{
+	if (aData.size() < 54)
+		return false;
+	const unsigned char *d = &aData[0];
+	const unsigned int offset = _readU32(d + 10);
+	const unsigned int infoSize = _readU32(d + 14);
+	const int w = (int)_readU32(d + 18);
+	const int rawH = (int)_readU32(d + 22);
+	const unsigned int bpp = _readU16(d + 28);
+	const unsigned int compression = _readU32(d + 30);
+	unsigned int numColors = _readU32(d + 46);
+
+	// only BI_RGB, and BI_BITFIELDS with the usual BGRA masks
+	if (infoSize < 40 || w <= 0 || rawH == 0)
+		return false;
+	if (!(compression == 0 || (compression == 3 && bpp == 32)))
+		return false;
+	if (bpp != 8 && bpp != 24 && bpp != 32)
+		return false;
+
+	const bool topDown = rawH < 0;
+	const int h = topDown ? -rawH : rawH;
+	const size_t stride = ((size_t)w * bpp / 8 + 3) & ~(size_t)3;
+	if (offset > aData.size() || aData.size() - offset < stride * h)
+		return false;
+
+	std::vector<Pixel> palette;
+	if (bpp == 8)
+	{
+		if (numColors == 0 || numColors > 256)
+			numColors = 256;
+		const size_t palPos = 14 + infoSize;
+		if (palPos + numColors * 4 > offset)
+			return false;
+		palette.resize(256, makePixel(0, 0, 0));
+		for (unsigned int i=0; i<numColors; ++i)
+		{
+			const unsigned char *p = d + palPos + i * 4;
+			palette[i] = makePixel(p[2], p[1], p[0]);
+		}
+	}
+
+	std::vector<Pixel> pixels(w * h);
+	for (int y=0; y<h; ++y)
+	{
+		const unsigned char *src = d + offset + stride * (topDown ? y : h - 1 - y);
+		Pixel *dst = &pixels[y * w];
+		for (int x=0; x<w; ++x)
+		{
+			if (bpp == 8)
+				dst[x] = palette[src[x]];
+			else if (bpp == 24)
+				dst[x] = makePixel(src[x*3 + 2], src[x*3 + 1], src[x*3]);
+			else
+				dst[x] = makePixel(src[x*4 + 2], src[x*4 + 1], src[x*4]);
+		}
+	}
+
+	mWidth = w;
+	mHeight = h;
+	mPixels.swap(pixels);
+	return true;
+}
+
+bool FrameBuffer::_loadTGA(const std::vector<unsigned char>& aData)
+{
+	if (aData.size() < 18)
+		return false;
+	const unsigned char *d = &aData[0];
+	const unsigned int idLength = d[0];
+	const unsigned int colorMapType = d[1];
+	const unsigned int imageType = d[2];
+	const unsigned int colorMapLength = _readU16(d + 5);
+	const unsigned int colorMapBits = d[7];
+	const int w = (int)_readU16(d + 12);
+	const int h = (int)_readU16(d + 14);
+	const unsigned int bpp = d[16];
+	const bool topDown = (d[17] & 0x20) != 0;
+
+	const bool rle = (imageType == 10 || imageType == 11);
+	const bool gray = (imageType == 3 || imageType == 11);
+	if (!(imageType == 2 || imageType == 3 || rle) || colorMapType > 1)
+		return false;
+	if (gray ? bpp != 8 : (bpp != 24 && bpp != 32))
+		return false;
+	if (w <= 0 || h <= 0)
+		return false;
+
+	const size_t bytes = bpp / 8;
+	size_t pos = 18 + idLength + colorMapType * colorMapLength * ((colorMapBits + 7) / 8);
+	std::vector<Pixel> pixels(w * h);
+	const size_t count = (size_t)w * h;
+	size_t i = 0;
+	while (i < count)
+	{
+		// a raw image is a single run of raw pixels
+		size_t run = count - i;
+		bool repeat = false;
+		if (rle)
+		{
+			if (pos >= aData.size())
+				return false;
+			run = (aData[pos] & 0x7f) + 1;
+			repeat = (aData[pos] & 0x80) != 0;
+			++pos;
+			if (run > count - i)
+				return false;
+		}
+		const size_t needed = repeat ? bytes : run * bytes;
+		if (pos > aData.size() || aData.size() - pos < needed)
+			return false;
+		for (size_t k=0; k<run; ++k, ++i)
+		{
+			const unsigned char *p = d + pos + (repeat ? 0 : k * bytes);
+			pixels[i] = gray ? makePixel(p[0], p[0], p[0]) : makePixel(p[2], p[1], p[0]);
+		}
+		pos += needed;
+	}
+
+	if (!topDown)
+	{
+		for (int y=0; y<h/2; ++y)
+			std::swap_ranges(pixels.begin() + y * w, pixels.begin() + (y + 1) * w,
+				pixels.begin() + (h - 1 - y) * w);
+	}
+
+	mWidth = w;
+	mHeight = h;
+	mPixels.swap(pixels);
+	return true;
+}
+
+}; // namespace RayTracer
@@ -0,0 +1,80 @@
+/********************************************************************
+	created:	2026/10/17
+	file name:	framebuffer.h
+	author:		maxint lnychina@gmail.com
+*********************************************************************/
+
+#ifndef _RT_FRAMEBUFFER_H_
+#define _RT_FRAMEBUFFER_H_
+
+#include "common.h"
+#include <vector>
+
+namespace RayTracer {
+
+/**	A pixel is packed as 0xAARRGGBB, the same layout as QRgb, so a row can be
+	copied straight into a QImage::Format_RGB32 scan line.
+ */
+typedef unsigned int Pixel;
+
+inline Pixel makePixel(int r, int g, int b)
+{
+	return 0xff000000u | ((r & 0xff) << 16) | ((g & 0xff) << 8) | (b & 0xff);
+}
+inline int pixelRed(Pixel p)	{ return (p >> 16) & 0xff; }
+inline int pixelGreen(Pixel p)	{ return (p >> 8) & 0xff; }
+inline int pixelBlue(Pixel p)	{ return p & 0xff; }
+
+// ------------------------------------------------------------------------------
+// Frame buffer and image file io without Qt
+// ------------------------------------------------------------------------------
+
+class FrameBuffer
+{
+public:
+	FrameBuffer();
+	FrameBuffer(int aWidth, int aHeight);
+
+	/**	Reallocate the pixels, the content is cleared to black
+	 */
+	void resize(int aWidth, int aHeight);
+	void fill(Pixel aPixel);
+
+	int getWidth() const				{ return mWidth; }
+	int getHeight() const				{ return mHeight; }
+	bool isNull() const					{ return mPixels.empty(); }
+
+	Pixel* getRow(int y)				{ return &mPixels[y * mWidth]; }
+	const Pixel* getRow(int y) const	{ return &mPixels[y * mWidth]; }
+	Pixel getPixel(int x, int y) const	{ return mPixels[x + y * mWidth]; }
+	void setPixel(int x, int y, Pixel aPixel) { mPixels[x + y * mWidth] = aPixel; }
+
+	/**	Load an image file, the format is told by the file content.
+		Supported: binary and ascii PPM/PGM, uncompressed 24/32 bits BMP,
+		raw and RLE 24/32 bits and 8 bits gray TGA.
+	\return
+		false if the file is missing or the format is not supported, the
+		frame buffer is left untouched then
+	 */
+	bool load(const String& aFilename);
+
+	/**	Save to an image file, the format is told by the file extension:
+		.ppm, .bmp or .tga
+	\return
+		false if the file can not be written or the extension is unknown
+	 */
+	bool save(const String& aFilename) const;
+
+private:
+	bool _loadPNM(const std::vector<unsigned char>& aData);
+	bool _loadBMP(const std::vector<unsigned char>& aData);
+	bool _loadTGA(const std::vector<unsigned char>& aData);
+
+private:
+	int mWidth, mHeight;
+	std::vector<Pixel> mPixels;
+};
+
+}; // namespace RayTracer
+
+#endif // _RT_FRAMEBUFFER_H_
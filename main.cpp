@@ -1,13 +1,34 @@
-#include <QApplication>
-#include "mainwindow.h"
-
-int main(int argc, char* argv[])
-{
-	Q_INIT_RESOURCE(raytracer);
-	QApplication app(argc, argv);
-
-	MainWindow win;
-	win.show();
-
-	return app.exec();
+#include <QApplication>
+#include <QImage>
+#include "mainwindow.h"
+#include "material.h"
+#include "framebuffer.h"
+
+using namespace RayTracer;
+
+/// textures of the formats the frame buffer does not read, PNG and JPEG
+static bool _loadImage(const String& aFilename, FrameBuffer& aImage)
+{
+	QImage img(aFilename.c_str());
+	if (img.isNull())
+		return false;
+	aImage.resize(img.width(), img.height());
+	for (int y=0; y<img.height(); ++y) for (int x=0; x<img.width(); ++x)
+	{
+		QRgb clr = img.pixel(x, y);
+		aImage.setPixel(x, y, makePixel(qRed(clr), qGreen(clr), qBlue(clr)));
+	}
+	return true;
+}
+
+int main(int argc, char* argv[])
+{
+	Q_INIT_RESOURCE(raytracer);
+	QApplication app(argc, argv);
+	TextureManager::getInstance().setImageLoader(_loadImage);
+
+	MainWindow win;
+	win.show();
+
+	return app.exec();
 }
\ No newline at end of file
@@ -0,0 +1,164 @@
+/********************************************************************
+	created:	2026/10/17
+	file name:	mappedfile.cpp
+	author:		maxint lnychina@gmail.com
+*********************************************************************/
+
+#include "mappedfile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace RayTracer {
+
+// an empty file can not be mapped, it is opened as this
+static const char EMPTY_FILE[1] = { 0 };
+
+// ------------------------------------------------------------------------------
+// MappedFile class implementation
+// ------------------------------------------------------------------------------
+
+MappedFile::MappedFile()
+: mData(0)
+, mSize(0)
+#ifdef _WIN32
+, mFile(INVALID_HANDLE_VALUE)
+, mMapping(0)
+#endif
+{
+}
+
+MappedFile::~MappedFile()
+{
+	close();
+}
+
+#ifdef _WIN32
+
+bool MappedFile::open(const String& aFilename)
+{
+	close();
+	mFile = CreateFileA(aFilename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+		OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (mFile == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(mFile, &size))
+	{
+		close();
+		return false;
+	}
+	mSize = static_cast<size_t>(size.QuadPart);
+	if (mSize == 0)
+	{
+		mData = EMPTY_FILE;
+		return true;
+	}
+
+	mMapping = CreateFileMappingA(mFile, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (mMapping)
+		mData = static_cast<const char*>(MapViewOfFile(mMapping, FILE_MAP_READ, 0, 0, 0));
+	if (!mData)
+	{
+		close();
+		return false;
+	}
+	return true;
+}
+
+void MappedFile::close()
+{
+	if (mData && mData != EMPTY_FILE)
+		UnmapViewOfFile(mData);
+	if (mMapping)
+		CloseHandle(mMapping);
+	if (mFile != INVALID_HANDLE_VALUE)
+		CloseHandle(mFile);
+	mData = 0;
+	mSize = 0;
+	mMapping = 0;
+	mFile = INVALID_HANDLE_VALUE;
+}
+
+bool MappedFile::getFileInfo(const String& aFilename, unsigned long long& aSize, 
+							 long long& aModified)
+{
+	WIN32_FILE_ATTRIBUTE_DATA data;
+	if (!GetFileAttributesExA(aFilename.c_str(), GetFileExInfoStandard, &data))
+		return false;
+	aSize = (static_cast<unsigned long long>(data.nFileSizeHigh) << 32) | data.nFileSizeLow;
+	aModified = (static_cast<long long>(data.ftLastWriteTime.dwHighDateTime) << 32) | 
+		data.ftLastWriteTime.dwLowDateTime;
+	return true;
+}
+
+#else
+
+bool MappedFile::open(const String& aFilename)
+{
+	close();
+	int fd = ::open(aFilename.c_str(), O_RDONLY);
+	if (fd < 0)
+		return false;
+
+	struct stat st;
+	if (fstat(fd, &st) != 0)
+	{
+		::close(fd);
+		return false;
+	}
+	mSize = static_cast<size_t>(st.st_size);
+	if (mSize == 0)
+	{
+		::close(fd);
+		mData = EMPTY_FILE;
+		return true;
+	}
+
+	// NOTE: the mapping stays valid after the descriptor is closed
+	void *data = mmap(NULL, mSize, PROT_READ, MAP_PRIVATE, fd, 0);
+	::close(fd);
+	if (data == MAP_FAILED)
+	{
+		mSize = 0;
+		return false;
+	}
+	madvise(data, mSize, MADV_SEQUENTIAL);
+	mData = static_cast<const char*>(data);
+	return true;
+}
+
+void MappedFile::close()
+{
+	if (mData && mData != EMPTY_FILE)
+		munmap(const_cast<char*>(mData), mSize);
+	mData = 0;
+	mSize = 0;
+}
+
+bool MappedFile::getFileInfo(const String& aFilename, unsigned long long& aSize, 
+							 long long& aModified)
+{
+	struct stat st;
+	if (stat(aFilename.c_str(), &st) != 0)
+		return false;
+	aSize = static_cast<unsigned long long>(st.st_size);
+#if defined(__APPLE__)
+	aModified = static_cast<long long>(st.st_mtimespec.tv_sec) * 1000000000LL + st.st_mtimespec.tv_nsec;
+#else
+	aModified = static_cast<long long>(st.st_mtim.tv_sec) * 1000000000LL + st.st_mtim.tv_nsec;
+#endif
+	return true;
+}
+
+#endif
+
+}; // namespace RayTracer
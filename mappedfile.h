@@ -0,0 +1,61 @@
+/********************************************************************
+	created:	2026/10/17
+	file name:	mappedfile.h
+	author:		maxint lnychina@gmail.com
+*********************************************************************/
+
+#ifndef _RT_MAPPEDFILE_H_
+#define _RT_MAPPEDFILE_H_
+
+#include "common.h"
+
+namespace RayTracer {
+
+// ------------------------------------------------------------------------------
+// Read only memory mapped file
+// ------------------------------------------------------------------------------
+
+/**	Maps a whole file into the address space, the pages are read by the
+	system when touched instead of being copied through a stream buffer
+ */
+class MappedFile
+{
+public:
+	MappedFile();
+	~MappedFile();
+
+	/**	Map a file, the one mapped before is closed
+	\return
+		false if the file can not be opened or mapped
+	 */
+	bool open(const String& aFilename);
+	void close();
+
+	/**	Size and last modification time of a file, the time is in the units 
+		of the system and only compared for equality
+	\return
+		false if the file does not exist
+	 */
+	static bool getFileInfo(const String& aFilename, unsigned long long& aSize, 
+		long long& aModified);
+
+	bool isOpen() const					{ return mData != 0; }
+	const char* getData() const			{ return mData; }
+	size_t getSize() const				{ return mSize; }
+
+private:
+	const char* mData;
+	size_t mSize;
+#ifdef _WIN32
+	void* mFile;
+	void* mMapping;
+#endif
+
+	// non-copyable
+	MappedFile(const MappedFile&);
+	MappedFile& operator=(const MappedFile&);
+};
+
+}; // namespace RayTracer
+
+#endif // _RT_MAPPEDFILE_H_
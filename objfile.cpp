@@ -0,0 +1,773 @@
+/********************************************************************
+	created:	2026/10/17
+	file name:	objfile.cpp
+	author:		maxint lnychina@gmail.com
+*********************************************************************/
+
+#include "objfile.h"
+#include "mappedfile.h"
+#include "threadpool.h"
+#include "AccessObj.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <clocale>
+#include <functional>
+#ifdef __APPLE__
+#include <xlocale.h>
+#endif
+
+namespace RayTracer {
+
+// bytes of a chunk parsed by one task, smaller files are parsed at once
+static const size_t OBJ_MIN_CHUNK = 1 << 20;
+static const int OBJ_CHUNKS_PER_THREAD = 4;
+
+// powers of ten a double holds exactly
+static const double POW10[] = {
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+static inline bool _isSpace(char c)
+{
+	return c == ' ' || c == '\t' || c == '\r';
+}
+
+static inline bool _isDigit(char c)
+{
+	return c >= '0' && c <= '9';
+}
+
+static inline const char* _skipSpace(const char* p, const char* aEnd)
+{
+	while (p < aEnd && _isSpace(*p))
+		++p;
+	return p;
+}
+
+/// the first character of the next line
+static inline const char* _skipLine(const char* p, const char* aEnd)
+{
+	const char *eol = static_cast<const char*>(memchr(p, '\n', aEnd - p));
+	return eol ? eol + 1 : aEnd;
+}
+
+/// whether the line at @p starts with the keyword and a space
+static inline bool _isKeyword(const char* p, const char* aEnd, const char* aKeyword)
+{
+	const size_t len = strlen(aKeyword);
+	return static_cast<size_t>(aEnd - p) > len && !memcmp(p, aKeyword, len) && _isSpace(p[len]);
+}
+
+/// the word at @p, up to a space or the end of the line
+static const char* _parseWord(const char* p, const char* aEnd, String& aWord)
+{
+	p = _skipSpace(p, aEnd);
+	const char *first = p;
+	while (p < aEnd && !_isSpace(*p) && *p != '\n')
+		++p;
+	aWord.assign(first, p);
+	return p;
+}
+
+/// strtod() in the C locale, the decimal point of the user locale is ignored
+static double _strtodC(const char* aStr)
+{
+#ifdef _WIN32
+	static const _locale_t cLocale = _create_locale(LC_NUMERIC, "C");
+	return _strtod_l(aStr, NULL, cLocale);
+#else
+	static const locale_t cLocale = newlocale(LC_NUMERIC_MASK, "C", (locale_t)0);
+	return strtod_l(aStr, NULL, cLocale);
+#endif
+}
+
+/**	Parse a decimal float without the locale and the stream of scanf. Up to
+	15 digits and exponents within 22 are exact in a double, the rest goes
+	to strtod() in the C locale.
+\return
+	the character after the number, @p if there is no number
+ */
+static const char* _parseFloat(const char* p, const char* aEnd, float& aVal)
+{
+	const char *first = p;
+	bool neg = false;
+	if (p < aEnd && (*p == '-' || *p == '+'))
+		neg = (*p++ == '-');
+
+	unsigned long long mant = 0;
+	int digits = 0, exp10 = 0;
+	bool any = false;
+	for (; p < aEnd && _isDigit(*p); ++p, any = true)
+	{
+		if (digits < 19)
+		{
+			mant = mant * 10 + (*p - '0');
+			digits += (mant != 0);
+		}
+		else
+			++exp10;
+	}
+	if (p < aEnd && *p == '.')
+	{
+		for (++p; p < aEnd && _isDigit(*p); ++p, any = true)
+		{
+			if (digits < 19)
+			{
+				mant = mant * 10 + (*p - '0');
+				digits += (mant != 0);
+				--exp10;
+			}
+		}
+	}
+	if (!any)
+	{
+		aVal = 0;
+		return first;
+	}
+	if (p < aEnd && (*p == 'e' || *p == 'E'))
+	{
+		const char *q = p + 1;
+		bool negExp = false;
+		if (q < aEnd && (*q == '-' || *q == '+'))
+			negExp = (*q++ == '-');
+		if (q < aEnd && _isDigit(*q))
+		{
+			int e = 0;
+			for (; q < aEnd && _isDigit(*q); ++q)
+				e = std::min(e * 10 + (*q - '0'), 100000);
+			exp10 += negExp ? -e : e;
+			p = q;
+		}
+	}
+
+	double val;
+	if (mant == 0)
+		val = 0;
+	else if (digits <= 15 && exp10 >= -22 && exp10 <= 22)
+		val = exp10 < 0 ? mant / POW10[-exp10] : mant * POW10[exp10];
+	else
+	{
+		char buf[128];
+		size_t len = std::min(static_cast<size_t>(p - first), sizeof(buf) - 1);
+		memcpy(buf, first, len);
+		buf[len] = '\0';
+		val = _strtodC(buf);
+		neg = false;
+	}
+	aVal = static_cast<float>(neg ? -val : val);
+	return p;
+}
+
+/// \return	the character after the integer, @p if there is none
+static inline const char* _parseInt(const char* p, const char* aEnd, int& aVal)
+{
+	const char *first = p;
+	bool neg = false;
+	if (p < aEnd && (*p == '-' || *p == '+'))
+		neg = (*p++ == '-');
+	if (p == aEnd || !_isDigit(*p))
+		return first;
+	int val = 0;
+	for (; p < aEnd && _isDigit(*p); ++p)
+		val = val * 10 + (*p - '0');
+	aVal = neg ? -val : val;
+	return p;
+}
+
+/// 1 based or negative relative OBJ index to a 0 based one, -1 if it is 0
+static inline int _resolveIndex(int aIndex, int aCount)
+{
+	return aIndex > 0 ? aIndex - 1 : (aIndex < 0 ? aCount + aIndex : -1);
+}
+
+static const char* _parseFloats(const char* p, const char* aEnd, int aNum, std::vector<float>& aOut)
+{
+	for (int i=0; i<aNum; ++i)
+	{
+		float val;
+		p = _parseFloat(_skipSpace(p, aEnd), aEnd, val);
+		aOut.push_back(val);
+	}
+	return p;
+}
+
+static String _dirName(const String& aPath)
+{
+	String::size_type slash = aPath.find_last_of("/\\");
+	return slash == String::npos ? String() : aPath.substr(0, slash + 1);
+}
+
+// ------------------------------------------------------------------------------
+// ObjMaterial class implementation
+// ------------------------------------------------------------------------------
+
+ObjMaterial::ObjMaterial()
+: mShininess(32.0f)
+{
+	for (int i=0; i<3; ++i)
+	{
+		mAmbient[i] = 0.2f;
+		mDiffuse[i] = 0.8f;
+		mSpecular[i] = 0;
+		mEmissive[i] = 0;
+	}
+}
+
+// ------------------------------------------------------------------------------
+// ObjFile class implementation
+// ------------------------------------------------------------------------------
+
+ObjFile::ObjFile()
+{
+}
+
+void ObjFile::clear()
+{
+	mPositions.clear();
+	mNormals.clear();
+	mTexCoords.clear();
+	mCorners.clear();
+	mTriMaterials.clear();
+	mMaterials.clear();
+	mLibraries.clear();
+}
+
+/// a piece of the file parsed by one task, the indices are local to it
+struct ObjFile::Chunk
+{
+	/// a usemtl or mtllib statement
+	struct Statement
+	{
+		String mName;
+		bool mLibrary;
+	};
+
+	const char* mBegin;
+	const char* mEnd;
+
+	std::vector<float> mPositions;
+	std::vector<float> mNormals;
+	std::vector<float> mTexCoords;
+	std::vector<int> mCorners;
+	/// the usemtl statement of each triangle, -1 before the first one
+	std::vector<int> mTriMaterials;
+	/// slots of mCorners with a negative index, counted back from the chunk end
+	std::vector<int> mRelative;
+	std::vector<Statement> mStatements;
+
+	// set by _merge()
+	std::vector<int> mMaterials;	// material of each usemtl statement
+	int mMaterialBefore;			// material in use when the chunk begins
+	size_t mFirstPosition;			// offsets of the elements in the whole file
+	size_t mFirstNormal;
+	size_t mFirstTexCoord;
+	size_t mFirstCorner;
+	size_t mNumTriangles;
+};
+
+bool ObjFile::load(const String& aFilename, int aNumThreads)
+{
+	clear();
+	MappedFile file;
+	if (!file.open(aFilename))
+		return false;
+
+	const char *data = file.getData();
+	const size_t size = file.getSize();
+	const int numThreads = aNumThreads > 0 ? aNumThreads : ThreadPool::getHardwareThreads();
+	// NOTE: a few chunks per thread, the lines are not equally expensive
+	const int numChunks = static_cast<int>(std::min(size / OBJ_MIN_CHUNK + 1,
+		static_cast<size_t>(numThreads * OBJ_CHUNKS_PER_THREAD)));
+
+	// every chunk but the last ends after a line break
+	std::vector<Chunk> chunks(numChunks);
+	const char *begin = data;
+	for (int i=0; i<numChunks; ++i)
+	{
+		const char *end = data + size;
+		if (i + 1 < numChunks)
+			end = std::max(begin, _skipLine(data + size / numChunks * (i + 1), end));
+		chunks[i].mBegin = begin;
+		chunks[i].mEnd = end;
+		begin = end;
+	}
+
+	if (numChunks == 1 || numThreads == 1)
+	{
+		for (int i=0; i<numChunks; ++i)
+			_parseChunk(&chunks[i], 0);
+		_merge(chunks, _dirName(aFilename), NULL);
+	}
+	else
+	{
+		ThreadPool pool(std::min(numThreads, numChunks));
+		for (int i=0; i<numChunks; ++i)
+			pool.submit(std::bind(&ObjFile::_parseChunk, &chunks[i], std::placeholders::_1));
+		pool.wait();
+		_merge(chunks, _dirName(aFilename), &pool);
+	}
+	_dropInvalid();
+
+	center();
+	if (mNormals.empty() && !mCorners.empty())
+		generateNormals(90.0f);
+	return true;
+}
+
+void ObjFile::_parseChunk(Chunk* aChunk, int /*aWorker*/)
+{
+	Chunk &chunk = *aChunk;
+	const char *p = chunk.mBegin;
+	const char *aEnd = chunk.mEnd;
+	int material = -1;
+	Chunk::Statement stmt;
+	while (p < aEnd)
+	{
+		p = _skipSpace(p, aEnd);
+		if (p == aEnd)
+			break;
+		const char c = *p;
+		const char c1 = (p + 1 < aEnd) ? p[1] : '\0';
+		if (c == 'v' && _isSpace(c1))
+		{
+			p = _parseFloats(p + 2, aEnd, 3, chunk.mPositions);
+		}
+		else if (c == 'v' && c1 == 'n' && p + 2 < aEnd && _isSpace(p[2]))
+		{
+			p = _parseFloats(p + 3, aEnd, 3, chunk.mNormals);
+		}
+		else if (c == 'v' && c1 == 't' && p + 2 < aEnd && _isSpace(p[2]))
+		{
+			p = _parseFloats(p + 3, aEnd, 2, chunk.mTexCoords);
+		}
+		else if (c == 'f' && _isSpace(c1))
+		{
+			// a polygon is a fan of triangles around its first corner
+			const int count[CORNER_SIZE] = {
+				static_cast<int>(chunk.mPositions.size() / 3),
+				static_cast<int>(chunk.mTexCoords.size() / 2),
+				static_cast<int>(chunk.mNormals.size() / 3)
+			};
+			int first[CORNER_SIZE], prev[CORNER_SIZE], cur[CORNER_SIZE];
+			// bit k is set if attribute k of the corner is a relative index
+			int relFirst = 0, relPrev = 0, relCur = 0;
+			int numCorners = 0;
+			p += 2;
+			for (;;)
+			{
+				int idx[CORNER_SIZE] = { 0, 0, 0 };
+				p = _skipSpace(p, aEnd);
+				const char *q = _parseInt(p, aEnd, idx[CORNER_POS]);
+				if (q == p)
+					break;
+				if (q < aEnd && *q == '/')
+				{
+					q = _parseInt(q + 1, aEnd, idx[CORNER_TEX]);
+					if (q < aEnd && *q == '/')
+						q = _parseInt(q + 1, aEnd, idx[CORNER_NORMAL]);
+				}
+				p = q;
+				relCur = 0;
+				for (int k=0; k<CORNER_SIZE; ++k)
+				{
+					cur[k] = _resolveIndex(idx[k], count[k]);
+					if (idx[k] < 0)
+						relCur |= 1 << k;
+				}
+
+				if (numCorners == 0)
+				{
+					memcpy(first, cur, sizeof(cur));
+					relFirst = relCur;
+				}
+				else if (numCorners >= 2)
+				{
+					_addCorner(chunk, first, relFirst);
+					_addCorner(chunk, prev, relPrev);
+					_addCorner(chunk, cur, relCur);
+					chunk.mTriMaterials.push_back(material);
+				}
+				memcpy(prev, cur, sizeof(cur));
+				relPrev = relCur;
+				++numCorners;
+			}
+		}
+		else if (_isKeyword(p, aEnd, "usemtl") || _isKeyword(p, aEnd, "mtllib"))
+		{
+			// the names are looked up by _merge(), in the order of the file
+			stmt.mLibrary = (c == 'm');
+			p = _parseWord(p + 6, aEnd, stmt.mName);
+			if (!stmt.mLibrary)
+				material = static_cast<int>(chunk.mStatements.size());
+			chunk.mStatements.push_back(stmt);
+		}
+		// comments, groups, smoothing groups etc. are skipped
+		p = _skipLine(p, aEnd);
+	}
+}
+
+void ObjFile::_addCorner(Chunk& aChunk, const int* aCorner, int aRelative)
+{
+	const int slot = static_cast<int>(aChunk.mCorners.size());
+	for (int k=0; aRelative && k<CORNER_SIZE; ++k)
+	{
+		if (aRelative & (1 << k))
+			aChunk.mRelative.push_back(slot + k);
+	}
+	aChunk.mCorners.insert(aChunk.mCorners.end(), aCorner, aCorner + CORNER_SIZE);
+}
+
+void ObjFile::_merge(std::vector<Chunk>& aChunks, const String& aDir, ThreadPool* aPool)
+{
+	// the material statements take effect in the order of the file
+	int material = 0;
+	size_t numPos = 0, numNorm = 0, numTex = 0, numCorners = 0;
+	size_t i;
+	for (i=0; i<aChunks.size(); ++i)
+	{
+		Chunk &chunk = aChunks[i];
+		chunk.mMaterialBefore = material;
+		chunk.mMaterials.resize(chunk.mStatements.size(), 0);
+		for (size_t j=0; j<chunk.mStatements.size(); ++j)
+		{
+			const Chunk::Statement &stmt = chunk.mStatements[j];
+			if (stmt.mLibrary)
+			{
+				mLibraries.push_back(aDir + stmt.mName);
+				_loadMtl(mLibraries.back(), aDir);
+			}
+			else
+				chunk.mMaterials[j] = material = _findMaterial(stmt.mName);
+		}
+
+		// prefix sums of the element counts
+		chunk.mFirstPosition = numPos;
+		chunk.mFirstNormal = numNorm;
+		chunk.mFirstTexCoord = numTex;
+		chunk.mFirstCorner = numCorners;
+		chunk.mNumTriangles = chunk.mTriMaterials.size();
+		numPos += chunk.mPositions.size();
+		numNorm += chunk.mNormals.size();
+		numTex += chunk.mTexCoords.size();
+		numCorners += chunk.mCorners.size();
+	}
+
+	if (aChunks.size() == 1)
+	{
+		// nothing to copy, the indices are only resolved
+		Chunk &chunk = aChunks[0];
+		mPositions.swap(chunk.mPositions);
+		mNormals.swap(chunk.mNormals);
+		mTexCoords.swap(chunk.mTexCoords);
+		mCorners.swap(chunk.mCorners);
+		mTriMaterials.swap(chunk.mTriMaterials);
+		_mergeChunk(&chunk, 0);
+		return;
+	}
+
+	mPositions.resize(numPos);
+	mNormals.resize(numNorm);
+	mTexCoords.resize(numTex);
+	mCorners.resize(numCorners);
+	mTriMaterials.resize(numCorners / (3 * CORNER_SIZE));
+	for (i=0; i<aChunks.size(); ++i)
+	{
+		if (aPool)
+			aPool->submit(std::bind(&ObjFile::_mergeChunk, this, &aChunks[i], std::placeholders::_1));
+		else
+			_mergeChunk(&aChunks[i], 0);
+	}
+	if (aPool)
+		aPool->wait();
+}
+
+/// copy the elements of the chunk to its place, its memory is freed
+template <typename T>
+static void _moveTo(std::vector<T>& aSrc, std::vector<T>& aDst, size_t aOffset)
+{
+	if (!aSrc.empty())
+		memcpy(&aDst[aOffset], &aSrc[0], aSrc.size() * sizeof(T));
+	std::vector<T>().swap(aSrc);
+}
+
+void ObjFile::_mergeChunk(Chunk* aChunk, int /*aWorker*/)
+{
+	Chunk &chunk = *aChunk;
+	const size_t firstTri = chunk.mFirstCorner / (3 * CORNER_SIZE);
+	_moveTo(chunk.mPositions, mPositions, chunk.mFirstPosition);
+	_moveTo(chunk.mNormals, mNormals, chunk.mFirstNormal);
+	_moveTo(chunk.mTexCoords, mTexCoords, chunk.mFirstTexCoord);
+	_moveTo(chunk.mCorners, mCorners, chunk.mFirstCorner);
+	_moveTo(chunk.mTriMaterials, mTriMaterials, firstTri);
+
+	// a relative index counts back from the elements before the chunk too
+	const int base[CORNER_SIZE] = {
+		static_cast<int>(chunk.mFirstPosition / 3),
+		static_cast<int>(chunk.mFirstTexCoord / 2),
+		static_cast<int>(chunk.mFirstNormal / 3)
+	};
+	for (size_t i=0; i<chunk.mRelative.size(); ++i)
+	{
+		const int slot = chunk.mRelative[i];
+		mCorners[chunk.mFirstCorner + slot] += base[slot % CORNER_SIZE];
+	}
+	for (size_t i=0; i<chunk.mNumTriangles; ++i)
+	{
+		int &material = mTriMaterials[firstTri + i];
+		material = material < 0 ? chunk.mMaterialBefore : chunk.mMaterials[material];
+	}
+}
+
+void ObjFile::_dropInvalid()
+{
+	// drop the triangles referring to missing elements
+	const int numPos = getNumOfPositions();
+	const int numTex = getNumOfTexCoords();
+	const int numNorm = getNumOfNormals();
+	size_t out = 0;
+	for (size_t tri=0; tri<mTriMaterials.size(); ++tri)
+	{
+		const int *corners = &mCorners[CORNER_SIZE * 3 * tri];
+		bool valid = true;
+		for (int k=0; k<3; ++k)
+		{
+			const int *corner = corners + CORNER_SIZE * k;
+			valid = valid && corner[CORNER_POS] >= 0 && corner[CORNER_POS] < numPos &&
+				corner[CORNER_TEX] >= -1 && corner[CORNER_TEX] < numTex && 
+				corner[CORNER_NORMAL] >= -1 && corner[CORNER_NORMAL] < numNorm;
+		}
+		if (!valid)
+			continue;
+		memmove(&mCorners[CORNER_SIZE * 3 * out], corners, CORNER_SIZE * 3 * sizeof(int));
+		mTriMaterials[out++] = mTriMaterials[tri];
+	}
+	mCorners.resize(CORNER_SIZE * 3 * out);
+	mTriMaterials.resize(out);
+}
+
+void ObjFile::_loadMtl(const String& aFilename, const String& aDir)
+{
+	MappedFile file;
+	if (!file.open(aFilename))
+	{
+		fprintf(stderr, "ObjFile: can not open material library %s\n", aFilename.c_str());
+		return;
+	}
+
+	// the first one is used by the faces before any usemtl
+	if (mMaterials.empty())
+	{
+		mMaterials.push_back(ObjMaterial());
+		mMaterials.back().mName = "default";
+	}
+
+	const char *p = file.getData();
+	const char *end = p + file.getSize();
+	ObjMaterial *mat = &mMaterials.back();
+	String word;
+	while (p < end)
+	{
+		p = _skipSpace(p, end);
+		if (_isKeyword(p, end, "newmtl"))
+		{
+			mMaterials.push_back(ObjMaterial());
+			mat = &mMaterials.back();
+			p = _parseWord(p + 6, end, mat->mName);
+		}
+		else if (_isKeyword(p, end, "Ns"))
+		{
+			// wavefront shininess is from [0, 1000]
+			p = _parseFloat(_skipSpace(p + 2, end), end, mat->mShininess);
+			mat->mShininess *= 128.0f / 1000.0f;
+		}
+		else if (p + 2 < end && p[0] == 'K' && _isSpace(p[2]))
+		{
+			float *color = 0;
+			switch (p[1])
+			{
+			case 'a': color = mat->mAmbient; break;
+			case 'd': color = mat->mDiffuse; break;
+			case 's': color = mat->mSpecular; break;
+			case 'e': color = mat->mEmissive; break;
+			}
+			for (int i=0; color && i<3; ++i)
+				p = _parseFloat(_skipSpace(p + (i == 0 ? 2 : 0), end), end, color[i]);
+		}
+		else if (_isKeyword(p, end, "map_Kd"))
+		{
+			p = _parseWord(p + 6, end, word);
+			const bool absolute = word.find(':') != String::npos || (!word.empty() && word[0] == '/');
+			mat->mTexture = absolute ? word : aDir + word;
+		}
+		p = _skipLine(p, end);
+	}
+}
+
+int ObjFile::_findMaterial(const String& aName) const
+{
+	for (size_t i=0; i<mMaterials.size(); ++i)
+	{
+		if (mMaterials[i].mName == aName)
+			return static_cast<int>(i);
+	}
+	return 0;
+}
+
+void ObjFile::assign(const trimeshVec::COBJmodel& aModel)
+{
+	clear();
+	unsigned int i, k;
+	// NOTE: the arrays of COBJmodel are 1 based
+	for (i=1; i<=aModel.nVertices; ++i)
+	{
+		const trimeshVec::CPoint3D &v = aModel.vpVertices[i];
+		mPositions.push_back(v.x);
+		mPositions.push_back(v.y);
+		mPositions.push_back(v.z);
+	}
+	for (i=1; aModel.vpNormals && i<=aModel.nNormals; ++i)
+	{
+		const trimeshVec::CPoint3D &n = aModel.vpNormals[i];
+		mNormals.push_back(n.x);
+		mNormals.push_back(n.y);
+		mNormals.push_back(n.z);
+	}
+	for (i=1; aModel.vpTexCoords && i<=aModel.nTexCoords; ++i)
+	{
+		const trimeshVec::CPoint3D &t = aModel.vpTexCoords[i];
+		mTexCoords.push_back(t.x);
+		mTexCoords.push_back(t.y);
+	}
+
+	mCorners.reserve(CORNER_SIZE * 3 * aModel.nTriangles);
+	mTriMaterials.reserve(aModel.nTriangles);
+	for (i=0; i<aModel.nTriangles; ++i)
+	{
+		const trimeshVec::COBJtriangle &tri = aModel.pTriangles[i];
+		for (k=0; k<3; ++k)
+		{
+			mCorners.push_back(static_cast<int>(tri.vindices[k]) - 1);
+			mCorners.push_back(aModel.vpTexCoords ? static_cast<int>(tri.tindices[k]) - 1 : -1);
+			mCorners.push_back(aModel.vpNormals ? static_cast<int>(tri.nindices[k]) - 1 : -1);
+		}
+		mTriMaterials.push_back(aModel.pMaterials ? tri.mindex : 0);
+	}
+
+	for (i=0; aModel.pMaterials && i<aModel.nMaterials; ++i)
+	{
+		const trimeshVec::COBJmaterial &src = aModel.pMaterials[i];
+		ObjMaterial mat;
+		mat.mName = src.name;
+		mat.mTexture = src.sTexture;
+		for (k=0; k<3; ++k)
+		{
+			mat.mAmbient[k] = src.ambient[k];
+			mat.mDiffuse[k] = src.diffuse[k];
+			mat.mSpecular[k] = src.specular[k];
+			mat.mEmissive[k] = src.emissive[k];
+		}
+		mat.mShininess = src.shininess[0];
+		mMaterials.push_back(mat);
+	}
+}
+
+void ObjFile::center()
+{
+	const int numPos = getNumOfPositions();
+	if (numPos == 0)
+		return;
+
+	float vmin[3], vmax[3];
+	for (int k=0; k<3; ++k)
+		vmin[k] = vmax[k] = mPositions[k];
+	for (int i=1; i<numPos; ++i)
+	{
+		const float *v = getPosition(i);
+		for (int k=0; k<3; ++k)
+		{
+			if (vmax[k] < v[k]) vmax[k] = v[k];
+			if (vmin[k] > v[k]) vmin[k] = v[k];
+		}
+	}
+
+	float cent[3];
+	for (int k=0; k<3; ++k)
+		cent[k] = (vmax[k] + vmin[k]) * 0.5f;
+	for (size_t i=0; i<mPositions.size(); ++i)
+		mPositions[i] -= cent[i % 3];
+}
+
+void ObjFile::generateNormals(float aAngle)
+{
+	using trimeshVec::CPoint3D;
+	const int numTris = getNumOfTriangles();
+	const int numPos = getNumOfPositions();
+
+	// NOTE: the same float arithmetic as CAccessObj::FacetNormals()
+	std::vector<CPoint3D> facets(numTris);
+	for (int tri=0; tri<numTris; ++tri)
+	{
+		const float *p0 = getPosition(getCorner(tri, 0)[CORNER_POS]);
+		const float *p1 = getPosition(getCorner(tri, 1)[CORNER_POS]);
+		const float *p2 = getPosition(getCorner(tri, 2)[CORNER_POS]);
+		CPoint3D v0(p0[0], p0[1], p0[2]);
+		CPoint3D u = CPoint3D(p1[0], p1[1], p1[2]) - v0;
+		CPoint3D v = CPoint3D(p2[0], p2[1], p2[2]) - v0;
+		facets[tri] = u * v;
+		facets[tri].unify();
+	}
+
+	// the corners around every position, in the order of the triangles
+	std::vector<int> first(numPos + 1, 0);
+	std::vector<int> around(3 * numTris);
+	int c;
+	for (c=0; c<3*numTris; ++c)
+		++first[mCorners[CORNER_SIZE * c + CORNER_POS] + 1];
+	for (int i=0; i<numPos; ++i)
+		first[i + 1] += first[i];
+	std::vector<int> cursor(first.begin(), first.end() - 1);
+	for (c=0; c<3*numTris; ++c)
+		around[cursor[mCorners[CORNER_SIZE * c + CORNER_POS]]++] = c;
+
+	// average the faces of a corner within the angle of its own face
+	const float cosAngle = static_cast<float>(cos(aAngle * 3.14159265 / 180.0));
+	mNormals.clear();
+	for (int pos=0; pos<numPos; ++pos)
+	{
+		const int firstNormal = getNumOfNormals();
+		for (int i=first[pos]; i<first[pos + 1]; ++i)
+		{
+			CPoint3D &facet = facets[around[i] / 3];
+			CPoint3D average(0.0f, 0.0f, 0.0f);
+			for (int j=first[pos]; j<first[pos + 1]; ++j)
+			{
+				CPoint3D &other = facets[around[j] / 3];
+				if ((facet & other) > cosAngle)
+					average += other;
+			}
+			average.unify();
+
+			int n = firstNormal;
+			for (; n<getNumOfNormals(); ++n)
+			{
+				const float *normal = getNormal(n);
+				if (normal[0] == average.x && normal[1] == average.y && normal[2] == average.z)
+					break;
+			}
+			if (n == getNumOfNormals())
+			{
+				mNormals.push_back(average.x);
+				mNormals.push_back(average.y);
+				mNormals.push_back(average.z);
+			}
+			mCorners[CORNER_SIZE * around[i] + CORNER_NORMAL] = n;
+		}
+	}
+}
+
+}; // namespace RayTracer
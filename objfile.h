@@ -0,0 +1,136 @@
+/********************************************************************
+	created:	2026/10/17
+	file name:	objfile.h
+	author:		maxint lnychina@gmail.com
+*********************************************************************/
+
+#ifndef _RT_OBJFILE_H_
+#define _RT_OBJFILE_H_
+
+#include "common.h"
+#include <vector>
+
+namespace trimeshVec{
+	class COBJmodel;
+}
+
+namespace RayTracer {
+
+class ThreadPool;
+
+/// A material of the .mtl library, defaults as CAccessObj::ReadMTL
+class ObjMaterial
+{
+public:
+	ObjMaterial();
+
+	String mName;
+	String mTexture;		// path of the diffuse map, empty without
+	float mAmbient[3];
+	float mDiffuse[3];
+	float mSpecular[3];
+	float mEmissive[3];
+	float mShininess;		// scaled to [0, 128]
+};
+
+// ------------------------------------------------------------------------------
+// Wavefront OBJ file in flat arrays
+// ------------------------------------------------------------------------------
+
+/**	Reads an OBJ file in one pass over the memory mapped text. The text is
+	cut into chunks at line breaks which are parsed in parallel and joined
+	in order. Polygons are split into triangle fans and the indices are 0
+	based, a relative index refers back from the elements read so far.
+	Every triangle corner has a position, a texture coordinate and a normal
+	index, -1 for none.
+ */
+class ObjFile
+{
+public:
+	/// index of the attributes in a corner
+	enum Corner
+	{
+		CORNER_POS		= 0,
+		CORNER_TEX		= 1,
+		CORNER_NORMAL	= 2,
+		CORNER_SIZE		= 3
+	};
+
+	ObjFile();
+
+	/**	Read a model and its material library, centered at the origin as
+		CAccessObj does. Without normals in the file, vertex normals are
+		generated as CAccessObj::UnifiedModel does, smoothing across the
+		edges under 90 degrees.
+	\param
+		aNumThreads	parsing threads, 0 means one per hardware thread
+	\return
+		false if the file can not be read, the object is cleared then
+	 */
+	bool load(const String& aFilename, int aNumThreads = 0);
+
+	/**	Copy a model read by CAccessObj
+	 */
+	void assign(const trimeshVec::COBJmodel& aModel);
+
+	void clear();
+
+	int getNumOfTriangles() const		{ return static_cast<int>(mTriMaterials.size()); }
+	int getNumOfPositions() const		{ return static_cast<int>(mPositions.size() / 3); }
+	int getNumOfNormals() const			{ return static_cast<int>(mNormals.size() / 3); }
+	int getNumOfTexCoords() const		{ return static_cast<int>(mTexCoords.size() / 2); }
+	int getNumOfMaterials() const		{ return static_cast<int>(mMaterials.size()); }
+
+	/// x, y, z of position i
+	const float* getPosition(int i) const	{ return &mPositions[3 * i]; }
+	/// x, y, z of normal i
+	const float* getNormal(int i) const		{ return &mNormals[3 * i]; }
+	/// u, v of texture coordinate i
+	const float* getTexCoord(int i) const	{ return &mTexCoords[2 * i]; }
+	/// CORNER_SIZE indices of corner 0~2 of triangle i
+	const int* getCorner(int i, int aCorner) const	{ return &mCorners[CORNER_SIZE * (3 * i + aCorner)]; }
+	/// material of triangle i, 0 without a material library
+	int getMaterialIndex(int i) const		{ return mTriMaterials[i]; }
+	const ObjMaterial& getMaterial(int i) const	{ return mMaterials[i]; }
+	/// paths of the mtllib statements in the order of the file, also of
+	/// the libraries that were not found
+	const std::vector<String>& getMaterialLibs() const	{ return mLibraries; }
+
+	/**	Move the center of the bounding box to the origin, as
+		CAccessObj::CalcBoundingBox does
+	 */
+	void center();
+
+	/**	Replace the normals by the average of the face normals around each
+		vertex, the faces more than @aAngle degrees away are left out.
+		Equal normals of a vertex are stored once.
+	 */
+	void generateNormals(float aAngle);
+
+private:
+	struct Chunk;
+
+	static void _parseChunk(Chunk* aChunk, int aWorker);
+	static void _addCorner(Chunk& aChunk, const int* aCorner, int aRelative);
+	/**	Look up the materials and copy the chunks to the arrays, the
+		indices of a chunk are offset by the elements before it
+	 */
+	void _merge(std::vector<Chunk>& aChunks, const String& aDir, ThreadPool* aPool);
+	void _mergeChunk(Chunk* aChunk, int aWorker);
+	void _dropInvalid();
+	void _loadMtl(const String& aFilename, const String& aDir);
+	int _findMaterial(const String& aName) const;
+
+private:
+	std::vector<float> mPositions;
+	std::vector<float> mNormals;
+	std::vector<float> mTexCoords;
+	std::vector<int> mCorners;
+	std::vector<int> mTriMaterials;
+	std::vector<ObjMaterial> mMaterials;
+	std::vector<String> mLibraries;
+};
+
+}; // namespace RayTracer
+
+#endif // _RT_OBJFILE_H_
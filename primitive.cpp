@@ -1,450 +1,739 @@
-/********************************************************************
-	created:	2010/04/22
-	file name:	primitive.cpp
-	author:		maxint lnychina@gmail.com
-*********************************************************************/
-
-#include "primitive.h"
-#include "material.h"
-#include "raytracer.h"
-
-namespace RayTracer {
-
-using std::min;
-using std::max;
-using std::abs;
-
-static const int MODULO3[] = { 0, 1, 2, 0, 1 };
-
-// ------------------------------------------------------------------------------
-// Primitive class implementation
-// ------------------------------------------------------------------------------
-
-Primitive::Primitive()
-: mName("")
-, mIsLight(false)
-, mAABB(Vec3::ZERO, Vec3::ZERO)
-, mRayID(-1)
-, mMaterial(NULL)
-{
-	mMaterial = MaterialManager::getInstance().getMaterial("_default_");
-}
-
-
-Primitive::~Primitive() 
-{ 
-}
-
-void Primitive::setMaterial(const String& matName)
-{
-	mMaterial = MaterialManager::getInstance().getMaterial(matName);
-}
-
-Color Primitive::getColor(const Vec3& aIP) const
-{
-	if (!mMaterial->isTexture())
-	{
-		return mMaterial->getDiffuse();
-	}
-	else
-	{
-		Real u, v;
-		getTextureCoord(u, v, aIP);
-		u *= mMaterial->getUScale();
-		v *= mMaterial->getVScale();
-		return mMaterial->getTexture()->getTexel(u, v) * mMaterial->getDiffuse();
-	}
-}
-
-// ------------------------------------------------------------------------------
-// Sphere primitive methods
-// ------------------------------------------------------------------------------
-
-RTResult Sphere::intersect(const Ray& aRay, Real& aDist)
-{
-	mRayID = aRay.getID();
-
-	Vec3 v = mCentre - aRay.getOrigin();
-	Real b = v.Dot(aRay.getDir());
-	Real a2 = v.SqrLength() - (b * b); // ֱĵľ
-	Real det = mSqrRadius - a2; // ڽؾ
-	RTResult retval = MISS;
-	if (det > 0)
-	{ // ཻ
-		det = std::sqrt(det);
-		Real i1 = b - det; /*  near intersection
-								positive if outside sphere
-								negative if inside sphere
-								*/
-		Real i2 = b + det; /*	far intersection
-								positive if ray is toward or inside sphere
-								negative if ray is backward sphere
-								*/
-		if (i2 > 0)
-		{
-			if (i1 < 0)
-			{ // inner
-				if (i2 < aDist)
-				{ // СԤֵ
-					aDist = i2;
-					retval = INPRIM;
-				}
-			}
-			else
-			{
-				if (i1 < aDist)
-				{
-					aDist = i1;
-					retval = HIT;
-				}
-			}
-		}
-	}
-	return retval;
-}
-
-bool Sphere::intersetBox(const AABB& aBox) const
-{
-	const Vec3 &v1 = aBox.getMin(), &v2 = aBox.getMax();
-	Real dmin = 0;
-
-	for (int i=0; i<3; ++i)
-	{
-		if (mCentre[i] < v1[i])
-		{
-			dmin += (mCentre[i] - v1[i]) * (mCentre[i] - v1[i]);
-		}
-		else if (mCentre[i] > v2[i])
-		{
-			dmin += (mCentre[i] - v2[i]) * (mCentre[i] - v2[i]);
-		}
-	}
-	return (dmin <= mSqrRadius);
-}
-
-void Sphere::getTextureCoord(Real& u, Real& v, const Vec3& aIP) const
-{
-	Vec3 vp = (aIP - mCentre) * mRRadius;
-	Real phi = acos( static_cast<Real>(RT_CLAMP(vp.Dot(Vec3::UNIT_Y), -1.0f, 1.0f)) );
-	v = phi * (1.0f / RT_PI);
-	Real theta = acos( static_cast<Real>(RT_CLAMP(vp.Dot(Vec3::UNIT_X) / sin(phi), -1.0f, 1.0f)) ) * 0.5f / RT_PI;
-	if (vp.Dot(Vec3::UNIT_Z) >= 0)
-		u = (1.0f - theta);
-	else 
-		u = theta;
-}
-
-// ------------------------------------------------------------------------------
-// Plane primitive class implementation
-// ------------------------------------------------------------------------------
-
-PlanePrim::PlanePrim(const Vec3& aNormal, Real aDist)
-: mPlane(aNormal, aDist)
-, mUAxis(aNormal.y, aNormal.z, -aNormal.x)
-{
-	mAABB = AABB(-10000 * Vec3::ONE, 10000 * Vec3::ONE);
-	mVAxis = mUAxis.Cross(aNormal);
-}
-
-RTResult PlanePrim::intersect(const Ray& aRay, Real& aDist)
-{
-	mRayID = aRay.getID();
-
-	Real d = mPlane.N.Dot(aRay.getDir()); // negative
-	if (d < 0)
-	{ // ƽҷϳ
-		Real dist = -( mPlane.N.Dot(aRay.getOrigin()) + mPlane.D) / d;
-		if (dist > 0 && dist < aDist)
-		{
-			aDist = dist;
-			return HIT;
-		}
-	}
-	return MISS;
-}
-
-bool PlanePrim::intersetBox(const AABB& aBox) const
-{
-	int side1 = 0, side2 = 0;
-	const Vec3 *v[2];
-	v[0] = &(aBox.getMin()); v[1] = &(aBox.getMax());
-	// 8㶼ƽͬһཻཻ
-	for (int i=0; i<8; ++i)
-	{
-		if (Vec3(v[i&1]->x, v[(i>>1)&1]->y, v[(i>>2)&1]->z).Dot(mPlane.N) + mPlane.D < 0)
-			++side1;
-		else
-			++side2;
-	}
-	return !(side1 == 0 || side2 == 0);
-}
-
-void PlanePrim::getTextureCoord(Real &u, Real &v, const RayTracer::Vec3 &aIP) const
-{
-	u = aIP.Dot(mUAxis);
-	v = aIP.Dot(mVAxis);
-}
-
-// ------------------------------------------------------------------------------
-// Axis aligned box class implementation
-// ------------------------------------------------------------------------------
-
-RTResult Box::intersect(const Ray& aRay, Real& aDist)
-{
-	mRayID = aRay.getID();
-
-	Real dist[6]; // ƽľ
-	RTResult retval = MISS;
-	int i;
-	for (i = 0; i < 6; ++i ) dist[i] = -1;
-	Vec3 v1 = mAABB.getMin(), v2 = mAABB.getMax();
-	Vec3 d = aRay.getDir(), o = aRay.getOrigin();
-	if (d.x) 
-	{
-		Real rc = 1.0f / d.x;
-		dist[0] = (v1.x - o.x) * rc;
-		dist[1] = (v2.x - o.x) * rc;
-	}
-	if (d.y) 
-	{
-		Real rc = 1.0f / d.y;
-		dist[2] = (v1.y - o.y) * rc;
-		dist[3] = (v2.y - o.y) * rc;
-	}
-	if (d.z) 
-	{
-		Real rc = 1.0f / d.z;
-		dist[4] = (v1.z - o.z) * rc;
-		dist[5] = (v2.z - o.z) * rc;
-	}
-	Vec3 ip;
-	for (i = 0; i < 6; i++ ) if (dist[i] > 0)
-	{
-		ip = o + dist[i] * d; // ڸƽϵĽ
-		if (dist[i] < aDist &&
-			ip > (v1 - RT_EPSILON) &&
-			ip < (v2 + RT_EPSILON)
-			)
-		{
-			aDist = dist[i];
-			retval = HIT;
-		}
-	}
-	if (retval == HIT && mAABB.contains(o))
-	{
-		retval = INPRIM;
-	}
-	return retval;
-}
-
-const Vec3& Box::getNormal(const Vec3& aPos)
-{
-	Real tDist[6];
-	tDist[0] = abs(aPos.x - mAABB.getMin().x);
-	tDist[1] = abs(aPos.y - mAABB.getMin().y);
-	tDist[2] = abs(aPos.z - mAABB.getMin().z);
-	tDist[3] = abs(aPos.x - mAABB.getMax().x);
-	tDist[4] = abs(aPos.y - mAABB.getMax().y);
-	tDist[5] = abs(aPos.z - mAABB.getMax().z);
-
-	int best = 0, i;
-	Real bdist = tDist[0];
-	for (i=1; i<6; ++i) if (tDist[i] < bdist)
-	{
-		bdist = tDist[i];
-		best = i;
-	}
-	mNormal = Vec3::ZERO;
-	if (best == 0) mNormal.x = -1;
-	if (best == 1) mNormal.y = -1;
-	if (best == 2) mNormal.z = -1;
-	if (best == 3) mNormal.x = 1;
-	if (best == 4) mNormal.y = 1;
-	if (best == 5) mNormal.z = 1;
-
-	return mNormal;
-}
-
-// ------------------------------------------------------------------------------
-// Triangle primitive class implementation
-// ------------------------------------------------------------------------------
-
-TrianglePrim::TrianglePrim(Vertex* v1, Vertex* v2, Vertex* v3, bool genNorm)
-{
-	mVertices[0] = v1;
-	mVertices[1] = v2;
-	mVertices[2] = v3;
-
-	// precalculate
-	Vec3 b = v2->mPos - v1->mPos;
-	Vec3 c = v3->mPos - v1->mPos;
-	mN = b.Cross(c);
-	mN.Normalize();
-	Vec3 Nabs = mN;
-	Nabs.Abs();
-	if (Nabs.x > Nabs.y && Nabs.x > Nabs.z)
-		mMajorAxis = 0;
-	else if (Nabs.y > Nabs.x && Nabs.y > Nabs.z)
-		mMajorAxis = 1;
-	else
-		mMajorAxis = 2;
-	
-	int u = MODULO3[mMajorAxis + 1];
-	int v = MODULO3[mMajorAxis + 2];
-	Real krec = 1.0f / (b.cell[u] * c.cell[v] - b.cell[v] * c.cell[u]);
-	mBx = c.cell[v] * krec;
-	mBy = -c.cell[u] * krec;
-	mCx = -b.cell[v] * krec;
-	mCy = b.cell[u] * krec;
-
-	// AABB
-	Vec3 vMin(v1->mPos), vMax(v1->mPos);
-	vMin.Min(v2->mPos);
-	vMin.Min(v3->mPos);
-	vMax.Max(v2->mPos);
-	vMax.Max(v3->mPos);
-	mAABB.setMin(vMin);
-	mAABB.setMax(vMax);
-
-	// set normals
-	if (genNorm)
-	{
-		v1->mNormal = mN;
-		v2->mNormal = mN;
-		v3->mNormal = mN;
-	}
-}
-
-RTResult TrianglePrim::intersect(const Ray& aRay, Real& aDist)
-{
-	mRayID = aRay.getID();
-
-	const Vec3& O = aRay.getOrigin();
-	const Vec3& D = aRay.getDir();
-	Real dist = mN.Dot(D);
-	if (dist < 0)
-	{ // ƽҷϳ
-		dist = mN.Dot(mVertices[0]->mPos-O) / dist;
-		if (!(dist > 0 && dist < aDist))
-			return MISS;
-		
-		// жϽǷ
-		Vec3 hit = O + D * dist - mVertices[0]->mPos;
-		int u = MODULO3[mMajorAxis + 1];
-		int v = MODULO3[mMajorAxis + 2];
-		mBaryCoord[1] = hit.cell[u] * mBx + hit.cell[v] * mBy;
-		if (mBaryCoord[1] < 0) return MISS;
-		mBaryCoord[2] = hit.cell[u] * mCx + hit.cell[v] * mCy;
-		if (mBaryCoord[2] < 0) return MISS;
-		mBaryCoord[0] = 1 - mBaryCoord[1] -mBaryCoord[2];
-		if (mBaryCoord[0] < 0) return MISS;
-		//Vec3 test = Vec3::ZERO;
-		//for (int i=0; i<3; ++i)
-		//{
-		//	test += mBaryCoord[i] * mVertices[i]->mPos;
-		//}
-		//test -= mVertices[0]->mPos;
-		aDist = dist;
-		return HIT;
-	}
-	return MISS;
-}
-
-bool TrianglePrim::intersetBox(const AABB &aBox) const
-{
-	Vec3 halfDim = 0.5f * aBox.getDim();
-	Vec3 centre = aBox.getMin() + halfDim;
-	Vec3 v[3], e[3], sv;
-	int i, j;
-	int side;
-	for (i=0; i<3; ++i)
-	{
-		v[i] = mVertices[i]->mPos - centre;
-		e[i] = mVertices[MODULO3[i]]->mPos - mVertices[MODULO3[i+1]]->mPos;
-		e[i].Normalize();
-
-	}
-	// ڷᶨAABB㷨3+1+913
-	// AABB 
-	// AABB 3
-	sv = Vec3::ZERO;
-	for (i=0; i<3; ++i)
-	{ // each axis
-		side = 0;
-		for (j=0; j<3; ++j)
-		{ // each vertex
-			if (v[j].cell[i] > halfDim[i])
-				++side;
-			else if (v[j].cell[i] < -halfDim[i])
-				--side;
-			else
-				++sv[i];
-		}
-		if (side == -3 || side == 3) return false;
-	}
-	for (i=0; i<3; ++i) if (sv[i] == 3)
-		return true;
-
-	// η
-	Vec3 norm = e[0].Cross(e[1]);
-	Real d2tri = abs(norm.Dot(v[0]));
-	Real d2r = 0;
-	for (i=0; i<3; ++i)
-	{
-		d2r += ( (norm.cell[i]<0) ? -1 : 1 ) * norm.cell[i] * halfDim.cell[i];
-	}
-	if (d2tri > d2r) return false;
-	
-	// 9ַ
-	Real d2tri2;
-	for (i=0; i<3; ++i)
-	{// each axis
-		for (j=0; j<3; ++j)
-		{// each edge
-			norm = Vec3::ZERO;
-			norm[i] = 1;
-			if (abs(norm.Dot(e[j])) > 1.0 - RT_EPSILON)
-			{
-				continue;
-			}
-			norm = norm.Cross(e[j]);
-			d2tri = abs(norm.Dot(v[i]));
-			d2tri2 = abs(norm.Dot(v[MODULO3[i+2]]));
-			d2tri = min(d2tri, d2tri2);
-			Real d2r = 0;
-			for (i=0; i<0; ++i)
-				d2r += ( (norm.cell[i]<0) ? -1 : 1 ) * norm.cell[i] * halfDim.cell[i];
-			if (d2tri > d2r) return false;
-		}
-	}
-
-	return true;
-}
-
-const Vec3& TrianglePrim::getNormal(const Vec3 &)
-{
-	mNormal = Vec3::ZERO;
-	for (int i=0; i<3; ++i)
-	{
-		mNormal += mBaryCoord[i] * mVertices[i]->mNormal;
-	}
-	mNormal.Normalize();
-	return mNormal;
-}
-
-void TrianglePrim::getTextureCoord(Real &u, Real &v, const Vec3&) const
-{
-	u = v = 0;
-	for (int i=0; i<3; ++i)
-	{
-		u += mBaryCoord[i] * mVertices[i]->mU;
-		v += mBaryCoord[i] * mVertices[i]->mV;
-	}
-}
-
-// ------------------------------------------------------------------------------
-// Light class implementation
-// ------------------------------------------------------------------------------
-
-
+/********************************************************************
+	created:	2010/04/22
+	file name:	primitive.cpp
+	author:		maxint lnychina@gmail.com
+*********************************************************************/
+
+#include "primitive.h"
+#include "material.h"
+#include "raytracer.h"
+
+namespace RayTracer {
+
+using std::min;
+using std::max;
+using std::abs;
+
+static const int MODULO3[] = { 0, 1, 2, 0, 1 };
+
+// ------------------------------------------------------------------------------
+// Primitive class implementation
+// ------------------------------------------------------------------------------
+
+Primitive::Primitive()
+: mMaterial(NULL)
+, mIndex(-1)
+, mIsLight(false)
+{
+	mMaterial = MaterialManager::getInstance().getMaterial("_default_");
+}
+
+Primitive::Primitive(Material* aMaterial)
+: mMaterial(aMaterial)
+, mIndex(-1)
+, mIsLight(false)
+{
+}
+
+
+Primitive::~Primitive() 
+{ 
+}
+
+void Primitive::setMaterial(const String& matName)
+{
+	mMaterial = MaterialManager::getInstance().getMaterial(matName);
+}
+
+int Primitive::intersectPacket(const RayPacket& aPacket, PacketHit& aHit, int aMask) const
+{
+	int hitMask = 0;
+	HitRecord hit;
+	for (int i=0; i<RayPacket::SIZE; ++i) if (aMask & (1 << i))
+	{
+		aHit.getHit(i, hit);
+		if (intersect(aPacket.getRay(i), hit) != MISS)
+		{
+			aHit.setHit(i, hit);
+			hitMask |= 1 << i;
+		}
+	}
+	return hitMask;
+}
+
+Occlusion Primitive::getOcclusion() const
+{
+	if (mIsLight)
+		return OC_NONE;
+	return mMaterial->isRefraction() ? OC_TRANSLUCENT : OC_OPAQUE;
+}
+
+Color Primitive::getColor(const HitRecord& aHit, const Vec3& aIP) const
+{
+	if (!mMaterial->isTexture())
+	{
+		return mMaterial->getDiffuse();
+	}
+	else
+	{
+		Real u, v;
+		getTextureCoord(u, v, aHit, aIP);
+		u *= mMaterial->getUScale();
+		v *= mMaterial->getVScale();
+		return mMaterial->getTexture()->getTexel(u, v) * mMaterial->getDiffuse();
+	}
+}
+
+// ------------------------------------------------------------------------------
+// Sphere primitive methods
+// ------------------------------------------------------------------------------
+
+RTResult Sphere::intersect(const Ray& aRay, HitRecord& aHit) const
+{
+	Vec3 v = mCentre - aRay.getOrigin();
+	Real b = v.Dot(aRay.getDir());
+	Real a2 = v.SqrLength() - (b * b); // 直线与球心的距离
+	Real det = mSqrRadius - a2; // 内截径
+	RTResult retval = MISS;
+	if (det > 0)
+	{ // 相交
+		det = std::sqrt(det);
+		Real i1 = b - det; /*  near intersection
+								positive if outside sphere
+								negative if inside sphere
+								*/
+		Real i2 = b + det; /*	far intersection
+								positive if ray is toward or inside sphere
+								negative if ray is backward sphere
+								*/
+		if (i2 > 0)
+		{
+			if (i1 < 0)
+			{ // inner
+				if (i2 < aHit.mDist)
+				{ // 小于预设值
+					aHit.mDist = i2;
+					retval = INPRIM;
+				}
+			}
+			else
+			{
+				if (i1 < aHit.mDist)
+				{
+					aHit.mDist = i1;
+					retval = HIT;
+				}
+			}
+		}
+	}
+	if (retval != MISS)
+	{
+		aHit.mPrim = this;
+		aHit.mResult = retval;
+	}
+	return retval;
+}
+
+bool Sphere::intersetBox(const AABB& aBox) const
+{
+	const Vec3 &v1 = aBox.getMin(), &v2 = aBox.getMax();
+	Real dmin = 0;
+
+	for (int i=0; i<3; ++i)
+	{
+		if (mCentre[i] < v1[i])
+		{
+			dmin += (mCentre[i] - v1[i]) * (mCentre[i] - v1[i]);
+		}
+		else if (mCentre[i] > v2[i])
+		{
+			dmin += (mCentre[i] - v2[i]) * (mCentre[i] - v2[i]);
+		}
+	}
+	return (dmin <= mSqrRadius);
+}
+
+void Sphere::getTextureCoord(Real& u, Real& v, const HitRecord& , const Vec3& aIP) const
+{
+	Vec3 vp = (aIP - mCentre) * mRRadius;
+	Real phi = acos( static_cast<Real>(RT_CLAMP(vp.Dot(Vec3::UNIT_Y), -1.0f, 1.0f)) );
+	v = phi * (1.0f / RT_PI);
+	Real theta = acos( static_cast<Real>(RT_CLAMP(vp.Dot(Vec3::UNIT_X) / sin(phi), -1.0f, 1.0f)) ) * 0.5f / RT_PI;
+	if (vp.Dot(Vec3::UNIT_Z) >= 0)
+		u = (1.0f - theta);
+	else 
+		u = theta;
+}
+
+// ------------------------------------------------------------------------------
+// Plane primitive class implementation
+// ------------------------------------------------------------------------------
+
+PlanePrim::PlanePrim(const Vec3& aNormal, Real aDist)
+: mPlane(aNormal, aDist)
+, mUAxis(aNormal.y, aNormal.z, -aNormal.x)
+{
+	mAABB = AABB(-10000 * Vec3::ONE, 10000 * Vec3::ONE);
+	mVAxis = mUAxis.Cross(aNormal);
+}
+
+RTResult PlanePrim::intersect(const Ray& aRay, HitRecord& aHit) const
+{
+	Real d = mPlane.N.Dot(aRay.getDir()); // negative
+	if (d < 0)
+	{ // 不平行且符合朝向
+		Real dist = -( mPlane.N.Dot(aRay.getOrigin()) + mPlane.D) / d;
+		if (dist > 0 && dist < aHit.mDist)
+		{
+			aHit.mDist = dist;
+			aHit.mPrim = this;
+			aHit.mResult = HIT;
+			return HIT;
+		}
+	}
+	return MISS;
+}
+
+bool PlanePrim::intersetBox(const AABB& aBox) const
+{
+	int side1 = 0, side2 = 0;
+	const Vec3 *v[2];
+	v[0] = &(aBox.getMin()); v[1] = &(aBox.getMax());
+	// 如果8个顶点都在平面同一侧则不相交，否则相交
+	for (int i=0; i<8; ++i)
+	{
+		if (Vec3(v[i&1]->x, v[(i>>1)&1]->y, v[(i>>2)&1]->z).Dot(mPlane.N) + mPlane.D < 0)
+			++side1;
+		else
+			++side2;
+	}
+	return !(side1 == 0 || side2 == 0);
+}
+
+void PlanePrim::getTextureCoord(Real &u, Real &v, const HitRecord& , const Vec3 &aIP) const
+{
+	u = aIP.Dot(mUAxis);
+	v = aIP.Dot(mVAxis);
+}
+
+// ------------------------------------------------------------------------------
+// Axis aligned box class implementation
+// ------------------------------------------------------------------------------
+
+RTResult Box::intersect(const Ray& aRay, HitRecord& aHit) const
+{
+	Real dist[6]; // 到各平面的距离
+	RTResult retval = MISS;
+	int i;
+	for (i = 0; i < 6; ++i ) dist[i] = -1;
+	Vec3 v1 = mAABB.getMin(), v2 = mAABB.getMax();
+	Vec3 d = aRay.getDir(), o = aRay.getOrigin();
+	if (d.x) 
+	{
+		Real rc = 1.0f / d.x;
+		dist[0] = (v1.x - o.x) * rc;
+		dist[1] = (v2.x - o.x) * rc;
+	}
+	if (d.y) 
+	{
+		Real rc = 1.0f / d.y;
+		dist[2] = (v1.y - o.y) * rc;
+		dist[3] = (v2.y - o.y) * rc;
+	}
+	if (d.z) 
+	{
+		Real rc = 1.0f / d.z;
+		dist[4] = (v1.z - o.z) * rc;
+		dist[5] = (v2.z - o.z) * rc;
+	}
+	Vec3 ip;
+	Real tDist = aHit.mDist;
+	for (i = 0; i < 6; i++ ) if (dist[i] > 0)
+	{
+		ip = o + dist[i] * d; // 在各平面上的交点
+		if (dist[i] < tDist &&
+			ip > (v1 - RT_EPSILON) &&
+			ip < (v2 + RT_EPSILON)
+			)
+		{
+			tDist = dist[i];
+			retval = HIT;
+		}
+	}
+	if (retval == HIT)
+	{
+		if (mAABB.contains(o))
+			retval = INPRIM;
+		aHit.mDist = tDist;
+		aHit.mPrim = this;
+		aHit.mResult = retval;
+	}
+	return retval;
+}
+
+Vec3 Box::getNormal(const HitRecord& , const Vec3& aPos) const
+{
+	Real tDist[6];
+	tDist[0] = abs(aPos.x - mAABB.getMin().x);
+	tDist[1] = abs(aPos.y - mAABB.getMin().y);
+	tDist[2] = abs(aPos.z - mAABB.getMin().z);
+	tDist[3] = abs(aPos.x - mAABB.getMax().x);
+	tDist[4] = abs(aPos.y - mAABB.getMax().y);
+	tDist[5] = abs(aPos.z - mAABB.getMax().z);
+
+	int best = 0, i;
+	Real bdist = tDist[0];
+	for (i=1; i<6; ++i) if (tDist[i] < bdist)
+	{
+		bdist = tDist[i];
+		best = i;
+	}
+	Vec3 normal = Vec3::ZERO;
+	if (best == 0) normal.x = -1;
+	if (best == 1) normal.y = -1;
+	if (best == 2) normal.z = -1;
+	if (best == 3) normal.x = 1;
+	if (best == 4) normal.y = 1;
+	if (best == 5) normal.z = 1;
+
+	return normal;
+}
+
+// ------------------------------------------------------------------------------
+// Triangle primitive class implementation
+// ------------------------------------------------------------------------------
+
+TrianglePrim::TrianglePrim(const TriangleMesh* aMesh, Material* aMaterial)
+: Primitive(aMaterial)
+, mMajorAxis(2)
+, mMesh(aMesh)
+, mN(Vec3::ZERO)
+, mBx(0), mBy(0), mCx(0), mCy(0)
+{
+}
+
+AABB TrianglePrim::getAABB() const
+{
+	const Vec3 &v1 = getVertex(0), &v2 = getVertex(1), &v3 = getVertex(2);
+	Vec3 vMin(v1), vMax(v1);
+	vMin.Min(v2);
+	vMin.Min(v3);
+	vMax.Max(v2);
+	vMax.Max(v3);
+	return AABB(vMin, vMax);
+}
+
+RTResult TrianglePrim::intersect(const Ray& aRay, HitRecord& aHit) const
+{
+	const Vec3& O = aRay.getOrigin();
+	const Vec3& D = aRay.getDir();
+	Real dist = mN.Dot(D);
+	if (dist < 0)
+	{ // 不平行且符合朝向
+		const Vec3 &p0 = getVertex(0);
+		dist = mN.Dot(p0-O) / dist;
+		if (!(dist > 0 && dist < aHit.mDist))
+			return MISS;
+		
+		// 质心坐标判断交点是否在三角形中
+		Vec3 hit = O + D * dist - p0;
+		int u = MODULO3[mMajorAxis + 1];
+		int v = MODULO3[mMajorAxis + 2];
+		Real beta = hit.cell[u] * mBx + hit.cell[v] * mBy;
+		if (beta < 0) return MISS;
+		Real gamma = hit.cell[u] * mCx + hit.cell[v] * mCy;
+		if (gamma < 0) return MISS;
+		Real alpha = 1 - beta - gamma;
+		if (alpha < 0) return MISS;
+		aHit.mDist = dist;
+		aHit.mPrim = this;
+		aHit.mBaryCoord.Set(alpha, beta, gamma);
+		aHit.mResult = HIT;
+		return HIT;
+	}
+	return MISS;
+}
+
+int TrianglePrim::intersectPacket(const RayPacket& aPacket, PacketHit& aHit, int aMask) const
+{
+	// NOTE: 与intersect()相同的运算顺序，结果逐位相同
+	const Vec3 &p0 = getVertex(0);
+	const int u = MODULO3[mMajorAxis + 1];
+	const int v = MODULO3[mMajorAxis + 2];
+	const SimdReal nx(mN.x), ny(mN.y), nz(mN.z);
+	const SimdReal px(p0.x), py(p0.y), pz(p0.z), pu(p0[u]), pv(p0[v]);
+	const SimdReal bx(mBx), by(mBy), cx(mCx), cy(mCy);
+	const SimdReal zero(Real(0)), one(Real(1));
+	const int laneBits = (1 << RT_SIMD_WIDTH) - 1;
+
+	int hitMask = 0;
+	for (int i=0; i<RayPacket::SIZE; i+=RT_SIMD_WIDTH)
+	{
+		int lanes = (aMask >> i) & laneBits;
+		if (!lanes)
+			continue;
+
+		SimdReal dx = SimdReal::load(&aPacket.mDir[0][i]);
+		SimdReal dy = SimdReal::load(&aPacket.mDir[1][i]);
+		SimdReal dz = SimdReal::load(&aPacket.mDir[2][i]);
+		SimdReal ox = SimdReal::load(&aPacket.mOrigin[0][i]);
+		SimdReal oy = SimdReal::load(&aPacket.mOrigin[1][i]);
+		SimdReal oz = SimdReal::load(&aPacket.mOrigin[2][i]);
+		SimdReal maxDist = SimdReal::load(&aHit.mDist[i]);
+
+		// 不平行且符合朝向
+		SimdReal denom = nx * dx + ny * dy + nz * dz;
+		SimdReal dist = (nx * (px - ox) + ny * (py - oy) + nz * (pz - oz)) / denom;
+		SimdReal mask = (denom < zero) & (zero < dist) & (dist < maxDist);
+		if (!(movemask(mask) & lanes))
+			continue;
+
+		// 质心坐标判断交点是否在三角形中
+		SimdReal hu = SimdReal::load(&aPacket.mOrigin[u][i]) + 
+			SimdReal::load(&aPacket.mDir[u][i]) * dist - pu;
+		SimdReal hv = SimdReal::load(&aPacket.mOrigin[v][i]) + 
+			SimdReal::load(&aPacket.mDir[v][i]) * dist - pv;
+		SimdReal beta = hu * bx + hv * by;
+		SimdReal gamma = hu * cx + hv * cy;
+		SimdReal alpha = one - beta - gamma;
+		mask = andNot(beta < zero, mask);
+		mask = andNot(gamma < zero, mask);
+		mask = andNot(alpha < zero, mask);
+		int hits = movemask(mask) & lanes;
+		if (!hits)
+			continue;
+
+		// only the lanes asked for are written
+		Real tDist[RT_SIMD_WIDTH], tAlpha[RT_SIMD_WIDTH], tBeta[RT_SIMD_WIDTH], tGamma[RT_SIMD_WIDTH];
+		dist.store(tDist);
+		alpha.store(tAlpha);
+		beta.store(tBeta);
+		gamma.store(tGamma);
+		for (int k=0; k<RT_SIMD_WIDTH; ++k) if (hits & (1 << k))
+		{
+			aHit.mDist[i + k] = tDist[k];
+			aHit.mPrim[i + k] = this;
+			aHit.mBaryCoord[0][i + k] = tAlpha[k];
+			aHit.mBaryCoord[1][i + k] = tBeta[k];
+			aHit.mBaryCoord[2][i + k] = tGamma[k];
+			aHit.mResult[i + k] = HIT;
+		}
+		hitMask |= hits << i;
+	}
+	return hitMask;
+}
+
+// ------------------------------------------------------------------------------
+// TriangleBlock class implementation
+// ------------------------------------------------------------------------------
+
+TriangleBlock::TriangleBlock()
+{
+	for (int i=0; i<RT_SIMD_WIDTH; ++i)
+	{
+		for (int k=0; k<3; ++k)
+			mN[k][i] = mP[k][i] = mB[k][i] = mC[k][i] = 0;
+		mTris[i] = 0;
+	}
+}
+
+void TriangleBlock::set(int aLane, const TrianglePrim* aTri)
+{
+	const int u = MODULO3[aTri->mMajorAxis + 1];
+	const int v = MODULO3[aTri->mMajorAxis + 2];
+	for (int k=0; k<3; ++k)
+	{
+		mN[k][aLane] = aTri->mN[k];
+		mP[k][aLane] = aTri->getVertex(0)[k];
+		mB[k][aLane] = mC[k][aLane] = 0;
+	}
+	mB[u][aLane] = aTri->mBx;
+	mB[v][aLane] = aTri->mBy;
+	mC[u][aLane] = aTri->mCx;
+	mC[v][aLane] = aTri->mCy;
+	mTris[aLane] = aTri;
+}
+
+int TriangleBlock::_intersect(const Ray& aRay, Real aMaxDist, SimdReal& aDist,
+							  SimdReal& aAlpha, SimdReal& aBeta, SimdReal& aGamma) const
+{
+	// NOTE: 与TrianglePrim::intersect()相同的运算顺序，加上的0不改变结果
+	const Vec3& O = aRay.getOrigin();
+	const Vec3& D = aRay.getDir();
+	const SimdReal zero(Real(0)), one(Real(1));
+	const SimdReal ox(O.x), oy(O.y), oz(O.z);
+
+	SimdReal nx = SimdReal::load(mN[0]), ny = SimdReal::load(mN[1]), nz = SimdReal::load(mN[2]);
+	SimdReal px = SimdReal::load(mP[0]), py = SimdReal::load(mP[1]), pz = SimdReal::load(mP[2]);
+
+	// 不平行且符合朝向
+	SimdReal denom = nx * SimdReal(D.x) + ny * SimdReal(D.y) + nz * SimdReal(D.z);
+	aDist = (nx * (px - ox) + ny * (py - oy) + nz * (pz - oz)) / denom;
+	SimdReal mask = (denom < zero) & (zero < aDist) & (aDist < SimdReal(aMaxDist));
+	if (!movemask(mask))
+		return 0;
+
+	// 质心坐标判断交点是否在三角形中
+	SimdReal hx = ox + SimdReal(D.x) * aDist - px;
+	SimdReal hy = oy + SimdReal(D.y) * aDist - py;
+	SimdReal hz = oz + SimdReal(D.z) * aDist - pz;
+	aBeta = hx * SimdReal::load(mB[0]) + hy * SimdReal::load(mB[1]) + 
+		hz * SimdReal::load(mB[2]);
+	aGamma = hx * SimdReal::load(mC[0]) + hy * SimdReal::load(mC[1]) + 
+		hz * SimdReal::load(mC[2]);
+	aAlpha = one - aBeta - aGamma;
+	mask = andNot(aBeta < zero, mask);
+	mask = andNot(aGamma < zero, mask);
+	mask = andNot(aAlpha < zero, mask);
+	return movemask(mask);
+}
+
+RTResult TriangleBlock::intersect(const Ray& aRay, HitRecord& aHit) const
+{
+	SimdReal dist, alpha, beta, gamma;
+	int hits = _intersect(aRay, aHit.mDist, dist, alpha, beta, gamma);
+	if (!hits)
+		return MISS;
+
+	// the nearest lane, the first one on a tie like the sequential tests
+	Real tDist[RT_SIMD_WIDTH], tAlpha[RT_SIMD_WIDTH], tBeta[RT_SIMD_WIDTH], tGamma[RT_SIMD_WIDTH];
+	dist.store(tDist);
+	int best = -1;
+	for (int k=0; k<RT_SIMD_WIDTH; ++k)
+	{
+		if ((hits & (1 << k)) && (best < 0 || tDist[k] < tDist[best]))
+			best = k;
+	}
+	alpha.store(tAlpha);
+	beta.store(tBeta);
+	gamma.store(tGamma);
+	aHit.mDist = tDist[best];
+	aHit.mPrim = mTris[best];
+	aHit.mBaryCoord.Set(tAlpha[best], tBeta[best], tGamma[best]);
+	aHit.mResult = HIT;
+	return HIT;
+}
+
+Occlusion TriangleBlock::findOcclusion(const Ray& aRay, Real aMaxDist, 
+										const Primitive*& aOccluder) const
+{
+	SimdReal dist, alpha, beta, gamma;
+	int hits = _intersect(aRay, aMaxDist, dist, alpha, beta, gamma);
+	Occlusion result = OC_NONE;
+	for (int k=0; hits && k<RT_SIMD_WIDTH; ++k)
+	{
+		if (!(hits & (1 << k)))
+			continue;
+		Occlusion occ = mTris[k]->getOcclusion();
+		if (occ == OC_OPAQUE)
+		{
+			aOccluder = mTris[k];
+			return occ;
+		}
+		result = std::max(result, occ);
+	}
+	return result;
+}
+
+bool TrianglePrim::intersetBox(const AABB &aBox) const
+{
+	Vec3 halfDim = 0.5f * aBox.getDim();
+	Vec3 centre = aBox.getMin() + halfDim;
+	Vec3 v[3], e[3], sv;
+	int i, j;
+	int side;
+	for (i=0; i<3; ++i)
+	{
+		v[i] = getVertex(i) - centre;
+		e[i] = getVertex(MODULO3[i]) - getVertex(MODULO3[i+1]);
+		e[i].Normalize();
+
+	}
+	// 基于分离轴定理的三角形与AABB求交算法，共测试3+1+9＝13次
+	// AABB 的主轴
+	// AABB 的3个主轴
+	sv = Vec3::ZERO;
+	for (i=0; i<3; ++i)
+	{ // each axis
+		side = 0;
+		for (j=0; j<3; ++j)
+		{ // each vertex
+			if (v[j].cell[i] > halfDim[i])
+				++side;
+			else if (v[j].cell[i] < -halfDim[i])
+				--side;
+			else
+				++sv[i];
+		}
+		if (side == -3 || side == 3) return false;
+	}
+	for (i=0; i<3; ++i) if (sv[i] == 3)
+		return true;
+
+	// 三角形法向
+	Vec3 norm = e[0].Cross(e[1]);
+	Real d2tri = abs(norm.Dot(v[0]));
+	Real d2r = 0;
+	for (i=0; i<3; ++i)
+	{
+		d2r += ( (norm.cell[i]<0) ? -1 : 1 ) * norm.cell[i] * halfDim.cell[i];
+	}
+	if (d2tri > d2r) return false;
+	
+	// 9种法向：AABB主轴与三角形各边的叉积
+	Real p[3], pMin, pMax;
+	for (i=0; i<3; ++i)
+	{// each axis
+		for (j=0; j<3; ++j)
+		{// each edge
+			norm = Vec3::ZERO;
+			norm[i] = 1;
+			if (abs(norm.Dot(e[j])) > 1.0 - RT_EPSILON)
+			{
+				continue;
+			}
+			norm = norm.Cross(e[j]);
+			// 三角形在分离轴上的投影区间
+			for (int k=0; k<3; ++k)
+				p[k] = norm.Dot(v[k]);
+			pMin = min(p[0], min(p[1], p[2]));
+			pMax = max(p[0], max(p[1], p[2]));
+			// AABB在分离轴上的投影半径
+			d2r = 0;
+			for (int k=0; k<3; ++k)
+				d2r += abs(norm.cell[k]) * halfDim.cell[k];
+			if (pMin > d2r || pMax < -d2r) return false;
+		}
+	}
+
+	return true;
+}
+
+Vec3 TrianglePrim::getNormal(const HitRecord& aHit, const Vec3 &) const
+{
+	if (mMesh->mNormals.empty())
+		return mN;
+
+	Vec3 normal = Vec3::ZERO;
+	for (int i=0; i<3; ++i)
+	{
+		normal += aHit.mBaryCoord[i] * mMesh->mNormals[_getVertexIndex(i)];
+	}
+	normal.Normalize();
+	return normal;
+}
+
+void TrianglePrim::getTextureCoord(Real &u, Real &v, const HitRecord& aHit, const Vec3&) const
+{
+	u = v = 0;
+	if (mMesh->mTexCoords.empty())
+		return;
+	for (int i=0; i<3; ++i)
+	{
+		const Real *uv = &mMesh->mTexCoords[2 * _getVertexIndex(i)];
+		u += aHit.mBaryCoord[i] * uv[0];
+		v += aHit.mBaryCoord[i] * uv[1];
+	}
+}
+
+// ------------------------------------------------------------------------------
+// TriangleMesh class implementation
+// ------------------------------------------------------------------------------
+
+TriangleMesh::TriangleMesh(MemoryArena& aArena, int aNumVertices, int aNumTriangles, int aFlags)
+{
+	mPositions.create(aArena, aNumVertices);
+	if (aFlags & MESH_NORMALS)
+		mNormals.create(aArena, aNumVertices);
+	if (aFlags & MESH_TEXCOORDS)
+		mTexCoords.create(aArena, 2 * aNumVertices);
+	mIndices.create(aArena, 3 * aNumTriangles);
+	mTriangles.create(aArena, aNumTriangles);
+}
+
+TriangleMesh::TriangleMesh(MemoryArena& aArena, int aNumVertices, const Vec3* aPositions,
+						   const Vec3* aNormals, const Real* aTexCoords, int aNumTriangles, 
+						   const int* aIndices)
+{
+	mPositions.attach(aPositions, aNumVertices);
+	if (aNormals)
+		mNormals.attach(aNormals, aNumVertices);
+	if (aTexCoords)
+		mTexCoords.attach(aTexCoords, 2 * aNumVertices);
+	mIndices.attach(aIndices, 3 * aNumTriangles);
+	mTriangles.create(aArena, aNumTriangles);
+}
+
+int TriangleMesh::addVertex(const Vec3& aPos)
+{
+	return addVertex(aPos, Vec3::ZERO, 0, 0);
+}
+
+int TriangleMesh::addVertex(const Vec3& aPos, const Vec3& aNormal)
+{
+	return addVertex(aPos, aNormal, 0, 0);
+}
+
+int TriangleMesh::addVertex(const Vec3& aPos, const Vec3& aNormal, Real u, Real v)
+{
+	mPositions.push_back(aPos);
+	if (mNormals.capacity() > 0)
+		mNormals.push_back(aNormal);
+	if (mTexCoords.capacity() > 0)
+	{
+		mTexCoords.push_back(u);
+		mTexCoords.push_back(v);
+	}
+	return getNumOfVertices() - 1;
+}
+
+void TriangleMesh::addTriangle(int a, int b, int c, Material* aMaterial)
+{
+	mIndices.push_back(a);
+	mIndices.push_back(b);
+	mIndices.push_back(c);
+	_addTriangle(aMaterial);
+}
+
+void TriangleMesh::addTriangles(const int* aMaterialIds, Material* const* aMaterials)
+{
+	while (mTriangles.size() < mTriangles.capacity())
+		_addTriangle(aMaterials[aMaterialIds[mTriangles.size()]]);
+}
+
+void TriangleMesh::_addTriangle(Material* aMaterial)
+{
+	const int *idx = &mIndices[3 * mTriangles.size()];
+	mTriangles.push_back(TrianglePrim(this, aMaterial));
+	TrianglePrim &tri = mTriangles.back();
+
+	// precalculate
+	const Vec3 &v1 = mPositions[idx[0]], &v2 = mPositions[idx[1]], &v3 = mPositions[idx[2]];
+	Vec3 vb = v2 - v1;
+	Vec3 vc = v3 - v1;
+	tri.mN = vb.Cross(vc);
+	tri.mN.Normalize();
+	Vec3 Nabs = tri.mN;
+	Nabs.Abs();
+	if (Nabs.x > Nabs.y && Nabs.x > Nabs.z)
+		tri.mMajorAxis = 0;
+	else if (Nabs.y > Nabs.x && Nabs.y > Nabs.z)
+		tri.mMajorAxis = 1;
+	else
+		tri.mMajorAxis = 2;
+
+	int u = MODULO3[tri.mMajorAxis + 1];
+	int v = MODULO3[tri.mMajorAxis + 2];
+	Real krec = 1.0f / (vb.cell[u] * vc.cell[v] - vb.cell[v] * vc.cell[u]);
+	tri.mBx = vc.cell[v] * krec;
+	tri.mBy = -vc.cell[u] * krec;
+	tri.mCx = -vb.cell[v] * krec;
+	tri.mCy = vb.cell[u] * krec;
+}
+
+// ------------------------------------------------------------------------------
+// Light class implementation
+// ------------------------------------------------------------------------------
+
+
 }; // namespace RayTracer
\ No newline at end of file
@@ -1,372 +1,609 @@
-/********************************************************************
-	created:	2010/04/22
-	file name:	primitive.h
-	author:		maxint lnychina@gmail.com
-*********************************************************************/
-
-#ifndef _RT_PRIMITIVE_H_
-#define _RT_PRIMITIVE_H_
-
-#include "common.h"
-
-#pragma warning(disable:4800) // int to bool
-
-namespace RayTracer {
-
-// ------------------------------------------------------------------------------
-// Primitive class definition
-// ------------------------------------------------------------------------------
-
-class Ray;
-class Material;
-
-class Primitive
-{
-public:
-	enum PrimType
-	{
-		PT_SPHERE,
-		PT_PLANE,
-		PT_BOX,
-		PT_TRIANGLE
-	};
-	Primitive();
-	virtual ~Primitive();
-
-	Material* getMaterial() const		{ return mMaterial; }
-	void setMaterial(Material* aMat)	{ mMaterial = aMat; }
-	void setMaterial(const String& matName);
-	virtual Color getColor(const Vec3& aIP) const;
-
-	virtual PrimType getType() const = 0;
-
-	/**	Intersection detection
-	\param
-		aRay	light ray
-		aDist	intersection distance
-	\return
-		Ray tracing result, hit, miss or inside
-	 */
-	virtual RTResult intersect(const Ray& aRay, Real& aDist) = 0;
-	
-	/**	Whether it intersects with a AABB
-	 */
-	virtual bool intersetBox(const AABB& aBox) const = 0;
-
-	/**	Return normalized normal direction
-	 */
-	virtual const Vec3& getNormal(const Vec3& aPos) = 0;
-
-	virtual const AABB& getAABB() const
-	{
-		return mAABB;
-	}
-	virtual void setLight(bool isLight)	{ mIsLight = isLight; }
-	bool isLight() const				{ return mIsLight; }
-
-	void setName(const String& aName)	{ mName = aName; }
-	const String& getName() const		{ return mName; }
-	int getLastRayID() const			{ return mRayID; }
-
-protected:
-	virtual void getTextureCoord(Real& u, Real& v, const Vec3& aIP) const = 0;
-
-protected:
-	Material* mMaterial;
-	String mName;
-	bool mIsLight;
-	AABB mAABB;
-	int mRayID;
-};
-
-// ------------------------------------------------------------------------------
-// Sphere primitive class definition
-// ------------------------------------------------------------------------------
-
-class Sphere : public Primitive
-{
-public:
-	Sphere(const Vec3& aCentre, Real aRadius)
-		: mCentre(aCentre)
-		, mRadius(aRadius)
-		, mSqrRadius(aRadius * aRadius)
-		, mRRadius(1.0f / aRadius)
-	{
-		mAABB = AABB(-aRadius * Vec3::ONE + aCentre, aRadius * Vec3::ONE + aCentre);
-	}
-
-	// override from Primitive
-	PrimType getType() const
-	{
-		return PT_SPHERE;
-	}
-	RTResult intersect(const Ray& aRay, Real& aDist);
-	bool intersetBox(const AABB& aBox) const;
-	const Vec3& getNormal(const Vec3& aPos)
-	{
-		mNormal = (aPos - mCentre) *  mRRadius;
-		return mNormal;
-	}
-
-	const Vec3& getCentre() const
-	{
-		return mCentre;
-	}
-	Real getSqrRadius()
-	{
-		mSqrRadius;
-	}
-
-private:
-	// override from Primitive
-	void getTextureCoord(Real& u, Real& v, const Vec3& aIP) const ;
-
-private:
-	Vec3 mCentre;
-	Vec3 mNormal;
-	Real mSqrRadius, mRadius, mRRadius;
-};
-
-// ------------------------------------------------------------------------------
-// Plane primitive
-// ------------------------------------------------------------------------------
-
-class PlanePrim : public Primitive
-{
-public:
-	PlanePrim(const Vec3& aNormal, Real aDist);
-
-	// override from Primitive
-	PrimType getType() const
-	{
-		return PT_PLANE;
-	}
-	const Vec3& getNormal(const Vec3& )
-	{
-		return mPlane.N;
-	}
-	RTResult intersect(const Ray& aRay, Real& aDist);
-	bool intersetBox(const AABB& aBox) const;
-
-	const Vec3& getNormal() const
-	{
-		return mPlane.N;
-	}
-	Real getD()
-	{
-		return mPlane.D;
-	}
-
-private:
-	// override from Primitive
-	void getTextureCoord(Real& u, Real& v, const Vec3& aIP) const;
-
-private:
-	Plane mPlane;
-	Vec3 mUAxis, mVAxis;
-};
-
-// ------------------------------------------------------------------------------
-// Box primitive class definition
-// ------------------------------------------------------------------------------
-
-class Box : public Primitive
-{
-public:
-	Box()
-	{}
-	Box(const AABB& aBox)
-	{
-		mAABB = aBox;
-	}
-
-	// override from Primitive
-	PrimType getType() const
-	{
-		return PT_BOX;
-	}
-	RTResult intersect(const Ray& aRay, Real& aDist);
-	bool intersetBox(const AABB& aBox) const
-	{
-		return mAABB.interset(aBox);
-	}
-	const Vec3& getNormal(const Vec3& aPos);
-
-	bool contains(const Vec3& aPos) const
-	{
-		return mAABB.contains(aPos);
-	}
-	const Vec3& getPos() const
-	{
-		return mAABB.getMin();
-	}
-	const Vec3& getDim() const
-	{
-		return mAABB.getMax();
-	}
-
-private:
-	// override from Primitive
-	void getTextureCoord(Real& , Real& , const Vec3& ) const {};
-
-private:
-	Vec3 mNormal;
-};
-
-// ------------------------------------------------------------------------------
-// A Triangle Primitive
-// ------------------------------------------------------------------------------
-
-/// A vertex with position, normal and texcoords
-class Vertex
-{
-public:
-	Vec3 mPos, mNormal;
-	Real mU, mV;
-public:
-	Vertex() {}
-	Vertex(const Vec3& aPos, const Vec3& aNormal = Vec3::ZERO, Real u = 0, Real v = 0)
-		: mPos(aPos), mNormal(aNormal)
-		, mU(u), mV(v)
-	{}
-};
-
-class TrianglePrim : public Primitive
-{
-public:
-	TrianglePrim(Vertex* v1, Vertex* v2, Vertex* v3, bool genNorm = false);
-
-	// override from Primitive
-	PrimType getType() const	{ return PT_TRIANGLE; }
-	RTResult intersect(const Ray& aRay, Real& aDist);
-	bool intersetBox(const AABB& aBox) const;
-	const Vec3& getNormal(const Vec3& aPos);
-
-private:
-	// override from Primitive
-	void getTextureCoord(Real& u, Real& v, const Vec3& aIP) const;
-
-private:
-	Vertex* mVertices[3];
-	Vec3 mN;
-	int mMajorAxis; // 
-	Vec3 mBaryCoord;	// 󽻼
-	Real mBx, mBy, mCx, mCy; // Ԥ
-	Vec3 mNormal;
-};
-
-// ------------------------------------------------------------------------------
-// Light class definition
-// ------------------------------------------------------------------------------
-
-class Light
-{
-public:
-	enum LightType
-	{
-		LT_NONE,
-		LT_POINT,
-		LT_DIRECTIONAL,
-		LT_SPOT,
-		LT_AREA,
-	};
-	enum StateToggler
-	{
-		AMBIENT = 1,
-		DIFFUSE = 1<<1,
-		SPECULAR = 1<<2
-	};
-public:
-	Light()
-		: mAmbient(0.2f,0.2f,0.2f)
-		, mDiffuse(0.8f,0.8f,0.8f)
-		, mSpecular(0,0,0)
-		, mPosition(0,0,1)
-		, mDirection(0,0,-1)
-		, mSpotFallOff(180)
-		, mAttenuation0(1)
-		, mAttenuation1(0)
-		, mAttenuation2(0)
-		, mSpotExponent(30)
-		, mState(AMBIENT | DIFFUSE)
-	{}
-
-	// ambient
-	void setAmbient(Real _r, Real _g, Real _b)
-	{
-		mAmbient.r = _r;
-		mAmbient.g = _g;
-		mAmbient.b = _b;
-		_setColorState(mAmbient, AMBIENT);
-	}
-	const Color& getAmbient() const { return mAmbient; }
-	bool isAmbient() const { return (mState & AMBIENT); }
-	void setAmbient(const Color& val) { setAmbient(val.r, val.g, val.b);  }
-
-	// diffuse
-	void setDiffuse(Real _r, Real _g, Real _b)
-	{
-		mDiffuse.r = _r;
-		mDiffuse.g = _g;
-		mDiffuse.b = _b;
-		_setColorState(mDiffuse, DIFFUSE);
-	}
-	const Color& getDiffuse() const { return mDiffuse; }
-	bool isDiffuse() const { return (mState & DIFFUSE); }
-	void setDiffuse(const Color& val) { setDiffuse(val.r, val.g, val.b); }
-
-	// specular
-	void setSpecular(Real _r, Real _g, Real _b)
-	{
-		mSpecular.r = _r;
-		mSpecular.g = _g;
-		mSpecular.b = _b;
-		_setColorState(mSpecular, SPECULAR);
-	}
-	const Color& getSpecular() const { return mSpecular; }
-	bool isSpecular() const { return (mState & SPECULAR); }
-	void setSpecular(const Color& val) { setSpecular(val.r, val.b, val.g); }
-
-	// directional light setting
-	const Vec3& getDirection() const { return mDirection; }
-	void setDirection(const Vec3& val) 
-	{ 
-		mDirection = val;  
-		mDirection.Normalize();
-	}
-	void setDirection(Real nx, Real ny, Real nz)
-	{ 
-		mDirection.x = nx;
-		mDirection.y = ny;
-		mDirection.z = nz;
-		mDirection.Normalize();
-	}
-
-private:
-	void _setColorState(const Color& clr, StateToggler tog)
-	{
-		if (clr.Length() > RT_EPSILON)
-			mState |= tog;
-		else
-			mState &= ~tog;
-	}
-private:
-	Color mAmbient, mDiffuse, mSpecular;	// Ҫ״̬ж
-	Vec3 mDirection;
-public:
-	LightType mType;
-	Real mShininess;
-	Vec3 mPosition;
-	Real mSpotFallOff;
-	Real mSpotExponent;
-	Real mAttenuation0;
-	Real mAttenuation1;
-	Real mAttenuation2;
-	AABB mAABB;
-
-	int mState;
-};
-
-}; // namespace RayTracer
-
+/********************************************************************
+	created:	2010/04/22
+	file name:	primitive.h
+	author:		maxint lnychina@gmail.com
+*********************************************************************/
+
+#ifndef _RT_PRIMITIVE_H_
+#define _RT_PRIMITIVE_H_
+
+#include "common.h"
+#include "simd.h"
+#include "arena.h"
+
+#pragma warning(disable:4800) // int to bool
+
+namespace RayTracer {
+
+// ------------------------------------------------------------------------------
+// Primitive class definition
+// ------------------------------------------------------------------------------
+
+class Ray;
+class RayPacket;
+class Material;
+class Primitive;
+
+/// Result of a ray / primitive intersection, filled per ray by the caller's
+/// thread so primitives stay read-only while tracing
+class HitRecord
+{
+public:
+	HitRecord(Real aMaxDist = FAR_DISTANCE)
+		: mDist(aMaxDist)
+		, mPrim(0)
+		, mBaryCoord(0,0,0)
+		, mResult(MISS)
+	{}
+
+	Real mDist;					// intersection distance, or the search limit
+	const Primitive* mPrim;		// primitive hit, 0 if none
+	Vec3 mBaryCoord;			// barycentric coordinates, triangles only
+	RTResult mResult;			// HIT from outside, INPRIM from inside
+};
+
+/// HitRecords of a RayPacket in structure-of-arrays layout
+class PacketHit
+{
+public:
+	enum { SIZE = RT_PACKETSIZE };
+
+	PacketHit(Real aMaxDist = FAR_DISTANCE)
+	{
+		for (int i=0; i<SIZE; ++i)
+		{
+			mDist[i] = aMaxDist;
+			mPrim[i] = 0;
+			mBaryCoord[0][i] = mBaryCoord[1][i] = mBaryCoord[2][i] = 0;
+			mResult[i] = MISS;
+		}
+	}
+
+	void getHit(int aLane, HitRecord& aHit) const
+	{
+		aHit.mDist = mDist[aLane];
+		aHit.mPrim = mPrim[aLane];
+		aHit.mBaryCoord.Set(mBaryCoord[0][aLane], mBaryCoord[1][aLane], mBaryCoord[2][aLane]);
+		aHit.mResult = mResult[aLane];
+	}
+	void setHit(int aLane, const HitRecord& aHit)
+	{
+		mDist[aLane] = aHit.mDist;
+		mPrim[aLane] = aHit.mPrim;
+		for (int i=0; i<3; ++i)
+			mBaryCoord[i][aLane] = aHit.mBaryCoord[i];
+		mResult[aLane] = aHit.mResult;
+	}
+
+	Real mDist[SIZE];
+	const Primitive* mPrim[SIZE];
+	Real mBaryCoord[3][SIZE];
+	RTResult mResult[SIZE];
+};
+
+class Primitive
+{
+public:
+	enum PrimType
+	{
+		PT_SPHERE,
+		PT_PLANE,
+		PT_BOX,
+		PT_TRIANGLE
+	};
+	Primitive();
+	virtual ~Primitive();
+
+	Material* getMaterial() const		{ return mMaterial; }
+	void setMaterial(Material* aMat)	{ mMaterial = aMat; }
+	void setMaterial(const String& matName);
+	virtual Color getColor(const HitRecord& aHit, const Vec3& aIP) const;
+
+	virtual PrimType getType() const = 0;
+
+	/**	Intersection detection
+	\param
+		aRay	light ray
+		aHit	updated when the intersection is closer than aHit.mDist
+	\return
+		Ray tracing result, hit, miss or inside
+	 */
+	virtual RTResult intersect(const Ray& aRay, HitRecord& aHit) const = 0;
+
+	/**	Intersect the rays of a packet, by default one at a time
+	\param
+		aPacket	the rays
+		aHit	updated per lane like intersect()
+		aMask	lanes to test
+	\return
+		mask of the lanes hit
+	 */
+	virtual int intersectPacket(const RayPacket& aPacket, PacketHit& aHit, int aMask) const;
+	
+	/**	Whether it intersects with a AABB
+	 */
+	virtual bool intersetBox(const AABB& aBox) const = 0;
+
+	/**	Return normalized normal direction at the hit position
+	 */
+	virtual Vec3 getNormal(const HitRecord& aHit, const Vec3& aPos) const = 0;
+
+	/**	Bounding box, only asked for while the acceleration structures are
+		built
+	 */
+	virtual AABB getAABB() const = 0;
+
+	/**	Whether the AABB is finite, unbounded primitives are kept out of 
+		the acceleration structures and the scene extends
+	 */
+	virtual bool isBounded() const		{ return true; }
+
+	/**	How the primitive blocks a shadow ray, lights do not block and 
+		refractive materials let part of the light through
+	 */
+	Occlusion getOcclusion() const;
+
+	virtual void setLight(bool isLight)	{ mIsLight = isLight; }
+	bool isLight() const				{ return mIsLight; }
+
+	/// position in the scene, set when the grid is built
+	void setIndex(int aIndex)			{ mIndex = aIndex; }
+	int getIndex() const				{ return mIndex; }
+
+protected:
+	/// a primitive of @aMaterial, without looking up the default one
+	explicit Primitive(Material* aMaterial);
+
+	virtual void getTextureCoord(Real& u, Real& v, const HitRecord& aHit, 
+		const Vec3& aIP) const = 0;
+
+protected:
+	// NOTE: 每个三角形一份，只放求交与着色必需的成员
+	Material* mMaterial;
+	int mIndex;
+	bool mIsLight;
+};
+
+/**	A primitive standing on its own, with a name and its bounding box 
+	stored. The triangles of a TriangleMesh keep neither.
+ */
+class ShapePrim : public Primitive
+{
+public:
+	ShapePrim()
+		: mAABB(Vec3::ZERO, Vec3::ZERO)
+	{}
+
+	// override from Primitive
+	AABB getAABB() const				{ return mAABB; }
+
+	void setName(const String& aName)	{ mName = aName; }
+	const String& getName() const		{ return mName; }
+
+protected:
+	String mName;
+	AABB mAABB;
+};
+
+// ------------------------------------------------------------------------------
+// Sphere primitive class definition
+// ------------------------------------------------------------------------------
+
+class Sphere : public ShapePrim
+{
+public:
+	Sphere(const Vec3& aCentre, Real aRadius)
+		: mCentre(aCentre)
+		, mRadius(aRadius)
+		, mSqrRadius(aRadius * aRadius)
+		, mRRadius(1.0f / aRadius)
+	{
+		mAABB = AABB(-aRadius * Vec3::ONE + aCentre, aRadius * Vec3::ONE + aCentre);
+	}
+
+	// override from Primitive
+	PrimType getType() const
+	{
+		return PT_SPHERE;
+	}
+	RTResult intersect(const Ray& aRay, HitRecord& aHit) const;
+	bool intersetBox(const AABB& aBox) const;
+	Vec3 getNormal(const HitRecord& , const Vec3& aPos) const
+	{
+		return (aPos - mCentre) *  mRRadius;
+	}
+
+	const Vec3& getCentre() const
+	{
+		return mCentre;
+	}
+	Real getSqrRadius()
+	{
+		mSqrRadius;
+	}
+
+private:
+	// override from Primitive
+	void getTextureCoord(Real& u, Real& v, const HitRecord& aHit, const Vec3& aIP) const;
+
+private:
+	Vec3 mCentre;
+	Real mSqrRadius, mRadius, mRRadius;
+};
+
+// ------------------------------------------------------------------------------
+// Plane primitive
+// ------------------------------------------------------------------------------
+
+class PlanePrim : public ShapePrim
+{
+public:
+	PlanePrim(const Vec3& aNormal, Real aDist);
+
+	// override from Primitive
+	PrimType getType() const
+	{
+		return PT_PLANE;
+	}
+	Vec3 getNormal(const HitRecord& , const Vec3& ) const
+	{
+		return mPlane.N;
+	}
+	RTResult intersect(const Ray& aRay, HitRecord& aHit) const;
+	bool intersetBox(const AABB& aBox) const;
+	bool isBounded() const
+	{
+		return false;
+	}
+
+	const Vec3& getNormal() const
+	{
+		return mPlane.N;
+	}
+	Real getD()
+	{
+		return mPlane.D;
+	}
+
+private:
+	// override from Primitive
+	void getTextureCoord(Real& u, Real& v, const HitRecord& aHit, const Vec3& aIP) const;
+
+private:
+	Plane mPlane;
+	Vec3 mUAxis, mVAxis;
+};
+
+// ------------------------------------------------------------------------------
+// Box primitive class definition
+// ------------------------------------------------------------------------------
+
+class Box : public ShapePrim
+{
+public:
+	Box()
+	{}
+	Box(const AABB& aBox)
+	{
+		mAABB = aBox;
+	}
+
+	// override from Primitive
+	PrimType getType() const
+	{
+		return PT_BOX;
+	}
+	RTResult intersect(const Ray& aRay, HitRecord& aHit) const;
+	bool intersetBox(const AABB& aBox) const
+	{
+		return mAABB.interset(aBox);
+	}
+	Vec3 getNormal(const HitRecord& aHit, const Vec3& aPos) const;
+
+	bool contains(const Vec3& aPos) const
+	{
+		return mAABB.contains(aPos);
+	}
+	const Vec3& getPos() const
+	{
+		return mAABB.getMin();
+	}
+	const Vec3& getDim() const
+	{
+		return mAABB.getMax();
+	}
+
+private:
+	// override from Primitive
+	void getTextureCoord(Real& , Real& , const HitRecord& , const Vec3& ) const {};
+};
+
+// ------------------------------------------------------------------------------
+// Triangle mesh
+// ------------------------------------------------------------------------------
+
+class TriangleMesh;
+
+/**	A triangle of a TriangleMesh. Only the precomputed data of the 
+	intersection test is kept per triangle, the vertices are shared in the
+	arrays of the mesh.
+ */
+class TrianglePrim : public Primitive
+{
+public:
+	TrianglePrim(const TriangleMesh* aMesh, Material* aMaterial);
+
+	// override from Primitive
+	PrimType getType() const	{ return PT_TRIANGLE; }
+	RTResult intersect(const Ray& aRay, HitRecord& aHit) const;
+	int intersectPacket(const RayPacket& aPacket, PacketHit& aHit, int aMask) const;
+	bool intersetBox(const AABB& aBox) const;
+	Vec3 getNormal(const HitRecord& aHit, const Vec3& aPos) const;
+	AABB getAABB() const;
+
+	/// position of the corner 0~2
+	const Vec3& getVertex(int aCorner) const;
+
+private:
+	// override from Primitive
+	void getTextureCoord(Real& u, Real& v, const HitRecord& aHit, const Vec3& aIP) const;
+
+	/// mesh vertex of the corner 0~2
+	int _getVertexIndex(int aCorner) const;
+
+private:
+	friend class TriangleBlock;
+	friend class TriangleMesh;
+
+	unsigned char mMajorAxis; // 法向主轴
+	const TriangleMesh* mMesh;
+	Vec3 mN;
+	Real mBx, mBy, mCx, mCy; // 求质心坐标的预计算结果
+};
+
+/**	Triangles sharing their vertices through an index buffer, instead of a
+	heap Vertex per triangle corner. The arrays are allocated at their final
+	size from the arena of the scene, the vertices are added first and then
+	the triangles.
+ */
+class TriangleMesh
+{
+public:
+	/// attributes stored besides the positions
+	enum Flags
+	{
+		MESH_NORMALS	= 1,	// without, the triangles are flat shaded
+		MESH_TEXCOORDS	= 2
+	};
+
+	/**	Allocate the arrays
+	\param
+		aArena			owner of the arrays
+		aNumVertices	vertices to add
+		aNumTriangles	triangles to add
+		aFlags			MESH_NORMALS, MESH_TEXCOORDS
+	 */
+	TriangleMesh(MemoryArena& aArena, int aNumVertices, int aNumTriangles, int aFlags);
+
+	/**	Use vertex and index arrays kept elsewhere, e.g. in a mapped cache 
+		file, without copying. They must outlive the mesh and are only read,
+		the triangles are made by addTriangles().
+	\param
+		aNormals, aTexCoords	NULL if the mesh has not the attribute
+		aIndices				three vertices per triangle
+	 */
+	TriangleMesh(MemoryArena& aArena, int aNumVertices, const Vec3* aPositions, 
+		const Vec3* aNormals, const Real* aTexCoords, int aNumTriangles, const int* aIndices);
+
+	/**	Add a vertex, an attribute the mesh has not is ignored, a missing
+		one is zero
+	\return
+		index of the vertex
+	 */
+	int addVertex(const Vec3& aPos);
+	int addVertex(const Vec3& aPos, const Vec3& aNormal);
+	int addVertex(const Vec3& aPos, const Vec3& aNormal, Real u, Real v);
+
+	/**	Add a triangle of three vertices added before, counter clockwise
+	 */
+	void addTriangle(int a, int b, int c, Material* aMaterial);
+
+	/**	Make the triangles of the index array given to the constructor, 
+		triangle i has the material @aMaterials[@aMaterialIds[i]]
+	 */
+	void addTriangles(const int* aMaterialIds, Material* const* aMaterials);
+
+	int getNumOfVertices() const		{ return mPositions.size(); }
+	int getNumOfTriangles() const		{ return mTriangles.size(); }
+
+	const TrianglePrim* getTriangle(int i) const	{ return &mTriangles[i]; }
+	TrianglePrim* getTriangle(int i)				{ return &mTriangles[i]; }
+
+	void setName(const String& aName)	{ mName = aName; }
+	const String& getName() const		{ return mName; }
+
+private:
+	friend class TrianglePrim;
+	friend class SceneCache;
+
+	/**	Make the triangle of the next three indices
+	 */
+	void _addTriangle(Material* aMaterial);
+
+private:
+	String mName;
+	ArenaArray<Vec3> mPositions;
+	ArenaArray<Vec3> mNormals;		// empty without MESH_NORMALS
+	ArenaArray<Real> mTexCoords;	// u, v per vertex, empty without MESH_TEXCOORDS
+	ArenaArray<int> mIndices;		// three vertices per triangle
+	ArenaArray<TrianglePrim> mTriangles;
+};
+
+inline int TrianglePrim::_getVertexIndex(int aCorner) const
+{
+	// NOTE: 三角形连续存放，由地址得到在网格中的序号
+	const int tri = static_cast<int>(this - &mMesh->mTriangles[0]);
+	return mMesh->mIndices[3 * tri + aCorner];
+}
+
+inline const Vec3& TrianglePrim::getVertex(int aCorner) const
+{
+	return mMesh->mPositions[_getVertexIndex(aCorner)];
+}
+
+/**	RT_SIMD_WIDTH triangles in structure-of-arrays layout, one ray is tested
+	against all of them at once. The projection of each triangle is spread
+	over the three axes with a zero on the major one, so the lanes need no 
+	per-triangle axis selection. Unused lanes hold a zero normal and never hit.
+ */
+class TriangleBlock
+{
+public:
+	TriangleBlock();
+
+	/**	Copy the precomputed data of a triangle into a lane
+	 */
+	void set(int aLane, const TrianglePrim* aTri);
+
+	/**	Find the nearest intersection with the triangles of the block
+	\return
+		MISS if none is closer than aHit.mDist, otherwise HIT
+	 */
+	RTResult intersect(const Ray& aRay, HitRecord& aHit) const;
+
+	/**	Strongest occlusion of the triangles hit closer than @aMaxDist, 
+		@aOccluder is set to an opaque one if any
+	 */
+	Occlusion findOcclusion(const Ray& aRay, Real aMaxDist, const Primitive*& aOccluder) const;
+
+private:
+	/**	Test the ray against all lanes
+	\return
+		mask of the lanes hit closer than @aMaxDist
+	 */
+	int _intersect(const Ray& aRay, Real aMaxDist, SimdReal& aDist,
+		SimdReal& aAlpha, SimdReal& aBeta, SimdReal& aGamma) const;
+
+private:
+	Real mN[3][RT_SIMD_WIDTH];		// normal
+	Real mP[3][RT_SIMD_WIDTH];		// first vertex
+	Real mB[3][RT_SIMD_WIDTH];		// beta = dot(hit - P, B)
+	Real mC[3][RT_SIMD_WIDTH];		// gamma = dot(hit - P, C)
+	const TrianglePrim* mTris[RT_SIMD_WIDTH];
+};
+
+// ------------------------------------------------------------------------------
+// Light class definition
+// ------------------------------------------------------------------------------
+
+class Light
+{
+public:
+	enum LightType
+	{
+		LT_NONE,
+		LT_POINT,
+		LT_DIRECTIONAL,
+		LT_SPOT,
+		LT_AREA,
+	};
+	enum StateToggler
+	{
+		AMBIENT = 1,
+		DIFFUSE = 1<<1,
+		SPECULAR = 1<<2
+	};
+public:
+	Light()
+		: mAmbient(0.2f,0.2f,0.2f)
+		, mDiffuse(0.8f,0.8f,0.8f)
+		, mSpecular(0,0,0)
+		, mPosition(0,0,1)
+		, mDirection(0,0,-1)
+		, mSpotFallOff(180)
+		, mAttenuation0(1)
+		, mAttenuation1(0)
+		, mAttenuation2(0)
+		, mSpotExponent(30)
+		, mState(AMBIENT | DIFFUSE)
+	{}
+
+	// ambient
+	void setAmbient(Real _r, Real _g, Real _b)
+	{
+		mAmbient.r = _r;
+		mAmbient.g = _g;
+		mAmbient.b = _b;
+		_setColorState(mAmbient, AMBIENT);
+	}
+	const Color& getAmbient() const { return mAmbient; }
+	bool isAmbient() const { return (mState & AMBIENT); }
+	void setAmbient(const Color& val) { setAmbient(val.r, val.g, val.b);  }
+
+	// diffuse
+	void setDiffuse(Real _r, Real _g, Real _b)
+	{
+		mDiffuse.r = _r;
+		mDiffuse.g = _g;
+		mDiffuse.b = _b;
+		_setColorState(mDiffuse, DIFFUSE);
+	}
+	const Color& getDiffuse() const { return mDiffuse; }
+	bool isDiffuse() const { return (mState & DIFFUSE); }
+	void setDiffuse(const Color& val) { setDiffuse(val.r, val.g, val.b); }
+
+	// specular
+	void setSpecular(Real _r, Real _g, Real _b)
+	{
+		mSpecular.r = _r;
+		mSpecular.g = _g;
+		mSpecular.b = _b;
+		_setColorState(mSpecular, SPECULAR);
+	}
+	const Color& getSpecular() const { return mSpecular; }
+	bool isSpecular() const { return (mState & SPECULAR); }
+	void setSpecular(const Color& val) { setSpecular(val.r, val.b, val.g); }
+
+	// directional light setting
+	const Vec3& getDirection() const { return mDirection; }
+	void setDirection(const Vec3& val) 
+	{ 
+		mDirection = val;  
+		mDirection.Normalize();
+	}
+	void setDirection(Real nx, Real ny, Real nz)
+	{ 
+		mDirection.x = nx;
+		mDirection.y = ny;
+		mDirection.z = nz;
+		mDirection.Normalize();
+	}
+
+private:
+	void _setColorState(const Color& clr, StateToggler tog)
+	{
+		if (clr.Length() > RT_EPSILON)
+			mState |= tog;
+		else
+			mState &= ~tog;
+	}
+private:
+	Color mAmbient, mDiffuse, mSpecular;	// 需要状态判断
+	Vec3 mDirection;
+public:
+	LightType mType;
+	Real mShininess;
+	Vec3 mPosition;
+	Real mSpotFallOff;
+	Real mSpotExponent;
+	Real mAttenuation0;
+	Real mAttenuation1;
+	Real mAttenuation2;
+	AABB mAABB;
+
+	int mState;
+};
+
+}; // namespace RayTracer
+
 #endif // _RT_PRIMITIVE_H_
\ No newline at end of file
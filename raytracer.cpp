@@ -1,554 +1,1233 @@
-/********************************************************************
-	created:	2010/04/13
-	file name:	raytracer.cpp
-	author:		maxint lnychina@gmail.com
-*********************************************************************/
-
-#include "raytracer.h"
-#include "scene.h"
-#include "primitive.h"
-#include "material.h"
-#include "twister.h"
-#include "Camera.h"
-
-#include <QImage>
-#include <ctime>
-
-#define SATURATE(x) ( ((x)>255) ? 255 : (((x)<0) ? 0 : (x)) )
-#define ROUND(x) int((x)+0.5)
-#define FAR_DISTANCE 1000000.0f
-#define MAX_RENDER_TIME 100
-
-#define REFRACTION_SHADE 0.3f
-
-namespace RayTracer {
-
-static const Vec3 EYE_POS(0, 0, -5);
-static const Color DEFAULT_COLOR(1.0f, 1.0f, 1.0f);
-
-#ifdef _DEBUG
-using std::cout;
-using std::endl;
-#endif
-
-Engine::Engine()
-: mScene(new Scene())
-, mCreated(false)
-, mTraceDepth(4)
-, mRegularSampleSize(3)
-, mTwister(new Twister())
-, mCamera(new CCamera())
-{
-	// initialize scene
-	mScene->initScene();
-#ifdef _DEBUG
-	cout << mTwister->Rand() << endl;
-#endif
-}
-
-Engine::~Engine()
-{
-	SAFE_DELETE(mScene);
-	SAFE_DELETE(mTwister);
-	SAFE_DELETE(mCamera);
-}
-
-void Engine::setRenderTarget(int _w, int _h, QImage *_img)
-{
-	mWidth = _w;
-	mHeight = _h;
-	mRatio = mWidth * 1.0f  / mHeight;
-	mImage = _img;
-
-	mCreated = true;
-}
-
-RTResult Engine::findNearest(const Ray& aRay, Real& aDist, Primitive*& aPrim)
-{
-	int i, gidx;
-	RTResult retval = MISS, ret;
-	// ϵ¼
-	Vec3 curPos = aRay.getOrigin();
-	Vec3 rayDir = aRay.getDir();
-	/*	NOTE1: ԣCellϵµĲҪСģΪCellһ㲻壬Ҫ
-		һ@vDelta
-		NOTE2ֱϵ¼㣬ֹͣжϿԸ
-	*/
-	Vec3 curCell, vStep, vOut;	// Cellϵ£
-	Vec3 vMax, vDelta;			// ϵ£С
-	Real tMinStep;
-	int tMinAxis;
-	Vec3 tIntPos;
-	bool tIsIntersected;
-
-	curCell = (curPos - mScene->getExtends().getMin()) * mRCS;
-	if ( !(curCell > 0.0f) || !(curCell < RT_GRIDSIZE) ) 
-		return MISS;
-
-	// DDA algorithm initialization
-	for (i=0; i<3; ++i)
-	{
-		if (rayDir[i] > 0)
-		{
-			vStep[i] = 1; 
-			vOut[i] = RT_GRIDSIZE;
-			vDelta[i] = mCS[i] / rayDir[i];
-			vMax[i] = (static_cast<int>(curCell[i]) + 1 - curCell[i]) * vDelta[i];
-		}
-		else if(rayDir[i] < 0)
-		{
-			vStep[i] = -1;
-			vOut[i] = -1;
-			vDelta[i] = -mCS[i] / rayDir[i];
-			vMax[i] = (curCell[i] - static_cast<int>(curCell[i])) * vDelta[i];
-		}
-		else 
-		{
-			vStep[i] = 0;
-			vOut[i] = 0;
-			vDelta[i] = 0;
-			vMax[i] = 1000000;
-		}
-		curCell[i] = floor(curCell[i]);
-	}
-	Scene::ObjectList *list = 0;
-	Scene::GridMap &grid = mScene->mGird;
-	Scene::ObjectItor oit, oit_end;
-	Primitive *prim;
-	int X, Y, Z;
-	// trace primary ray
-	while (1)
-	{
-		X = static_cast<int>(curCell.x);
-		Y = static_cast<int>(curCell.y);
-		Z = static_cast<int>(curCell.z);
-		gidx = X + (Y << RT_GRIDSHIFT) + (Z << (RT_GRIDSHIFT * 2));
-		list = grid[gidx];
-		tIsIntersected = false;
-		if (list)
-		{
-			oit = list->begin();
-			oit_end = list->end();
-			for (; oit!=oit_end; ++oit)
-			{
-				prim = *oit;
-				if (prim->getLastRayID() == aRay.getID() && aPrim == prim)
-				{
-					tIsIntersected = true;
-				}
-				else if ((ret = prim->intersect(aRay, aDist)) != MISS)
-				{
-					retval = ret;
-					aPrim = prim;
-					tIsIntersected = true;
-				}
-			}
-		}
-
-		// õСᣬһCell
-		tMinStep = vMax[0];
-		tMinAxis = 0;
-		for (i=1; i<3; ++i) if (vMax[i] < tMinStep)
-		{
-			tMinStep = vMax[i];
-			tMinAxis = i;
-		}
-
-		// жϽǷڵǰCellУǣҵ㣬˳
-		if (tIsIntersected && aDist < vMax[tMinAxis])
-			break;
-
-		curCell[tMinAxis] += vStep[tMinAxis];
-		if (curCell[tMinAxis] == vOut[tMinAxis])
-			return MISS;
-		vMax[tMinAxis] += vDelta[tMinAxis];
-	}
-	return retval;
-}
-
-Real Engine::calcShade(const Light* aLight, const Vec3& aIP, Vec3& aDir)
-{
-	//return 1.0f;
-
-	Real retval, tDist, tAtt;
-	Primitive *prim = 0;
-	int x, y;
-	Vec3 dim;
-	int tShadowed = 0;
-
-	// handle point light source
-	/*	1 for a visible lightPrim source
-		0 for an occluded lightPrim
-		*/
-	switch (aLight->mType)
-	{
-	case Light::LT_DIRECTIONAL:
-		aDir = aLight->getDirection();
-		// NOTE: offset׳ֺڵ
-		if (findNearest(Ray(aIP + aDir * RT_EPSILON, aDir, ++mCurRayID), tDist, prim) != MISS && 
-			!prim->isLight())
-		{
-			if (prim->getMaterial()->isRefraction())
-				retval = REFRACTION_SHADE; // ͸
-			else
-				retval = 0.0f;
-		}
-		else
-			retval = 1.0f;
-		break;
-
-	case Light::LT_POINT:
-		retval = 1.0f;
-		aDir = aLight->mPosition - aIP;
-		tDist = aDir.Length();
-		aDir *= (1.0f / tDist);
-		// NOTE: offset׳ֺڵ
-		if (findNearest(Ray(aIP + aDir * RT_EPSILON, aDir, ++mCurRayID), tDist, prim) != MISS && 
-			!prim->isLight())
-		{
-			if (prim->getMaterial()->isRefraction())
-				retval = REFRACTION_SHADE; // ͸
-			else
-				retval = 0.0f;
-		}
-		else
-		{
-			tAtt = 1.0 / (aLight->mAttenuation0 + aLight->mAttenuation1 * tDist +
-				aLight->mAttenuation2 * tDist * tDist);
-			retval *= tAtt;
-		}
-		break;
-	
-	case Light::LT_AREA:
-		retval = 0;
-		dim = aLight->mAABB.getDim();
-		aDir = aLight->mAABB.getMin() - aIP;
-		// NOTE: ٣жǷӰУھͲ
-		for (x=0; x<2; ++x) for (y=0; y<2; ++y)
-		{
-			Vec3 dir( aDir + dim * Vec3(x,y,y) );
-			tDist = dir.Length();
-			dir *= 1.0f / tDist;
-			if ( findNearest(Ray(aIP + dir * RT_EPSILON, dir, ++mCurRayID), tDist, prim) != MISS)
-			{
-				++tShadowed;
-				break;
-			}
-		}
-
-		if (tShadowed == 4) // fully in shadow
-			retval = 0;
-		else if (tShadowed == 0) // fully in light
-			retval = 1;
-		else
-		{ // partially in shadow
-			retval = 0;
-			for (x=0; x<mRegularSampleSize; ++x) for (y=0; y<mRegularSampleSize; ++y)
-			{
-				Vec3 dir( aDir + dim * (
-					Vec3(x+mTwister->Rand(),y+mTwister->Rand(),y+mTwister->Rand()) 
-					* mSampleScale) );
-				tDist = dir.Length();
-				dir *= 1.0f / tDist;
-				if (findNearest(Ray(aIP + dir * RT_EPSILON, dir, ++mCurRayID), tDist, prim) == MISS ||
-					prim->isLight())
-					retval += mSampleScale2;
-				else if (prim->getMaterial()->isRefraction()) // ͸
-					retval += mSampleScale2 * REFRACTION_SHADE;
-			}
-		}
-		if (retval != 0)
-		{
-			tAtt = 1.0 / (aLight->mAttenuation0 + aLight->mAttenuation1 * tDist +
-				aLight->mAttenuation2 * tDist * tDist);
-			retval *= tAtt;
-		}
-
-		aDir += 0.5f * dim;
-		aDir.Normalize();
-		break;
-
-	default:
-		break;
-	}
-
-	return retval;
-}
-
-Primitive* Engine::rayTrace(const RayTracer::Ray &aRay, 
-							Color &aAccClr, 
-							Real& aDist,
-							int aDepth, 
-							Real aRIndex)
-{
-	if (!mCreated || aDepth > mTraceDepth) 
-		return 0;
-
-	// trace primary ray
-	aDist = FAR_DISTANCE;
-	Vec3 pi, normDir, viewDir, lightDir, reflDir, transDir;
-	Ray shadowRay;
-	Scene::LightItor lit, lit_end;
-	Primitive *prim = 0;
-	Light *lightPrim = 0;
-	RTResult result = MISS;
-
-	viewDir = aRay.getDir();
-
-	// find the nearest intersection
-	result = findNearest(aRay, aDist, prim);
-	if (result == MISS) return 0;
-
-	Material *primMat = prim->getMaterial();
-
-	// handle intersection
-	if (prim->isLight())
-	{// we hit a lightPrim, stop tracing	
-		// NOTE: ӦۼӣȻʱֺܳڵ
-		aAccClr += DEFAULT_COLOR;
-	}
-	else
-	{// determine color at point of intersection
-		// intersection position
-		pi = aRay.getOrigin() + viewDir * aDist;
-		normDir = prim->getNormal(pi);
-		reflDir = viewDir - (2.0f * viewDir.Dot(normDir) * normDir);
-		Color color = prim->getColor(pi);
-
-		// trace lights
-		lit = mScene->mLights.begin();
-		lit_end = mScene->mLights.end();
-		for (; lit!=lit_end; ++lit)
-		{
-			lightPrim = *lit;
-
-			// 1. add ambient light
-			if (lightPrim->isAmbient() && primMat->isAmbient())
-				aAccClr += primMat->getAmbient() * lightPrim->getAmbient() * color;
-
-			/*	1 for a visible lightPrim source
-				0 for an occluded lightPrim
-				*/
-			Real shade = calcShade(lightPrim, pi, lightDir);
-
-			if (shade <=0 )
-				continue;
-
-			// 2. calculate diffuse shading
-			if (lightPrim->isDiffuse() && primMat->isDiffuse())
-			{
-				Real diffDot = lightDir.Dot(normDir);
-				if (diffDot > 0)
-					aAccClr += diffDot * shade * lightPrim->getDiffuse() * color;
-			}
-
-			// 3. calculate specular shading
-			if (lightPrim->isSpecular() && primMat->isSpecular())
-			{
-				// point lightPrim source: sample once for specular highlight
-				// viewDir.Dot(lightReflDir) == lightDir.Dot(reflDir)
-				Real specDot = lightDir.Dot(reflDir);
-				if (specDot > 0)
-					aAccClr += powf(specDot, primMat->getShininess()) * primMat->getSpecular()
-					* shade * lightPrim->getSpecular();
-			}
-		}//end for lights
-
-		// 4. calculate diffuse reflection
-		if (primMat->isReflection() && aDepth < mTraceDepth)
-		{
-			if (primMat->isDiffuseRefl() && aDepth < 2)
-			{
-				Real drefl = primMat->getDiffuseRefl();
-				Vec3 tRN1(reflDir.z, reflDir.y, -reflDir.x);
-				Vec3 tRN2 = reflDir.Cross(tRN1);
-				Real xoffs, yoffs;
-				Vec3 refl = primMat->getReflection() * mSampleScale2 * color;
-				for (int i=0; i<mRegularSampleSize*mRegularSampleSize; ++i)
-				{
-					do 
-					{
-						xoffs = (mTwister->Rand() - 0.5f) * 0.8f;
-						yoffs = (mTwister->Rand() - 0.5f) * 0.8f;
-					} while (xoffs * xoffs + yoffs * yoffs > 1.0f);
-					Vec3 tReflDir = reflDir + tRN1 * xoffs * drefl + tRN2 * yoffs * drefl;
-					tReflDir.Normalize();
-					Color rcol(0,0,0);
-					Real dist = 0;
-					if (rayTrace(Ray(pi + (tReflDir * RT_EPSILON), tReflDir, ++mCurRayID),
-						rcol, dist, aDepth+1, aRIndex) != 0)
-						aAccClr += refl * rcol;
-				}
-			}
-			else
-			{
-				Color rcol(0,0,0);
-				Real dist = 0;
-				if (rayTrace(Ray(pi + (reflDir * RT_EPSILON), reflDir, ++mCurRayID),
-					rcol, dist, aDepth+1, aRIndex) != 0)
-					aAccClr += rcol * primMat->getReflection();
-			}
-		}
-
-		// 5. calculate refraction
-		if (primMat->isRefraction() && aDepth < mTraceDepth)
-		{
-			Real rindex = primMat->getRefrIndex();
-			Real n = aRIndex / rindex; //  
-			if (result == INPRIM)
-				normDir *= -1.0f; // Ƿڵ
-			Real cosI = -normDir.Dot(viewDir); // 
-			Real cosT2 = 1.0f - n * n * (1.0f - cosI * cosI); // ƽ
-			if (cosT2 > 0.0f)
-			{
-				transDir = (n * viewDir) + (n * cosI - sqrtf(cosT2)) * normDir;
-				Color rcol(0,0,0);
-				Real dist = 0;
-				rayTrace(Ray(pi + transDir * RT_EPSILON, transDir, ++mCurRayID), rcol, dist, aDepth+1, rindex);
-				// apply Beer's law
-				if (n < 1.0f)
-				{ // ֻеڹߴӵʽʽʽʱż㣬ظ
-					Real absorbance = primMat->getRefraction() * 0.15f * -aDist;
-					aAccClr += rcol * expf(absorbance);
-				}
-				else
-					aAccClr += rcol;
-			}
-		}
-	}// end if it is not a lightPrim
-	return prim;
-}
-
-void Engine::initEngine(const Vec3& aEyePos, const Vec3& aTarget)
-{
-	if (!mCreated)
-		return;
-
-	// set first line to draw to
-	mCurrLine = 0;
-
-	// update camera
-	mCamera->lookAt(aEyePos, aTarget, Vec3::UNIT_Y);
-	mCamera->frustum(-mRatio, mRatio, -1, 1, 1);
-	//mCamera->perspective(RT_PI * 0.25f, mWidth * 1.0f / mHeight, );
-
-	// calculate data for regular grid stepping
-	mRCS = RT_GRIDSIZE / mScene->getExtends().getDim();
-	mCS = mScene->getExtends().getDim() / RT_GRIDSIZE;
-
-	// reset ray id counter
-	mCurRayID = 0;
-
-	// calculate deltas for interpolation
-	mDx = 1.0f / mWidth;
-	mDy = 1.0f / mHeight;
-	mSx = 0.0f;
-	mSy = mCurrLine * mDy;
-
-	// regular sampling
-	mSampleScale = 1.0f / mRegularSampleSize;
-	mSampleOffset = 0.5f  * mSampleScale;
-	mSampleScale2 = mSampleScale * mSampleScale;
-
-	// last line primitives recorder
-	mLastLinePrims.resize(mWidth, NULL);
-}
-
-Primitive* Engine::renderRay(Real x, Real y, Color& aAccClr)
-{
-	static Box extends(mScene->getExtends());
-	
-	Vec3 camPos = mCamera->pos();
-	Vec3 screenPos = mCamera->getScreenPos(x, y);
-	Vec3 dir = screenPos - camPos;
-	dir.Normalize();
-	Ray ray(camPos, dir, ++mCurRayID);
-
-	// advance ray to scene bounding box boundary
-	if (!extends.contains(camPos))
-	{
-		Real bdist = 10000.0f;
-		if (extends.intersect(ray, bdist))
-			ray.setOrigin(camPos + (bdist + RT_EPSILON) * dir);
-	}
-
-	Real dist;
-	return rayTrace(ray, aAccClr, dist, 1, 1.0f);
-}
-
-bool Engine::render()
-{
-	if (!mCreated)
-		return true;
-
-	clock_t tt = clock();
-
-	Primitive *lastPrim = 0, *currPrim;
-	Ray ray;
-	Real aaScale = 1.0f / 4.0f;
-
-	// render remaining lines
-	for (int y=mCurrLine; y<mHeight; ++y)
-	{
-		mSx = 0.0f;
-		// render pixels for current line
-		for (int x=0; x<mWidth; ++x)
-		{
-			// fire primary ray
-			Color finalClr(0,0,0);
-			currPrim = renderRay(mSx, mSy, finalClr);
-			// upsampling TOP LEFT 2 x 2
-			if (currPrim != lastPrim || 
-				mLastLinePrims[x] != currPrim ||
-				finalClr.Length() < RT_EPSILON) // NOTE: ֹƽཻڵж
-			{
-				lastPrim = currPrim;
-				mLastLinePrims[x] = currPrim;
-				// left
-				currPrim = renderRay(mSx - 0.5f*mDx, mSy, finalClr);
-				// top left
-				currPrim = renderRay(mSx - 0.5f*mDx, mSy + 0.5f*mDy, finalClr);
-				// top
-				currPrim = renderRay(mSx, mSy - 0.5f*mDy, finalClr);
-
-				finalClr *= aaScale;
-			}
-			_setFrameBuffer(y, x, finalClr);
-			mSx += mDx;
-		}
-		mSy += mDy;
-
-		// see if we've been working too long already
-		if (clock() - tt > MAX_RENDER_TIME)
-		{
-			mCurrLine = y+1;
-			if (mCurrLine != mHeight)
-			{
-				for (int x=0; x<mWidth; ++x)
-					_setFrameBuffer(mCurrLine, x, Color(1,1,1));
-			}
-			return false;
-		}
-	}
-	// all done
-	return true;
-}
-
-void Engine::_setFrameBuffer(int _y, int _x, const Color& _clr)
-{
-	Color color = _clr * 255.0f;
-	mImage->setPixel(_x, _y,
-		qRgb(SATURATE(color.r), SATURATE(color.g), SATURATE(color.b)) );
-}
-
-int Engine::getNumOfPrimitives() const
-{
-	return mScene->getNumOfPrimitives();
-}
-
-void Engine::loadObjModel(const trimeshVec::CAccessObj* accessObj)
-{
-	mScene->loadObjModel(accessObj);
-}
-
+/********************************************************************
+	created:	2010/04/13
+	file name:	raytracer.cpp
+	author:		maxint lnychina@gmail.com
+*********************************************************************/
+
+#include "raytracer.h"
+#include "scene.h"
+#include "primitive.h"
+#include "material.h"
+#include "twister.h"
+#include "Camera.h"
+#include "threadpool.h"
+#include "bvh.h"
+
+#include <functional>
+#include <cstring>
+
+#define SATURATE(x) ( ((x)>255) ? 255 : (((x)<0) ? 0 : (x)) )
+#define ROUND(x) int((x)+0.5)
+#define MAX_RENDER_TIME 100
+
+#define REFRACTION_SHADE 0.3f
+
+// secondary rays start off the surface by a number of ulps of the hit position,
+// or by a fixed distance close to the origin where ulps get too small
+#ifdef HIGH_PRECISION
+#define RT_OFFSET_SCALE		2.8421709430404007e-14	// 2^-45
+typedef long long RealBits;
+#else
+#define RT_OFFSET_SCALE		(1.0f / 65536.0f)
+typedef int RealBits;
+#endif
+#define RT_OFFSET_ULPS		256.0f
+#define RT_OFFSET_ORIGIN	(1.0f / 32.0f)
+
+// primary rays of a packet cover a block of RT_PACKET_W x RT_PACKET_H pixels
+#define RT_PACKET_W	((RT_PACKETSIZE >= 8) ? 4 : 2)
+#define RT_PACKET_H	(RT_PACKETSIZE / RT_PACKET_W)
+
+namespace RayTracer {
+
+static const Vec3 EYE_POS(0, 0, -5);
+static const Color DEFAULT_COLOR(1.0f, 1.0f, 1.0f);
+/// contrast per channel above which AA_ADAPTIVE splits a square, the eye is
+/// the most sensitive to green
+static const Color AA_CONTRAST(0.4f, 0.3f, 0.6f);
+
+#ifdef _DEBUG
+using std::cout;
+using std::endl;
+#endif
+
+/**	Move a hit position off the surface to the side of @aN, so the rays 
+	leaving from it do not hit the surface again. The offset follows the 
+	rounding error of the position instead of a fixed epsilon, which works 
+	for both precisions and any scene scale.
+ */
+static Vec3 offsetRayOrigin(const Vec3& aPos, const Vec3& aN)
+{
+	Vec3 pos;
+	for (int i=0; i<3; ++i)
+	{
+		if (std::abs(aPos[i]) < RT_OFFSET_ORIGIN)
+		{
+			pos[i] = aPos[i] + RT_OFFSET_SCALE * aN[i];
+			continue;
+		}
+		RealBits bits, ulps = static_cast<RealBits>(RT_OFFSET_ULPS * aN[i]);
+		std::memcpy(&bits, &aPos.cell[i], sizeof(Real));
+		bits += (aPos[i] < 0) ? -ulps : ulps;
+		std::memcpy(&pos[i], &bits, sizeof(Real));
+	}
+	return pos;
+}
+
+// ------------------------------------------------------------------------------
+// RayPacket class implementation
+// ------------------------------------------------------------------------------
+
+bool RayPacket::finish()
+{
+	int first = 0;
+	while (first < SIZE && !(mActive & (1 << first)))
+		++first;
+	if (first == SIZE)
+		return false;
+
+	int i, k;
+	// NOTE: the copies keep the SIMD lanes busy with valid numbers
+	for (i=0; i<SIZE; ++i)
+	{
+		if (mActive & (1 << i))
+			continue;
+		for (k=0; k<3; ++k)
+		{
+			mOrigin[k][i] = mOrigin[k][first];
+			mDir[k][i] = mDir[k][first];
+			mInvDir[k][i] = mInvDir[k][first];
+		}
+	}
+
+	for (k=0; k<3; ++k)
+	{
+		mDirNeg[k] = mInvDir[k][first] < 0;
+		for (i=first+1; i<SIZE; ++i)
+		{
+			if ((mInvDir[k][i] < 0) != mDirNeg[k])
+				return false;
+		}
+	}
+	return true;
+}
+
+// ------------------------------------------------------------------------------
+// Engine class implementation
+// ------------------------------------------------------------------------------
+
+Engine::Engine()
+: mScene(new Scene())
+, mCreated(false)
+, mTraceDepth(4)
+, mRegularSampleSize(3)
+, mCamera(new CCamera())
+, mPacketTracing(true)
+, mAntiAlias(AA_EDGE)
+, mAdaptiveDepth(2)
+, mShadingReuse(false)
+, mPool(0)
+, mTilesX(0)
+, mTilesY(0)
+, mStarted(false)
+, mCancel(false)
+, mTilesDone(0)
+{
+	// one worker per hardware thread, they also build the scene
+	_createWorkers(0);
+
+	// initialize scene
+	mScene->initScene();
+}
+
+Engine::~Engine()
+{
+	_stopRender();
+	_destroyWorkers();
+	SAFE_DELETE(mScene);
+	SAFE_DELETE(mCamera);
+}
+
+void Engine::setRenderTarget(int _w, int _h)
+{
+	_stopRender();
+
+	mWidth = _w;
+	mHeight = _h;
+	mRatio = mWidth * 1.0f  / mHeight;
+	mFrameBuffer.resize(mWidth, mHeight);
+
+	mCreated = true;
+}
+
+void Engine::_createWorkers(int aNumThreads)
+{
+	mPool = new ThreadPool(aNumThreads);
+	for (int i=0; i<mPool->getNumThreads(); ++i)
+		mContexts.push_back(new RenderContext);
+	mScene->setBuildPool(mPool);
+}
+
+void Engine::_destroyWorkers()
+{
+	mScene->setBuildPool(NULL);
+	SAFE_DELETE(mPool);
+	for (size_t i=0; i<mContexts.size(); ++i)
+		SAFE_DELETE(mContexts[i]);
+	mContexts.clear();
+}
+
+int Engine::getNumThreads() const
+{
+	return mPool->getNumThreads();
+}
+
+void Engine::setNumThreads(int val)
+{
+	_stopRender();
+	_destroyWorkers();
+	_createWorkers(val);
+}
+
+RTResult Engine::findNearest(RenderContext& aCtx, const Ray& aRay, HitRecord& aHit) const
+{
+	// NOTE: 无界物体（平面）不在加速结构中，每条光线只求交一次
+	bool found = false;
+	const Scene::PrimArray &unbounded = mScene->mUnbounded;
+	RT_STAT(aCtx.mStats, STAT_PRIM_TESTS, unbounded.size());
+	for (size_t i=0; i<unbounded.size(); ++i)
+	{
+		if (unbounded[i]->intersect(aRay, aHit) != MISS)
+			found = true;
+	}
+
+	RTResult result;
+	if (mScene->usesBVH())
+		result = mScene->mBVH->intersect(aRay, aHit, aCtx.mStats);
+	else
+		result = _findNearestInGrid(aCtx, aRay, aHit);
+
+	if (result != MISS)
+		return result;
+	return found ? aHit.mResult : MISS;
+}
+
+int Engine::findNearest(RenderContext& aCtx, const RayPacket& aPacket, PacketHit& aHit) const
+{
+	int hitMask = 0;
+	const Scene::PrimArray &unbounded = mScene->mUnbounded;
+	RT_STAT(aCtx.mStats, STAT_PRIM_TESTS, unbounded.size());
+	for (size_t i=0; i<unbounded.size(); ++i)
+		hitMask |= unbounded[i]->intersectPacket(aPacket, aHit, aPacket.getActive());
+	return hitMask | mScene->mBVH->intersectPacket(aPacket, aHit, aCtx.mStats);
+}
+
+/// grid visitor of findNearest(), every cell up to the nearest hit
+class NearestVisitor
+{
+public:
+	NearestVisitor(const Ray& aRay, HitRecord& aHit)
+		: mRay(aRay), mHit(aHit), mFound(false)
+	{}
+	Real getLimit() const { return mHit.mDist; }
+	bool visit(const Primitive* aPrim)
+	{
+		if (aPrim->intersect(mRay, mHit) != MISS)
+			mFound = true;
+		return false;
+	}
+
+	const Ray& mRay;
+	HitRecord& mHit;
+	bool mFound;
+};
+
+/// grid visitor of findOcclusion(), stops at the first opaque primitive
+class OcclusionVisitor
+{
+public:
+	OcclusionVisitor(const Ray& aRay, Real aMaxDist)
+		: mRay(aRay), mMaxDist(aMaxDist), mResult(OC_NONE), mOccluder(0)
+	{}
+	Real getLimit() const { return mMaxDist; }
+	bool visit(const Primitive* aPrim)
+	{
+		HitRecord hit(mMaxDist);
+		if (aPrim->intersect(mRay, hit) == MISS)
+			return false;
+		mResult = std::max(mResult, aPrim->getOcclusion());
+		if (mResult != OC_OPAQUE)
+			return false;
+		mOccluder = aPrim;
+		return true;
+	}
+
+	const Ray& mRay;
+	Real mMaxDist;
+	Occlusion mResult;
+	const Primitive* mOccluder;
+};
+
+template <class Visitor>
+void Engine::_walkGrid(RenderContext& aCtx, const Ray& aRay, Visitor& aVisitor) const
+{
+	if (mScene->mCellPrims.empty())
+		return;
+	int i, gidx;
+	// 在世界坐标系下计算
+	const Vec3 &rayOrig = aRay.getOrigin();
+	const Vec3 &rayDir = aRay.getDir();
+	const AABB &extends = mScene->getExtends();
+	/*	NOTE1: 经调试，Cell坐标系下的步进要小心，因为Cell一般不是正方体，所以要
+		规一化@vDelta步进。
+		NOTE2：如果直接在世界坐标系下计算，停止条件判断可以更简单
+	*/
+	int cell[3], vStep[3], vOut[3];	// Cell坐标系下，整数步进
+	Vec3 vMax, vDelta;				// 在世界坐标系下，小数步进
+	Vec3 curCell;
+	int tMinAxis;
+	const int size[3] = { 
+		mScene->getGridSize(0), mScene->getGridSize(1), mScene->getGridSize(2) };
+
+	// clip the ray to the extends, it may start outside (reflected rays etc.)
+	Real tEnter = 0, tExit = aVisitor.getLimit();
+	for (i=0; i<3; ++i)
+	{
+		if (rayDir[i] != 0)
+		{
+			Real t0 = (extends.getMin()[i] - rayOrig[i]) / rayDir[i];
+			Real t1 = (extends.getMax()[i] - rayOrig[i]) / rayDir[i];
+			if (t0 > t1)
+				std::swap(t0, t1);
+			tEnter = std::max(tEnter, t0);
+			tExit = std::min(tExit, t1);
+		}
+		else if (rayOrig[i] < extends.getMin()[i] || rayOrig[i] > extends.getMax()[i])
+		{
+			return;
+		}
+	}
+	if (tEnter > tExit)
+		return;
+	curCell = (rayOrig + rayDir * tEnter - extends.getMin()) * mRCS;
+
+	// DDA algorithm initialization
+	for (i=0; i<3; ++i)
+	{
+		cell[i] = std::max(0, std::min(static_cast<int>(floor(curCell[i])), size[i] - 1));
+		if (rayDir[i] > 0)
+		{
+			vStep[i] = 1; 
+			vOut[i] = size[i];
+			vDelta[i] = mCS[i] / rayDir[i];
+			vMax[i] = tEnter + std::max(Real(0), cell[i] + 1 - curCell[i]) * vDelta[i];
+		}
+		else if(rayDir[i] < 0)
+		{
+			vStep[i] = -1;
+			vOut[i] = -1;
+			vDelta[i] = -mCS[i] / rayDir[i];
+			vMax[i] = tEnter + std::max(Real(0), curCell[i] - cell[i]) * vDelta[i];
+		}
+		else 
+		{
+			vStep[i] = 0;
+			vOut[i] = -1;
+			vDelta[i] = 0;
+			vMax[i] = FAR_DISTANCE;
+		}
+	}
+	const int *offsets = &mScene->mCellOffsets[0];
+	const int *cellPrims = &mScene->mCellPrims[0];
+	const Primitive* const *primTable = &mScene->mPrimTable[0];
+	Mailbox &mailbox = aCtx.mMailbox;
+	mailbox.nextRay();
+	RT_STAT(aCtx.mStats, STAT_TRAVERSALS, 1);
+	const Primitive *prim;
+	int first, last, primIdx;
+	// trace primary ray
+	while (1)
+	{
+		gidx = cell[0] + (cell[1] + cell[2] * size[1]) * size[0];
+		first = offsets[gidx];
+		last = offsets[gidx + 1];
+		RT_STAT(aCtx.mStats, STAT_GRID_CELLS, 1);
+		for (; first!=last; ++first)
+		{
+			// NOTE: 跨多个Cell的物体只求交一次
+			primIdx = cellPrims[first];
+			if (!mailbox.isTested(primIdx))
+			{
+				mailbox.setTested(primIdx);
+				prim = primTable[primIdx];
+				RT_STAT(aCtx.mStats, STAT_PRIM_TESTS, 1);
+				if (aVisitor.visit(prim))
+					return;
+			}
+			else
+			{
+				RT_STAT(aCtx.mStats, STAT_MAILBOX_SKIPS, 1);
+			}
+		}
+
+		// 得到步进最小轴，并进入下一个Cell
+		tMinAxis = 0;
+		for (i=1; i<3; ++i) if (vMax[i] < vMax[tMinAxis])
+			tMinAxis = i;
+
+		/*	最近交点（或搜索上限）在当前Cell中，后面的Cell不会更近，退出
+			NOTE: 物体的交点可能在后面的Cell中，所以不能一找到交点就退出
+		*/
+		if (aVisitor.getLimit() < vMax[tMinAxis])
+			break;
+
+		cell[tMinAxis] += vStep[tMinAxis];
+		if (cell[tMinAxis] == vOut[tMinAxis])
+			break;
+		vMax[tMinAxis] += vDelta[tMinAxis];
+	}
+}
+
+RTResult Engine::_findNearestInGrid(RenderContext& aCtx, const Ray& aRay, HitRecord& aHit) const
+{
+	NearestVisitor visitor(aRay, aHit);
+	_walkGrid(aCtx, aRay, visitor);
+	return visitor.mFound ? aHit.mResult : MISS;
+}
+
+Occlusion Engine::findOcclusion(RenderContext& aCtx, const Ray& aRay, Real aMaxDist, 
+								const Primitive** aOccluder) const
+{
+	++aCtx.mStats.mRays[RAY_SHADOW];
+	Occlusion result = OC_NONE;
+	const Primitive *occluder = 0;
+	const Scene::PrimArray &unbounded = mScene->mUnbounded;
+	for (size_t i=0; i<unbounded.size() && result!=OC_OPAQUE; ++i)
+	{
+		RT_STAT(aCtx.mStats, STAT_PRIM_TESTS, 1);
+		HitRecord hit(aMaxDist);
+		if (unbounded[i]->intersect(aRay, hit) != MISS)
+		{
+			result = std::max(result, unbounded[i]->getOcclusion());
+			occluder = unbounded[i];
+		}
+	}
+
+	if (result != OC_OPAQUE)
+	{
+		if (mScene->usesBVH())
+		{
+			result = std::max(result, mScene->mBVH->findOcclusion(aRay, aMaxDist, occluder, aCtx.mStats));
+		}
+		else
+		{
+			OcclusionVisitor visitor(aRay, aMaxDist);
+			_walkGrid(aCtx, aRay, visitor);
+			result = std::max(result, visitor.mResult);
+			occluder = visitor.mOccluder;
+		}
+	}
+
+	if (aOccluder && result == OC_OPAQUE)
+		*aOccluder = occluder;
+	return result;
+}
+
+Occlusion Engine::_findOcclusionCached(RenderContext& aCtx, int aLightIndex, 
+									   const Ray& aRay, Real aMaxDist) const
+{
+	ShadowCache &cache = aCtx.mShadowCache;
+	const Primitive *&occluder = cache.getOccluder(aLightIndex);
+	if (occluder)
+	{
+		HitRecord hit(aMaxDist);
+		RT_STAT(aCtx.mStats, STAT_PRIM_TESTS, 1);
+		if (occluder->intersect(aRay, hit) != MISS)
+		{
+			++aCtx.mStats.mRays[RAY_SHADOW];
+			++cache.mBlocked;
+			++cache.mHits;
+			return OC_OPAQUE;
+		}
+	}
+	// NOTE: a lit pixel keeps the old occluder, the next shadowed one likely shares it
+	Occlusion result = findOcclusion(aCtx, aRay, aMaxDist, &occluder);
+	if (result == OC_OPAQUE)
+		++cache.mBlocked;
+	return result;
+}
+
+/**	Whether the colors of the corners of a square differ enough to split 
+	it, by the contrast (max - min) / (max + min) of each channel. Differences
+	below one step of the frame buffer are never visible.
+ */
+static bool isContrasted(const Color* aCorners[4])
+{
+	for (int c=0; c<3; ++c)
+	{
+		Real lo = 1, hi = 0;
+		for (int i=0; i<4; ++i)
+		{
+			Real v = RT_CLAMP((*aCorners[i])[c], 0, 1);
+			lo = std::min(lo, v);
+			hi = std::max(hi, v);
+		}
+		if (hi - lo > 1.0f / 255 && hi - lo > AA_CONTRAST[c] * (hi + lo))
+			return true;
+	}
+	return false;
+}
+
+/**	Surface a primary sample landed on. The triangles of a dense mesh are 
+	all different primitives, comparing their materials instead splits at 
+	the silhouettes and at the material borders only.
+ */
+static inline const Material* sampleSurface(const SampleLattice::Sample* aSample)
+{
+	return aSample->mPrim ? aSample->mPrim->getMaterial() : 0;
+}
+
+/// fraction of the light passing a shadow ray
+static inline Real occlusionShade(Occlusion aOcclusion)
+{
+	if (aOcclusion == OC_NONE)
+		return 1.0f;
+	return (aOcclusion == OC_TRANSLUCENT) ? REFRACTION_SHADE : 0.0f; // 可透射物体
+}
+
+Real Engine::calcShade(RenderContext& aCtx, const Light* aLight, int aLightIndex, 
+					   const Vec3& aIP, const Vec3& aN, Vec3& aDir)
+{
+	//return 1.0f;
+
+	Real retval = 0, tDist, tAtt;
+	int x, y;
+	Vec3 dim;
+	int tShadowed = 0;
+
+	// handle point light source
+	/*	1 for a visible lightPrim source
+		0 for an occluded lightPrim
+		NOTE: a light behind the surface is occluded by the surface itself, 
+		no shadow ray is needed
+		*/
+	switch (aLight->mType)
+	{
+	case Light::LT_DIRECTIONAL:
+		aDir = aLight->getDirection();
+		if (aDir.Dot(aN) > 0)
+			retval = occlusionShade(_findOcclusionCached(aCtx, aLightIndex, Ray(aIP, aDir), FAR_DISTANCE));
+		break;
+
+	case Light::LT_POINT:
+		aDir = aLight->mPosition - aIP;
+		tDist = aDir.Length();
+		aDir *= (1.0f / tDist);
+		if (aDir.Dot(aN) <= 0)
+			break;
+		retval = occlusionShade(_findOcclusionCached(aCtx, aLightIndex, Ray(aIP, aDir), tDist));
+		if (retval == 1.0f)
+		{
+			tAtt = 1.0 / (aLight->mAttenuation0 + aLight->mAttenuation1 * tDist +
+				aLight->mAttenuation2 * tDist * tDist);
+			retval *= tAtt;
+		}
+		break;
+	
+	case Light::LT_AREA:
+		retval = 0;
+		dim = aLight->mAABB.getDim();
+		aDir = aLight->mAABB.getMin() - aIP;
+		// NOTE: 加速，大致判断是否在阴影中，如果不在就不采样了
+		for (x=0; x<2; ++x) for (y=0; y<2; ++y)
+		{
+			Vec3 dir( aDir + dim * Vec3(x,y,y) );
+			tDist = dir.Length();
+			dir *= 1.0f / tDist;
+			if (dir.Dot(aN) <= 0 || findOcclusion(aCtx, Ray(aIP, dir), tDist) != OC_NONE)
+			{
+				++tShadowed;
+				break;
+			}
+		}
+
+		if (tShadowed == 4) // fully in shadow
+			retval = 0;
+		else if (tShadowed == 0) // fully in light
+			retval = 1;
+		else
+		{ // partially in shadow
+			retval = 0;
+			for (x=0; x<mRegularSampleSize; ++x) for (y=0; y<mRegularSampleSize; ++y)
+			{
+				Vec3 dir( aDir + dim * (
+					Vec3(x+aCtx.mTwister.Rand(),y+aCtx.mTwister.Rand(),y+aCtx.mTwister.Rand()) 
+					* mSampleScale) );
+				tDist = dir.Length();
+				dir *= 1.0f / tDist;
+				RT_STAT(aCtx.mStats, STAT_AREA_SAMPLES, 1);
+				if (dir.Dot(aN) > 0)
+					retval += mSampleScale2 * occlusionShade(findOcclusion(aCtx, Ray(aIP, dir), tDist));
+			}
+		}
+		if (retval != 0)
+		{
+			tAtt = 1.0 / (aLight->mAttenuation0 + aLight->mAttenuation1 * tDist +
+				aLight->mAttenuation2 * tDist * tDist);
+			retval *= tAtt;
+		}
+
+		aDir += 0.5f * dim;
+		aDir.Normalize();
+		break;
+
+	default:
+		break;
+	}
+
+	return retval;
+}
+
+const Primitive* Engine::rayTrace(RenderContext& aCtx,
+							const RayTracer::Ray &aRay, 
+							Color &aAccClr, 
+							Real& aDist,
+							int aDepth, 
+							Real aRIndex)
+{
+	if (!mCreated || aDepth > mTraceDepth) 
+		return 0;
+
+	// trace primary ray
+	aDist = FAR_DISTANCE;
+	HitRecord hit;
+
+	// find the nearest intersection
+	if (findNearest(aCtx, aRay, hit) == MISS)
+		return 0;
+	aDist = hit.mDist;
+	return _shadeHit(aCtx, aRay, hit, aAccClr, aDepth, aRIndex);
+}
+
+const Primitive* Engine::_shadeHit(RenderContext& aCtx,
+								   const Ray& aRay,
+								   const HitRecord& aHit,
+								   Color& aAccClr,
+								   int aDepth,
+								   Real aRIndex)
+{
+	Vec3 pi, piFront, normDir, frontDir, viewDir, lightDir, reflDir, transDir;
+	Scene::LightItor lit, lit_end;
+	Light *lightPrim = 0;
+	const RTResult result = aHit.mResult;
+	const Real aDist = aHit.mDist;
+	const Primitive *prim = aHit.mPrim;
+
+	viewDir = aRay.getDir();
+	Material *primMat = prim->getMaterial();
+
+	// handle intersection
+	if (prim->isLight())
+	{// we hit a lightPrim, stop tracing	
+		// NOTE: 应该是累加，不然反走样时可能出现黑点
+		aAccClr += DEFAULT_COLOR;
+	}
+	else
+	{// determine color at point of intersection
+		// intersection position
+		pi = aRay.getOrigin() + viewDir * aDist;
+		normDir = prim->getNormal(aHit, pi);
+		reflDir = viewDir - (2.0f * viewDir.Dot(normDir) * normDir);
+		Color color = prim->getColor(aHit, pi);
+
+		// shadow and reflected rays leave from the side facing the viewer
+		frontDir = (viewDir.Dot(normDir) < 0) ? normDir : -normDir;
+		piFront = offsetRayOrigin(pi, frontDir);
+
+		// trace lights
+		lit = mScene->mLights.begin();
+		lit_end = mScene->mLights.end();
+		for (int lightIndex=0; lit!=lit_end; ++lit, ++lightIndex)
+		{
+			lightPrim = *lit;
+
+			// 1. add ambient light
+			if (lightPrim->isAmbient() && primMat->isAmbient())
+				aAccClr += primMat->getAmbient() * lightPrim->getAmbient() * color;
+
+			/*	1 for a visible lightPrim source
+				0 for an occluded lightPrim
+				*/
+			Real shade = calcShade(aCtx, lightPrim, lightIndex, piFront, frontDir, lightDir);
+
+			if (shade <=0 )
+				continue;
+
+			// 2. calculate diffuse shading
+			if (lightPrim->isDiffuse() && primMat->isDiffuse())
+			{
+				Real diffDot = lightDir.Dot(normDir);
+				if (diffDot > 0)
+					aAccClr += diffDot * shade * lightPrim->getDiffuse() * color;
+			}
+
+			// 3. calculate specular shading
+			if (lightPrim->isSpecular() && primMat->isSpecular())
+			{
+				// point lightPrim source: sample once for specular highlight
+				// viewDir.Dot(lightReflDir) == lightDir.Dot(reflDir)
+				Real specDot = lightDir.Dot(reflDir);
+				if (specDot > 0)
+					aAccClr += powf(specDot, primMat->getShininess()) * primMat->getSpecular()
+					* shade * lightPrim->getSpecular();
+			}
+		}//end for lights
+
+		// 4. calculate diffuse reflection
+		if (primMat->isReflection() && aDepth < mTraceDepth)
+		{
+			if (primMat->isDiffuseRefl() && aDepth < 2)
+			{
+				Real drefl = primMat->getDiffuseRefl();
+				Vec3 tRN1(reflDir.z, reflDir.y, -reflDir.x);
+				Vec3 tRN2 = reflDir.Cross(tRN1);
+				Real xoffs, yoffs;
+				Vec3 refl = primMat->getReflection() * mSampleScale2 * color;
+				for (int i=0; i<mRegularSampleSize*mRegularSampleSize; ++i)
+				{
+					do 
+					{
+						xoffs = (aCtx.mTwister.Rand() - 0.5f) * 0.8f;
+						yoffs = (aCtx.mTwister.Rand() - 0.5f) * 0.8f;
+					} while (xoffs * xoffs + yoffs * yoffs > 1.0f);
+					Vec3 tReflDir = reflDir + tRN1 * xoffs * drefl + tRN2 * yoffs * drefl;
+					tReflDir.Normalize();
+					Color rcol(0,0,0);
+					Real dist = 0;
+					++aCtx.mStats.mRays[RAY_GLOSSY];
+					if (rayTrace(aCtx, Ray(piFront, tReflDir),
+						rcol, dist, aDepth+1, aRIndex) != 0)
+						aAccClr += refl * rcol;
+				}
+			}
+			else
+			{
+				Color rcol(0,0,0);
+				Real dist = 0;
+				++aCtx.mStats.mRays[RAY_REFLECTION];
+				if (rayTrace(aCtx, Ray(piFront, reflDir),
+					rcol, dist, aDepth+1, aRIndex) != 0)
+					aAccClr += rcol * primMat->getReflection();
+			}
+		}
+
+		// 5. calculate refraction
+		if (primMat->isRefraction() && aDepth < mTraceDepth)
+		{
+			Real rindex = primMat->getRefrIndex();
+			Real n = aRIndex / rindex; //  折射率
+			if (result == INPRIM)
+				normDir *= -1.0f; // 根据是否在物体内调整法向
+			Real cosI = -normDir.Dot(viewDir); // 入射角余弦
+			Real cosT2 = 1.0f - n * n * (1.0f - cosI * cosI); // 出射角余弦平方
+			if (cosT2 > 0.0f)
+			{
+				transDir = (n * viewDir) + (n * cosI - sqrtf(cosT2)) * normDir;
+				Color rcol(0,0,0);
+				Real dist = 0;
+				++aCtx.mStats.mRays[RAY_REFRACTION];
+				rayTrace(aCtx, Ray(offsetRayOrigin(pi, -frontDir), transDir), rcol, dist, aDepth+1, rindex);
+				// apply Beer's law
+				if (n < 1.0f)
+				{ // 只有当在光线从低折射率介质进入高折射率介质时才计算，避免重复计算
+					Real absorbance = primMat->getRefraction() * 0.15f * -aDist;
+					aAccClr += rcol * expf(absorbance);
+				}
+				else
+					aAccClr += rcol;
+			}
+		}
+	}// end if it is not a lightPrim
+	return prim;
+}
+
+void Engine::initEngine(const Vec3& aEyePos, const Vec3& aTarget)
+{
+	if (!mCreated)
+		return;
+
+	// the workers read everything below
+	_stopRender();
+
+	// update camera
+	mCamera->lookAt(aEyePos, aTarget, Vec3::UNIT_Y);
+	mCamera->frustum(-mRatio, mRatio, -1, 1, 1);
+	//mCamera->perspective(RT_PI * 0.25f, mWidth * 1.0f / mHeight, );
+	mCamera->update();
+
+	// calculate data for regular grid stepping
+	Vec3 gridSize(mScene->getGridSize(0), mScene->getGridSize(1), mScene->getGridSize(2));
+	mRCS = gridSize / mScene->getExtends().getDim();
+	mCS = mScene->getExtends().getDim() / gridSize;
+
+	// calculate deltas for interpolation
+	mDx = 1.0f / mWidth;
+	mDy = 1.0f / mHeight;
+
+	// regular sampling
+	mSampleScale = 1.0f / mRegularSampleSize;
+	mSampleOffset = 0.5f  * mSampleScale;
+	mSampleScale2 = mSampleScale * mSampleScale;
+
+	// reset tiles
+	mTilesX = (mWidth + RT_TILESIZE - 1) / RT_TILESIZE;
+	mTilesY = (mHeight + RT_TILESIZE - 1) / RT_TILESIZE;
+	mTilesDone = 0;
+	mFinishedTiles.clear();
+	for (size_t i=0; i<mContexts.size(); ++i)
+	{
+		mContexts[i]->mShadowCache.clear(mScene->getNumOfLights());
+		mContexts[i]->mStats.clear();
+	}
+}
+
+Ray Engine::_primaryRay(Real x, Real y)
+{
+	Vec3 camPos = mCamera->pos();
+	Vec3 screenPos = mCamera->getScreenPos(x, y);
+	Vec3 dir = screenPos - camPos;
+	dir.Normalize();
+	return Ray(camPos, dir);
+}
+
+const Primitive* Engine::renderRay(RenderContext& aCtx, Real x, Real y, Color& aAccClr)
+{
+	Real dist;
+	++aCtx.mStats.mRays[RAY_PRIMARY];
+	return rayTrace(aCtx, _primaryRay(x, y), aAccClr, dist, 1, 1.0f);
+}
+
+const Primitive* Engine::_primaryHit(RenderContext& aCtx, Real x, Real y)
+{
+	HitRecord hit;
+	++aCtx.mStats.mRays[RAY_PRIMARY];
+	findNearest(aCtx, _primaryRay(x, y), hit);
+	return hit.mPrim;
+}
+
+bool Engine::render(std::vector<int>* aTiles)
+{
+	if (!mCreated)
+		return true;
+
+	if (!mStarted)
+	{
+		mStarted = true;
+		for (int i=0; i<mTilesX*mTilesY; ++i)
+			mPool->submit(std::bind(&Engine::_renderTile, this, i, std::placeholders::_1));
+	}
+
+	// see if we've been working too long already
+	bool finished = mPool->waitFor(MAX_RENDER_TIME);
+	if (finished)
+	{
+		// the workers are idle, merge their counters of the frame
+		mStats.clear();
+		for (size_t i=0; i<mContexts.size(); ++i)
+			mStats.merge(mContexts[i]->mStats);
+	}
+	std::lock_guard<std::mutex> lock(mFinishedMutex);
+	if (aTiles)
+		aTiles->swap(mFinishedTiles);
+	mFinishedTiles.clear();
+	return finished;
+}
+
+void Engine::cancel()
+{
+	mCancel = true;
+}
+
+void Engine::getTileRect(int aTile, int& aX0, int& aY0, int& aX1, int& aY1) const
+{
+	aX0 = (aTile % mTilesX) * RT_TILESIZE;
+	aY0 = (aTile / mTilesX) * RT_TILESIZE;
+	aX1 = std::min(aX0 + RT_TILESIZE, mWidth);
+	aY1 = std::min(aY0 + RT_TILESIZE, mHeight);
+}
+
+void Engine::_renderTile(int aTile, int aWorker)
+{
+	if (mCancel)
+		return;
+
+	RenderContext &ctx = *mContexts[aWorker];
+	// NOTE: 按tile播种，结果与哪个线程渲染无关
+	ctx.mTwister.Seed(aTile + 1);
+
+	int x0, y0, x1, y1;
+	getTileRect(aTile, x0, y0, x1, y1);
+	if (mAntiAlias == AA_ADAPTIVE)
+		_renderAdaptive(ctx, x0, y0, x1, y1);
+	else
+		_renderPixels(ctx, x0, y0, x1, y1);
+	if (mCancel)
+		return;
+
+	std::lock_guard<std::mutex> lock(mFinishedMutex);
+	mFinishedTiles.push_back(aTile);
+	++mTilesDone;
+}
+
+void Engine::_renderPixels(RenderContext& aCtx, int aX0, int aY0, int aX1, int aY1)
+{
+	const Real aaScale = 1.0f / 4.0f;
+	const bool upsample = (mAntiAlias == AA_EDGE);
+
+	/*	Primary hits of the tile with an apron of one pixel at the left and 
+		top, so the upsampling decision only depends on the pixel position, 
+		not on the order the tiles are rendered in.
+		Neighbours outside the image count as empty.
+	 */
+	const int stride = RT_TILESIZE + 1;
+	const Primitive *prims[(RT_TILESIZE + 1) * (RT_TILESIZE + 1)];
+	Color colors[(RT_TILESIZE + 1) * (RT_TILESIZE + 1)];
+	int x, y;
+	if (upsample)
+	{
+		prims[0] = 0;
+		for (x=aX0; x<aX1; ++x)
+			prims[x - aX0 + 1] = (aY0 > 0) ? _primaryHit(aCtx, x * mDx, (aY0 - 1) * mDy) : 0;
+		for (y=aY0; y<aY1; ++y)
+			prims[(y - aY0 + 1) * stride] = (aX0 > 0) ? _primaryHit(aCtx, (aX0 - 1) * mDx, y * mDy) : 0;
+	}
+
+	// shade the primary rays first, a block of pixels at a time
+	for (y=aY0; y<aY1; y+=RT_PACKET_H)
+	{
+		for (x=aX0; x<aX1; x+=RT_PACKET_W)
+		{
+			int idx = (y - aY0 + 1) * stride + (x - aX0 + 1);
+			_renderPrimary(aCtx, x, y, std::min(x + RT_PACKET_W, aX1), 
+				std::min(y + RT_PACKET_H, aY1), 0, &colors[idx], &prims[idx], stride);
+		}
+		if (mCancel)
+			return;
+	}
+
+	const Primitive *currPrim;
+	for (y=aY0; y<aY1; ++y)
+	{
+		Real sy = y * mDy;
+		for (x=aX0; x<aX1; ++x)
+		{
+			Real sx = x * mDx;
+			int idx = (y - aY0 + 1) * stride + (x - aX0 + 1);
+			Color finalClr = colors[idx];
+			currPrim = prims[idx];
+
+			// upsampling TOP LEFT 2 x 2
+			if (upsample && 
+				(currPrim != prims[idx - 1] || 
+				currPrim != prims[idx - stride] ||
+				finalClr.Length() < RT_EPSILON)) // NOTE: 防止在这个平面相交处的遮挡误判断
+			{
+				if (mShadingReuse)
+				{
+					// the shaded samples: this pixel, and the left and upper
+					// ones unless they are in the apron
+					const Primitive *shadedPrims[3] = { currPrim };
+					const Color *shadedColors[3] = { &colors[idx] };
+					int numShaded = 1;
+					if (x > aX0)
+					{
+						shadedPrims[numShaded] = prims[idx - 1];
+						shadedColors[numShaded++] = &colors[idx - 1];
+					}
+					if (y > aY0)
+					{
+						shadedPrims[numShaded] = prims[idx - stride];
+						shadedColors[numShaded++] = &colors[idx - stride];
+					}
+					_renderSubsample(aCtx, sx - 0.5f*mDx, sy, 
+						shadedPrims, shadedColors, numShaded, finalClr);
+					_renderSubsample(aCtx, sx - 0.5f*mDx, sy + 0.5f*mDy, 
+						shadedPrims, shadedColors, numShaded, finalClr);
+					_renderSubsample(aCtx, sx, sy - 0.5f*mDy, 
+						shadedPrims, shadedColors, numShaded, finalClr);
+				}
+				else
+				{
+					// left
+					renderRay(aCtx, sx - 0.5f*mDx, sy, finalClr);
+					// top left
+					renderRay(aCtx, sx - 0.5f*mDx, sy + 0.5f*mDy, finalClr);
+					// top
+					renderRay(aCtx, sx, sy - 0.5f*mDy, finalClr);
+				}
+
+				finalClr *= aaScale;
+			}
+			_setFrameBuffer(y, x, finalClr);
+		}
+
+		if (mCancel)
+			return;
+	}
+}
+
+void Engine::_renderSubsample(RenderContext& aCtx, Real x, Real y, const Primitive* const* aPrims,
+							  const Color* const* aColors, int aNumShaded, Color& aAccClr)
+{
+	Ray ray = _primaryRay(x, y);
+	HitRecord hit;
+	++aCtx.mStats.mRays[RAY_PRIMARY];
+	if (findNearest(aCtx, ray, hit) == MISS)
+		return;
+
+	for (int i=0; i<aNumShaded; ++i)
+	{
+		if (aPrims[i] == hit.mPrim)
+		{
+			aAccClr += *aColors[i];
+			return;
+		}
+	}
+	// a surface none of the shaded samples hit, e.g. beyond an edge
+	_shadeHit(aCtx, ray, hit, aAccClr, 1, 1.0f);
+}
+
+void Engine::_renderAdaptive(RenderContext& aCtx, int aX0, int aY0, int aX1, int aY1)
+{
+	// pixel (x, y) is the square between the points (x, y) and (x + 1, y + 1)
+	// of the lattice, centered at the ray of the other modes
+	const int size = 1 << mAdaptiveDepth;
+	SampleLattice &lattice = aCtx.mLattice;
+	lattice.reset(aX0 - 0.5f, aY0 - 0.5f, 1.0f / size, 
+		(aX1 - aX0) * size + 1, (aY1 - aY0) * size + 1);
+
+	// trace the pixel corners first, in packets like the other modes
+	const int stride = RT_TILESIZE + 1;
+	const Primitive *prims[(RT_TILESIZE + 1) * (RT_TILESIZE + 1)];
+	Color colors[(RT_TILESIZE + 1) * (RT_TILESIZE + 1)];
+	int x, y;
+	for (y=aY0; y<=aY1; y+=RT_PACKET_H)
+	{
+		for (x=aX0; x<=aX1; x+=RT_PACKET_W)
+		{
+			int idx = (y - aY0) * stride + (x - aX0);
+			_renderPrimary(aCtx, x, y, std::min(x + RT_PACKET_W, aX1 + 1), 
+				std::min(y + RT_PACKET_H, aY1 + 1), -0.5f, &colors[idx], &prims[idx], stride);
+		}
+		if (mCancel)
+			return;
+	}
+	for (y=0; y<=aY1-aY0; ++y) for (x=0; x<=aX1-aX0; ++x)
+	{
+		SampleLattice::Sample &sample = lattice.get(x * size, y * size);
+		sample.mColor = colors[y * stride + x];
+		sample.mPrim = prims[y * stride + x];
+		lattice.validate(sample);
+	}
+
+	for (y=aY0; y<aY1; ++y)
+	{
+		for (x=aX0; x<aX1; ++x)
+			_setFrameBuffer(y, x, _adaptiveSquare(aCtx, (x - aX0) * size, (y - aY0) * size, size));
+
+		if (mCancel)
+			return;
+	}
+}
+
+Color Engine::_adaptiveSquare(RenderContext& aCtx, int i, int j, int aSize)
+{
+	const SampleLattice::Sample *corners[4] = 
+	{
+		&_latticeSample(aCtx, i, j), 
+		&_latticeSample(aCtx, i + aSize, j),
+		&_latticeSample(aCtx, i, j + aSize), 
+		&_latticeSample(aCtx, i + aSize, j + aSize)
+	};
+	const Color *colors[4] = 
+	{
+		&corners[0]->mColor, &corners[1]->mColor, &corners[2]->mColor, &corners[3]->mColor
+	};
+
+	const Material *surface = sampleSurface(corners[0]);
+	if (aSize > 1 && 
+		(surface != sampleSurface(corners[1]) || 
+		surface != sampleSurface(corners[2]) ||
+		surface != sampleSurface(corners[3]) ||
+		isContrasted(colors)))
+	{
+		int half = aSize / 2;
+		Color color = _adaptiveSquare(aCtx, i, j, half);
+		color += _adaptiveSquare(aCtx, i + half, j, half);
+		color += _adaptiveSquare(aCtx, i, j + half, half);
+		color += _adaptiveSquare(aCtx, i + half, j + half, half);
+		return color * 0.25f;
+	}
+	return (*colors[0] + *colors[1] + *colors[2] + *colors[3]) * 0.25f;
+}
+
+const SampleLattice::Sample& Engine::_latticeSample(RenderContext& aCtx, int i, int j)
+{
+	SampleLattice &lattice = aCtx.mLattice;
+	SampleLattice::Sample &sample = lattice.get(i, j);
+	if (!lattice.isValid(sample))
+	{
+		sample.mColor = Color(0,0,0);
+		sample.mPrim = renderRay(aCtx, lattice.getX(i) * mDx, lattice.getY(j) * mDy, sample.mColor);
+		lattice.validate(sample);
+	}
+	return sample;
+}
+
+void Engine::_renderPrimary(RenderContext& aCtx, int aX0, int aY0, int aX1, int aY1,
+							Real aOffset, Color* aColors, const Primitive** aPrims, int aStride)
+{
+	int x, y, lane;
+	if (mPacketTracing && mScene->usesBVH())
+	{
+		RayPacket packet;
+		for (y=aY0; y<aY1; ++y) for (x=aX0; x<aX1; ++x)
+		{
+			packet.setRay((y - aY0) * RT_PACKET_W + (x - aX0), 
+				_primaryRay((x + aOffset) * mDx, (y + aOffset) * mDy));
+		}
+
+		if (packet.finish())
+		{
+			aCtx.mStats.mRays[RAY_PRIMARY] += (aX1 - aX0) * (aY1 - aY0);
+			PacketHit hits(FAR_DISTANCE);
+			int hitMask = findNearest(aCtx, packet, hits);
+			for (y=aY0; y<aY1; ++y) for (x=aX0; x<aX1; ++x)
+			{
+				lane = (y - aY0) * RT_PACKET_W + (x - aX0);
+				Color &color = aColors[(y - aY0) * aStride + (x - aX0)];
+				const Primitive *&prim = aPrims[(y - aY0) * aStride + (x - aX0)];
+				color = Color(0,0,0);
+				prim = 0;
+				if (hitMask & (1 << lane))
+				{
+					HitRecord hit;
+					hits.getHit(lane, hit);
+					prim = _shadeHit(aCtx, packet.getRay(lane), hit, color, 1, 1.0f);
+				}
+			}
+			return;
+		}
+	}
+
+	// incoherent rays, or the grid, trace them one by one in the same order
+	for (y=aY0; y<aY1; ++y) for (x=aX0; x<aX1; ++x)
+	{
+		Color &color = aColors[(y - aY0) * aStride + (x - aX0)];
+		color = Color(0,0,0);
+		aPrims[(y - aY0) * aStride + (x - aX0)] = 
+			renderRay(aCtx, (x + aOffset) * mDx, (y + aOffset) * mDy, color);
+	}
+}
+
+void Engine::_stopRender()
+{
+	if (mStarted)
+	{
+		mCancel = true;
+		mPool->wait();
+		mStarted = false;
+	}
+	// NOTE: also drop a cancel() arriving between two renders
+	mCancel = false;
+}
+
+int Engine::getCurrProgree() const
+{
+	int total = mTilesX * mTilesY;
+	return (total > 0) ? static_cast<int>(mTilesDone * 100.0f / total) : 100;
+}
+
+void Engine::_setFrameBuffer(int _y, int _x, const Color& _clr)
+{
+	Color color = _clr * 255.0f;
+	mFrameBuffer.setPixel(_x, _y, 
+		makePixel(SATURATE(color.r), SATURATE(color.g), SATURATE(color.b)));
+}
+
+void Engine::setPacketTracing(bool val)
+{
+	_stopRender();
+	mPacketTracing = val;
+}
+
+void Engine::setAntiAlias(AntiAlias val)
+{
+	_stopRender();
+	mAntiAlias = val;
+}
+
+void Engine::setShadingReuse(bool val)
+{
+	_stopRender();
+	mShadingReuse = val;
+}
+
+void Engine::setAdaptiveDepth(int val)
+{
+	_stopRender();
+	mAdaptiveDepth = std::min(std::max(1, val), RT_ADAPTIVE_DEPTH);
+}
+
+AccelType Engine::getAccelType() const
+{
+	return mScene->getAccelType();
+}
+
+void Engine::setAccelType(AccelType val)
+{
+	_stopRender();
+	mScene->setAccelType(val);
+}
+
+Real Engine::getShadowCacheHitRate() const
+{
+	int blocked = 0, hits = 0;
+	for (size_t i=0; i<mContexts.size(); ++i)
+	{
+		blocked += mContexts[i]->mShadowCache.mBlocked;
+		hits += mContexts[i]->mShadowCache.mHits;
+	}
+	return (blocked > 0) ? hits * 100.0f / blocked : 0;
+}
+
+int Engine::getNumOfPrimitives() const
+{
+	return mScene->getNumOfPrimitives();
+}
+
+void Engine::loadObjModel(const trimeshVec::CAccessObj* accessObj)
+{
+	_stopRender();
+	for (size_t i=0; i<mContexts.size(); ++i)
+		mContexts[i]->mShadowCache.clear(mScene->getNumOfLights());
+	mScene->loadObjModel(accessObj);
+}
+
+void Engine::loadObjFile(const ObjFile& aObj)
+{
+	_stopRender();
+	for (size_t i=0; i<mContexts.size(); ++i)
+		mContexts[i]->mShadowCache.clear(mScene->getNumOfLights());
+	mScene->loadObjFile(aObj);
+}
+
+bool Engine::loadCachedObj(const String& aFilename)
+{
+	_stopRender();
+	for (size_t i=0; i<mContexts.size(); ++i)
+		mContexts[i]->mShadowCache.clear(mScene->getNumOfLights());
+	return mScene->loadCachedObj(aFilename);
+}
+
 }; // namespace RayTracer
\ No newline at end of file
@@ -1,211 +1,622 @@
-/********************************************************************
-	created:	2010/04/13
-	file name:	raytracer.h
-	author:		maxint lnychina@gmail.com
-*********************************************************************/
-
-#ifndef _RT_RAYTRACER_H_
-#define _RT_RAYTRACER_H_
-
-#include "common.h"
-#include <vector>
-
-class QImage;
-
-#define RT_SAMPLES			128
-#define RT_REGULAR_SAMPLES	8
-
-namespace trimeshVec{
-	class CAccessObj;
-}
-
-namespace RayTracer {
-
-// ------------------------------------------------------------------------------
-// Ray class definition
-// ------------------------------------------------------------------------------
-
-class Ray
-{
-public:
-	Ray()
-		: mOrigin(0,0,0)
-		, mDirection(0,0,0)
-		, mID(0)
-	{}
-	
-	Ray(const Vec3& aOrig, const Vec3& aDir, int aID)
-		: mOrigin(aOrig)
-		, mDirection(aDir)
-		, mID(aID)
-	{}
-
-	void setOrigin(const Vec3& aOrig)
-	{
-		mOrigin = aOrig;
-	}
-	void setDirection(const Vec3& aDir)
-	{
-		mDirection = aDir;
-	}
-	const Vec3& getOrigin() const
-	{
-		return mOrigin;
-	}
-	const Vec3& getDir() const
-	{
-		return mDirection;
-	}
-	int getID() const { return mID; }
-	void setID(int val) { mID = val; }
-
-private:
-	Vec3 mOrigin;
-	Vec3 mDirection;
-	int mID;
-};
-
-// ------------------------------------------------------------------------------
-// Ray tracer Engine Core
-// ------------------------------------------------------------------------------
-class Scene;
-class Primitive;
-class Twister;
-class CCamera;
-class Light;
-
-class Engine
-{
-public:
-	Engine();
-	~Engine();
-
-	/**	Set the render target canvas
-	\param
-		_w		width of the canvas
-		_h		height of the canvas
-		_img	which image it is rendered to?
-	 */
-	void setRenderTarget(int _w, int _h, QImage *_img);
-	Scene* getScene()
-	{
-		return mScene;
-	}
-	int getNumOfPrimitives() const;
-
-	/**	Naive ray tracing
-		Intersects the ray with every primitives in the scene to determine the 
-		closest intersection.
-	\param
-		_ray	light ray
-		_acc	final accumulated color
-		_dist	the closest distance
-		_depth	maximum recurse depth
-		_rIndex	refraction index
-	\return
-		if no intersection return 0, otherwise the intersected primitive
-	 */
-	Primitive* rayTrace(const Ray& _ray, Color& _acc, Real& _dist, 
-		int _depth, Real _rIndex);
-
-	/**	Initializes the engine renderer
-		Reset the line / tile counters and precalculate some values
-	\param
-		aPos	the camera position
-		aTarget	the looking at position 
-	 */
-	void initEngine(const Vec3& aPos, const Vec3& aTarget);
-
-	/**	Fires rays in the scene one scan line at a time, from left to right
-	\return
-		true	render completed
-		false	over time, continue to render next time
-	 */
-	bool render();
-
-	/**	Get and set tracing depth
-	 */
-	int getTraceDepth() const { return mTraceDepth; }
-	void setTraceDepth(int val) { mTraceDepth = std::min(val, RT_TRACEDEPTH); }
-
-	/**	Get current progress
-	 */
-	int getCurrProgree() const { return static_cast<int>(mCurrLine * 100.0f / mHeight); }
-
-	/**	Find the nearest intersection in a regular grid for a ray
-	\param
-		aRay	light ray
-		aDist	the nearest distance
-		aPrim	the nearest primitive
-	 */
-	RTResult findNearest(const Ray& aRay, Real& aDist, Primitive*& aPrim);
-
-	/**	Helper function, fire one ray in the regular grid
-	\param
-		aScreenPos	position of the screen to trace from
-		aAccClr		final color return
-	\return
-		the nearest primitive intersected
-	 */
-	Primitive* renderRay(Real x, Real y, Color& aAccClr);
-
-	/**	Determine the light intensity received from a point light (in case of 
-		a SHPERE primitive) or an area light (in case of an AABB primitive)
-	\param
-		aLight	the light
-		aIP		the intersected position
-		aDir	return light direction
-	\return 
-		shade parameter, 0~1. 
-		When it's point light, 0 indicates in shadow, 1 indicates in light.
-		When it's area light, return the proportion of light region.
-	 */
-	Real calcShade(const Light* aLight, const Vec3& aIP, Vec3& aDir);
-
-	/**	Get and set regular sample size of light
-	 */
-	int getRegularSampleSize() const { return mRegularSampleSize; }
-	void setRegularSampleSize(int val) { mRegularSampleSize = std::min(std::max(1, val), RT_REGULAR_SAMPLES); }
-
-	/**	Load obj model file
-	 */
-	void loadObjModel(const trimeshVec::CAccessObj* accessObj);
-
-private:
-	/**	Set the color of frame buffer
-	 */
-	void _setFrameBuffer(int _y, int _x, const Color& _clr);
-
-private:
-	typedef std::vector<Primitive*> PrimitiveList;
-
-private:
-	bool mCreated;
-	Scene* mScene;
-	int mWidth, mHeight;
-	Real mRatio;
-	QImage* mImage;
-	int mCurrLine;
-	Real mDx, mDy, mSx, mSy;
-	Vec3 mRCS;	// 1 / size of a cell
-	Vec3 mCS;	// size of a cell
-	int mCurRayID;
-
-	/// last line primitives
-	PrimitiveList mLastLinePrims;
-
-	/// benchmark related
-	int mTraceDepth;
-	int mRegularSampleSize;
-	Real mSampleScale;
-	Real mSampleOffset;
-	Real mSampleScale2;
-
-	/// random number generator
-	Twister* mTwister;
-	CCamera* mCamera;
-};
-
-}; // namespace RayTracer
-
+/********************************************************************
+	created:	2010/04/13
+	file name:	raytracer.h
+	author:		maxint lnychina@gmail.com
+*********************************************************************/
+
+#ifndef _RT_RAYTRACER_H_
+#define _RT_RAYTRACER_H_
+
+#include "common.h"
+#include "twister.h"
+#include "framebuffer.h"
+#include "stats.h"
+#include <vector>
+#include <atomic>
+#include <mutex>
+
+#define RT_SAMPLES			128
+#define RT_REGULAR_SAMPLES	8
+#define RT_TILESIZE			16
+#define RT_ADAPTIVE_DEPTH	4	// deepest subdivision of a pixel by AA_ADAPTIVE
+
+namespace trimeshVec{
+	class CAccessObj;
+}
+
+namespace RayTracer {
+
+// ------------------------------------------------------------------------------
+// Ray class definition
+// ------------------------------------------------------------------------------
+
+class Ray
+{
+public:
+	Ray()
+		: mOrigin(0,0,0)
+		, mDirection(0,0,0)
+	{}
+	
+	Ray(const Vec3& aOrig, const Vec3& aDir)
+		: mOrigin(aOrig)
+		, mDirection(aDir)
+	{}
+
+	void setOrigin(const Vec3& aOrig)
+	{
+		mOrigin = aOrig;
+	}
+	void setDirection(const Vec3& aDir)
+	{
+		mDirection = aDir;
+	}
+	const Vec3& getOrigin() const
+	{
+		return mOrigin;
+	}
+	const Vec3& getDir() const
+	{
+		return mDirection;
+	}
+
+private:
+	Vec3 mOrigin;
+	Vec3 mDirection;
+};
+
+/**	RT_PACKETSIZE rays in structure-of-arrays layout, so the SIMD code loads
+	the same component of consecutive rays. Lanes not in mActive are unused.
+ */
+class RayPacket
+{
+public:
+	enum { SIZE = RT_PACKETSIZE };
+
+	RayPacket()
+		: mActive(0)
+	{}
+
+	void setRay(int aLane, const Ray& aRay)
+	{
+		for (int i=0; i<3; ++i)
+		{
+			mOrigin[i][aLane] = aRay.getOrigin()[i];
+			mDir[i][aLane] = aRay.getDir()[i];
+			mInvDir[i][aLane] = 1.0f / aRay.getDir()[i];
+		}
+		mActive |= 1 << aLane;
+	}
+	Ray getRay(int aLane) const
+	{
+		return Ray(Vec3(mOrigin[0][aLane], mOrigin[1][aLane], mOrigin[2][aLane]),
+			Vec3(mDir[0][aLane], mDir[1][aLane], mDir[2][aLane]));
+	}
+
+	/**	Fill the unused lanes with a copy of an active one and find the 
+		common direction signs
+	\return
+		false	the active rays do not share one octant, trace them singly
+	 */
+	bool finish();
+
+	/// whether the rays go to the negative side of the axis
+	bool isDirNeg(int aAxis) const { return mDirNeg[aAxis]; }
+	int getActive() const { return mActive; }
+
+	Real mOrigin[3][SIZE];
+	Real mDir[3][SIZE];
+	Real mInvDir[3][SIZE];
+
+private:
+	int mActive;
+	bool mDirNeg[3];
+};
+
+// ------------------------------------------------------------------------------
+// Per-thread render state
+// ------------------------------------------------------------------------------
+
+/**	Per-thread mailbox of the grid traversal
+	A primitive spanning several cells is tested once per ray. Entries are 
+	direct mapped by primitive index and stamped with the traversal 
+	generation, so starting a new ray does not clear the table. A collision 
+	only costs a repeated test.
+ */
+class Mailbox
+{
+public:
+	enum { SIZE = 1024 };	// power of two
+
+	Mailbox()
+	{
+		_clear();
+	}
+
+	/// start a new traversal
+	void nextRay()
+	{
+		if (++mStamp == 0)
+			_clear();
+	}
+	bool isTested(int aIndex) const
+	{
+		const Entry &e = mEntries[aIndex & (SIZE - 1)];
+		return e.mStamp == mStamp && e.mIndex == aIndex;
+	}
+	void setTested(int aIndex)
+	{
+		Entry &e = mEntries[aIndex & (SIZE - 1)];
+		e.mStamp = mStamp;
+		e.mIndex = aIndex;
+	}
+
+private:
+	void _clear()
+	{
+		for (int i=0; i<SIZE; ++i)
+		{
+			mEntries[i].mStamp = 0;
+			mEntries[i].mIndex = -1;
+		}
+		mStamp = 1;
+	}
+
+private:
+	struct Entry
+	{
+		unsigned int mStamp;
+		int mIndex;
+	};
+	Entry mEntries[SIZE];
+	unsigned int mStamp;
+};
+
+class Light;
+class Primitive;
+
+/**	Per-thread cache of the last opaque primitive blocking a shadow ray of 
+	each light. Neighbouring pixels are usually shadowed by the same 
+	primitive, so it is tested before the traversal.
+	Every light has its own slot at its position in the scene, sized by
+	initEngine(), so no light evicts another.
+ */
+class ShadowCache
+{
+public:
+	ShadowCache()
+	{
+		clear(0);
+	}
+
+	/// forget the occluders, they may be deleted with the scene, and keep
+	/// a slot for each of @aNumLights lights
+	void clear(int aNumLights)
+	{
+		mOccluders.assign(aNumLights, NULL);
+		mBlocked = mHits = 0;
+	}
+
+	/// slot of the last occluder of the light at @aIndex, 0 if none
+	const Primitive*& getOccluder(int aIndex)
+	{
+		// NOTE: a light added after initEngine() gets its slot here
+		if (aIndex >= static_cast<int>(mOccluders.size()))
+			mOccluders.resize(aIndex + 1, NULL);
+		return mOccluders[aIndex];
+	}
+
+	int mBlocked;	// shadow rays found blocked by an opaque primitive
+	int mHits;		// of them, blocked by the cached primitive
+
+private:
+	std::vector<const Primitive*> mOccluders;
+};
+
+/**	Primary samples of a tile for the adaptive antialiasing, on a lattice of
+	2^depth points per pixel edge. Neighbouring pixels and sub-squares share
+	their corners, a point is traced the first time it is asked for.
+	Samples are stamped like the Mailbox entries, so starting a tile does 
+	not clear the table.
+ */
+class SampleLattice
+{
+public:
+	struct Sample
+	{
+		Sample() : mPrim(0), mStamp(0) {}
+
+		Color mColor;
+		const Primitive* mPrim;
+		unsigned int mStamp;
+	};
+
+	SampleLattice() : mX(0), mY(0), mStep(1), mWidth(0), mStamp(1) {}
+
+	/**	Forget the samples and start a lattice of aWidth x aHeight points,
+		point (0, 0) at pixel position (aX, aY), aStep pixels apart
+	 */
+	void reset(Real aX, Real aY, Real aStep, int aWidth, int aHeight)
+	{
+		size_t size = static_cast<size_t>(aWidth) * aHeight;
+		if (mSamples.size() < size)
+			mSamples.resize(size);
+		mX = aX;
+		mY = aY;
+		mStep = aStep;
+		mWidth = aWidth;
+		if (++mStamp == 0)
+		{
+			for (size_t i=0; i<mSamples.size(); ++i)
+				mSamples[i].mStamp = 0;
+			mStamp = 1;
+		}
+	}
+
+	Sample& get(int i, int j) { return mSamples[i + j * mWidth]; }
+	bool isValid(const Sample& aSample) const { return aSample.mStamp == mStamp; }
+	void validate(Sample& aSample) { aSample.mStamp = mStamp; }
+
+	/// pixel position of point (i, j)
+	Real getX(int i) const { return mX + i * mStep; }
+	Real getY(int j) const { return mY + j * mStep; }
+
+private:
+	std::vector<Sample> mSamples;
+	Real mX, mY, mStep;
+	int mWidth;
+	unsigned int mStamp;
+};
+
+/// Everything a worker writes while tracing, never shared between threads
+class RenderContext
+{
+public:
+	/// random number generator, reseeded per tile
+	Twister mTwister;
+	Mailbox mMailbox;
+	ShadowCache mShadowCache;
+	SampleLattice mLattice;
+	RenderStats mStats;
+};
+
+// ------------------------------------------------------------------------------
+// Ray tracer Engine Core
+// ------------------------------------------------------------------------------
+class Scene;
+class ObjFile;
+class HitRecord;
+class PacketHit;
+class CCamera;
+class ThreadPool;
+
+class Engine
+{
+public:
+	Engine();
+	~Engine();
+
+	/**	Set the render target canvas
+	\param
+		_w		width of the canvas
+		_h		height of the canvas
+	 */
+	void setRenderTarget(int _w, int _h);
+	int getWidth() const { return mWidth; }
+	int getHeight() const { return mHeight; }
+
+	/**	The canvas. A tile is final once render() has returned it.
+	 */
+	const FrameBuffer& getFrameBuffer() const { return mFrameBuffer; }
+	Scene* getScene()
+	{
+		return mScene;
+	}
+	int getNumOfPrimitives() const;
+
+	/**	Naive ray tracing
+		Intersects the ray with every primitives in the scene to determine the 
+		closest intersection.
+	\param
+		aCtx	render state of the calling thread
+		_ray	light ray
+		_acc	final accumulated color
+		_dist	the closest distance
+		_depth	maximum recurse depth
+		_rIndex	refraction index
+	\return
+		if no intersection return 0, otherwise the intersected primitive
+	 */
+	const Primitive* rayTrace(RenderContext& aCtx, const Ray& _ray, Color& _acc, Real& _dist, 
+		int _depth, Real _rIndex);
+
+	/**	Initializes the engine renderer
+		Stop the render in flight, reset the tile counters and precalculate 
+		some values
+	\param
+		aPos	the camera position
+		aTarget	the looking at position 
+	 */
+	void initEngine(const Vec3& aPos, const Vec3& aTarget);
+
+	/**	Render the image in tiles of RT_TILESIZE on the thread pool. The first
+		call queues all tiles, every call waits at most MAX_RENDER_TIME.
+	\param
+		aTiles	if not 0, receives the tiles finished since the last call
+	\return
+		true	render completed or cancelled
+		false	over time, continue to render next time
+	 */
+	bool render(std::vector<int>* aTiles = 0);
+
+	/**	Let the tiles in flight return early, so the pending render() 
+		finishes soon. It is the only method safe to call from another 
+		thread during render().
+	 */
+	void cancel();
+
+	/**	Pixel range [aX0, aX1) x [aY0, aY1) of a tile
+	 */
+	void getTileRect(int aTile, int& aX0, int& aY0, int& aX1, int& aY1) const;
+
+	/**	Get and set tracing depth
+	 */
+	int getTraceDepth() const { return mTraceDepth; }
+	void setTraceDepth(int val) { mTraceDepth = std::min(val, RT_TRACEDEPTH); }
+
+	/**	Get current progress
+	 */
+	int getCurrProgree() const;
+
+	/**	Get and set number of render threads, 0 means one per hardware thread
+	 */
+	int getNumThreads() const;
+	void setNumThreads(int val);
+
+	/**	Get and set the acceleration structure of the scene
+	 */
+	AccelType getAccelType() const;
+	void setAccelType(AccelType val);
+
+	/**	Find the nearest intersection, the unbounded primitives are tested 
+		first and the rest through the scene's acceleration structure
+	\param
+		aCtx	render state of the calling thread
+		aRay	light ray
+		aHit	the nearest intersection, aHit.mDist limits the search
+	 */
+	RTResult findNearest(RenderContext& aCtx, const Ray& aRay, HitRecord& aHit) const;
+
+	/**	Any-hit query of a shadow ray, it stops at the first opaque primitive
+		instead of searching for the nearest one
+	\param
+		aCtx		render state of the calling thread
+		aRay		shadow ray
+		aMaxDist	distance to the light
+		aOccluder	if not 0, set to the opaque primitive found
+	\return
+		OC_OPAQUE if anything but lights and refractive primitives is in 
+		between, otherwise OC_TRANSLUCENT if a refractive one is
+	 */
+	Occlusion findOcclusion(RenderContext& aCtx, const Ray& aRay, Real aMaxDist, 
+		const Primitive** aOccluder = 0) const;
+
+	/**	Find the nearest intersections of a packet of coherent rays, only 
+		through the BVH
+	\param
+		aCtx	render state of the calling thread
+		aPacket	rays sharing the direction signs, see RayPacket::finish()
+		aHit	the nearest intersections, aHit.mDist limits the search
+	\return
+		mask of the lanes hit
+	 */
+	int findNearest(RenderContext& aCtx, const RayPacket& aPacket, PacketHit& aHit) const;
+
+	/**	Get and set whether primary rays are traced in packets of 
+		RT_PACKETSIZE, it only applies to the BVH
+	 */
+	bool getPacketTracing() const { return mPacketTracing; }
+	void setPacketTracing(bool val);
+
+	/**	Get and set the antialiasing of the primary rays
+	 */
+	AntiAlias getAntiAlias() const { return mAntiAlias; }
+	void setAntiAlias(AntiAlias val);
+
+	/**	Get and set how many times AA_ADAPTIVE may split a pixel in four, 
+		1~RT_ADAPTIVE_DEPTH
+	 */
+	int getAdaptiveDepth() const { return mAdaptiveDepth; }
+	void setAdaptiveDepth(int val);
+
+	/**	Get and set whether the subsamples of AA_EDGE shade once per surface:
+		the visibility is still resolved per subsample, but one hitting the 
+		same primitive as the pixel, or its left or upper neighbour, takes 
+		their color instead of tracing shadow and secondary rays again
+	 */
+	bool getShadingReuse() const { return mShadingReuse; }
+	void setShadingReuse(bool val);
+
+	/**	Helper function, fire one ray in the regular grid
+	\param
+		aCtx		render state of the calling thread
+		x, y		position of the screen to trace from, 0~1
+		aAccClr		final color return
+	\return
+		the nearest primitive intersected
+	 */
+	const Primitive* renderRay(RenderContext& aCtx, Real x, Real y, Color& aAccClr);
+
+	/**	Determine the light intensity received from a point light (in case of 
+		a SHPERE primitive) or an area light (in case of an AABB primitive)
+	\param
+		aCtx	render state of the calling thread
+		aLight	the light
+		aLightIndex	position of @aLight in the scene, its ShadowCache slot
+		aIP		the intersected position, already moved off the surface
+		aN		surface normal on the side of @aIP, lights behind it are 
+				not traced
+		aDir	return light direction
+	\return 
+		shade parameter, 0~1. 
+		When it's point light, 0 indicates in shadow, 1 indicates in light.
+		When it's area light, return the proportion of light region.
+	 */
+	Real calcShade(RenderContext& aCtx, const Light* aLight, int aLightIndex, 
+		const Vec3& aIP, const Vec3& aN, 
+		Vec3& aDir);
+
+	/**	Percentage of the blocked point and directional light shadow rays 
+		resolved by the ShadowCache without traversal, since the last 
+		initEngine()
+	 */
+	Real getShadowCacheHitRate() const;
+
+	/**	Counters of the workers, merged when render() finishes a frame
+	 */
+	const RenderStats& getStats() const { return mStats; }
+
+	/**	Get and set regular sample size of light
+	 */
+	int getRegularSampleSize() const { return mRegularSampleSize; }
+	void setRegularSampleSize(int val) { mRegularSampleSize = std::min(std::max(1, val), RT_REGULAR_SAMPLES); }
+
+	/**	Load obj model file
+	 */
+	void loadObjModel(const trimeshVec::CAccessObj* accessObj);
+	void loadObjFile(const ObjFile& aObj);
+
+	/**	Load obj model file through its binary cache, which is written next
+		to the model when it is missing or stale
+	\return
+		false if the model can not be loaded
+	 */
+	bool loadCachedObj(const String& aFilename);
+
+private:
+	/**	Find the nearest intersection of the bounded primitives in the 
+		regular grid, the ray is clipped to the scene extends first
+	 */
+	RTResult _findNearestInGrid(RenderContext& aCtx, const Ray& aRay, HitRecord& aHit) const;
+
+	/**	Walk the cells of the regular grid pierced by the ray, passing every 
+		primitive once to aVisitor.visit() until it returns true or the cells
+		are beyond aVisitor.getLimit()
+	 */
+	template <class Visitor>
+	void _walkGrid(RenderContext& aCtx, const Ray& aRay, Visitor& aVisitor) const;
+
+	/**	findOcclusion() testing the last occluder of the light at 
+		@aLightIndex first
+	 */
+	Occlusion _findOcclusionCached(RenderContext& aCtx, int aLightIndex, 
+		const Ray& aRay, Real aMaxDist) const;
+
+	/**	Shade a hit found by findNearest(), recursing for reflection and 
+		refraction
+	\return
+		the primitive hit
+	 */
+	const Primitive* _shadeHit(RenderContext& aCtx, const Ray& aRay, const HitRecord& aHit,
+		Color& aAccClr, int aDepth, Real aRIndex);
+
+	/**	Shade the primary rays of the pixels [aX0, aX1) x [aY0, aY1), in one 
+		packet when they are coherent
+	\param
+		aOffset				added to the pixel position of every ray
+		aColors, aPrims		results of pixel (aX0, aY0), @aStride per row
+	 */
+	void _renderPrimary(RenderContext& aCtx, int aX0, int aY0, int aX1, int aY1,
+		Real aOffset, Color* aColors, const Primitive** aPrims, int aStride);
+
+	/**	Render the pixels [aX0, aX1) x [aY0, aY1) with one ray per pixel,
+		AA_EDGE adds three rays where the primitive differs from the left or
+		upper neighbour
+	 */
+	void _renderPixels(RenderContext& aCtx, int aX0, int aY0, int aX1, int aY1);
+
+	/**	Add the color of the subsample at screen position (x, y) to aAccClr,
+		reusing the color of the first of the aNumShaded shaded samples that
+		hit the same primitive, see setShadingReuse()
+	 */
+	void _renderSubsample(RenderContext& aCtx, Real x, Real y, const Primitive* const* aPrims,
+		const Color* const* aColors, int aNumShaded, Color& aAccClr);
+
+	/**	Render the pixels [aX0, aX1) x [aY0, aY1) by AA_ADAPTIVE, the corners
+		of the pixels are traced first, a pixel is split while the corners 
+		of a square hit different surfaces or differ in color
+	 */
+	void _renderAdaptive(RenderContext& aCtx, int aX0, int aY0, int aX1, int aY1);
+
+	/**	Average color of the lattice square (i, j) ~ (i + aSize, j + aSize)
+	 */
+	Color _adaptiveSquare(RenderContext& aCtx, int i, int j, int aSize);
+
+	/**	Point (i, j) of the lattice, traced the first time
+	 */
+	const SampleLattice::Sample& _latticeSample(RenderContext& aCtx, int i, int j);
+
+	/**	Set the color of frame buffer
+	 */
+	void _setFrameBuffer(int _y, int _x, const Color& _clr);
+
+	/**	Build the camera ray through screen position (x, y)
+	 */
+	Ray _primaryRay(Real x, Real y);
+
+	/**	Primitive hit by the camera ray through (x, y), without shading
+	 */
+	const Primitive* _primaryHit(RenderContext& aCtx, Real x, Real y);
+
+	/**	Render one tile, called by a worker of the thread pool
+	 */
+	void _renderTile(int aTile, int aWorker);
+
+	/**	Cancel the tiles in flight and wait for the workers
+	 */
+	void _stopRender();
+
+	void _createWorkers(int aNumThreads);
+	void _destroyWorkers();
+
+private:
+	typedef std::vector<RenderContext*> ContextList;
+
+private:
+	bool mCreated;
+	Scene* mScene;
+	int mWidth, mHeight;
+	Real mRatio;
+	Real mDx, mDy;
+	Vec3 mRCS;	// 1 / size of a cell
+	Vec3 mCS;	// size of a cell
+
+	/// benchmark related
+	int mTraceDepth;
+	int mRegularSampleSize;
+	Real mSampleScale;
+	Real mSampleOffset;
+	Real mSampleScale2;
+
+	CCamera* mCamera;
+	bool mPacketTracing;
+	AntiAlias mAntiAlias;
+	int mAdaptiveDepth;
+	bool mShadingReuse;
+
+	/// tile renderer
+	ThreadPool* mPool;
+	ContextList mContexts;
+	FrameBuffer mFrameBuffer;
+	int mTilesX, mTilesY;
+	bool mStarted;
+	std::atomic<bool> mCancel;
+	std::atomic<int> mTilesDone;
+	std::mutex mFinishedMutex;
+	std::vector<int> mFinishedTiles;
+	RenderStats mStats;	// of the last frame
+};
+
+}; // namespace RayTracer
+
 #endif // _RT_RAYTRACER_H_
\ No newline at end of file
@@ -0,0 +1,129 @@
+/********************************************************************
+	created:	2026/10/17
+	file name:	renderthread.cpp
+	author:		maxint lnychina@gmail.com
+*********************************************************************/
+
+#include "renderthread.h"
+#include "raytracer.h"
+
+#include <QTime>
+#include <cstring>
+
+using namespace RayTracer;
+
+RenderThread::RenderThread(Engine* aEngine, QObject* aParent)
+: QThread(aParent)
+, mEngine(aEngine)
+, mRestart(false)
+, mStopped(false)
+, mAbort(false)
+, mBusy(false)
+{
+}
+
+RenderThread::~RenderThread()
+{
+	{
+		QMutexLocker lock(&mMutex);
+		mAbort = true;
+		if (mBusy)
+			mEngine->cancel();
+		mRequestCond.wakeOne();
+	}
+	wait();
+}
+
+void RenderThread::render(const Vec3& aEyePos, const Vec3& aTarget)
+{
+	QMutexLocker lock(&mMutex);
+	mEyePos = aEyePos;
+	mTarget = aTarget;
+	mRestart = true;
+	if (mBusy)
+		mEngine->cancel();
+
+	if (!isRunning())
+		start(LowPriority);
+	else
+		mRequestCond.wakeOne();
+}
+
+void RenderThread::stop()
+{
+	QMutexLocker lock(&mMutex);
+	mRestart = false;
+	if (!mBusy)
+		return;
+
+	mStopped = true;
+	mEngine->cancel();
+	while (mBusy)
+		mIdleCond.wait(&mMutex);
+}
+
+void RenderThread::run()
+{
+	std::vector<int> tiles;
+	while (1)
+	{
+		Vec3 eyePos, target;
+		{
+			QMutexLocker lock(&mMutex);
+			while (!mRestart && !mAbort)
+				mRequestCond.wait(&mMutex);
+			if (mAbort)
+				return;
+
+			eyePos = mEyePos;
+			target = mTarget;
+			mRestart = false;
+			mStopped = false;
+			mBusy = true;
+		}
+
+		mEngine->initEngine(eyePos, target);
+		QTime time;
+		time.start();
+		bool finished = false;
+		while (!finished)
+		{
+			finished = mEngine->render(&tiles);
+			_emitTiles(tiles);
+
+			// NOTE: a cancel() may be lost while the engine starts, repeat it
+			if (_isInterrupted())
+				mEngine->cancel();
+			else
+				emit renderProgress(mEngine->getCurrProgree());
+		}
+		if (!_isInterrupted())
+			emit renderFinished(time.elapsed());
+
+		QMutexLocker lock(&mMutex);
+		mBusy = false;
+		mIdleCond.wakeAll();
+	}
+}
+
+void RenderThread::_emitTiles(const std::vector<int>& aTiles)
+{
+	const FrameBuffer& frameBuffer = mEngine->getFrameBuffer();
+	for (size_t i=0; i<aTiles.size(); ++i)
+	{
+		int x0, y0, x1, y1;
+		mEngine->getTileRect(aTiles[i], x0, y0, x1, y1);
+
+		// a copy, the next render reuses the frame buffer
+		QImage tile(x1 - x0, y1 - y0, QImage::Format_RGB32);
+		for (int y=y0; y<y1; ++y)
+			memcpy(tile.scanLine(y - y0), frameBuffer.getRow(y) + x0, (x1 - x0) * sizeof(QRgb));
+		emit tileRendered(QPoint(x0, y0), tile);
+	}
+}
+
+bool RenderThread::_isInterrupted()
+{
+	QMutexLocker lock(&mMutex);
+	return mRestart || mStopped || mAbort;
+}
@@ -0,0 +1,76 @@
+/********************************************************************
+	created:	2026/10/17
+	file name:	renderthread.h
+	author:		maxint lnychina@gmail.com
+*********************************************************************/
+
+#ifndef RENDERTHREAD_H
+#define RENDERTHREAD_H
+
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QImage>
+#include <vector>
+#include "common.h"
+
+namespace RayTracer {
+	class Engine;
+}
+
+/**	Drives RayTracer::Engine::render() off the GUI thread. Finished tiles
+	are copied out of the engine's frame buffer and handed to the GUI with
+	queued signals, so the engine never touches a widget or an image the GUI
+	paints from.
+	A new request cancels the render in flight and starts over at once.
+ */
+class RenderThread : public QThread
+{
+	Q_OBJECT
+
+public:
+	RenderThread(RayTracer::Engine* aEngine, QObject* aParent = 0);
+	~RenderThread();
+
+	/**	Cancel the render in flight, if any, and render the scene again
+	\param
+		aEyePos	the camera position
+		aTarget	the looking at position
+	 */
+	void render(const RayTracer::Vec3& aEyePos, const RayTracer::Vec3& aTarget);
+
+	/**	Cancel the render in flight and wait until the engine is idle.
+		Call it before changing the engine or the scene from the GUI thread.
+	 */
+	void stop();
+
+signals:
+	/// a finished part of the image whose top left corner is at @aPos
+	void tileRendered(const QPoint& aPos, const QImage& aTile);
+	/// percentage of the tiles finished
+	void renderProgress(int aPercent);
+	/// the image is complete, not emitted for a cancelled render
+	void renderFinished(int aMilliseconds);
+
+protected:
+	void run();
+
+private:
+	void _emitTiles(const std::vector<int>& aTiles);
+	bool _isInterrupted();
+
+private:
+	RayTracer::Engine* mEngine;
+	RayTracer::Vec3 mEyePos;
+	RayTracer::Vec3 mTarget;
+
+	QMutex mMutex;
+	QWaitCondition mRequestCond;	// wakes the thread for a new render
+	QWaitCondition mIdleCond;		// wakes stop() when the engine is idle
+	bool mRestart;	// a new render is requested
+	bool mStopped;	// the render in flight is cancelled by stop()
+	bool mAbort;	// quit the thread
+	bool mBusy;		// the engine is rendering
+};
+
+#endif // RENDERTHREAD_H
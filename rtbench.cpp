@@ -0,0 +1,531 @@
+/********************************************************************
+	created:	2026/10/17
+	file name:	rtbench.cpp
+	author:		maxint lnychina@gmail.com
+*********************************************************************/
+
+// Benchmark: renders a fixed set of scenes at fixed sizes and thread counts
+// and writes wall times, rays per second by type and the scaling
+// efficiency as JSON. Every run of a scene must give the same image, its
+// hash is reported to catch a change of the output.
+
+#include "raytracer.h"
+#include "scene.h"
+#include "primitive.h"
+#include "material.h"
+#include "objfile.h"
+#include "threadpool.h"
+
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+
+using namespace RayTracer;
+
+static const char* RAY_NAMES[RAY_TYPES] = { "primary", "shadow", "reflection", "refraction", "glossy" };
+static const char* AA_NAMES[] = { "none", "edge", "adaptive" };
+static const char* ACCEL_NAMES[] = { "grid", "bvh", "lbvh" };
+static const char* STAT_NAMES[STAT_TYPES] = 
+{
+	"traversals", "grid_cells", "bvh_nodes", "prim_tests", "mailbox_skips", "area_samples"
+};
+
+/// a benchmark scene, the camera and the settings are part of it
+struct BenchScene
+{
+	const char* mName;
+	Vec3 mEyePos;
+	Vec3 mTarget;
+	int mTraceDepth;
+	int mSampleSize;
+};
+
+static const BenchScene SCENES[] =
+{
+	{ "builtin",			Vec3(0, -2, 4),		Vec3(0, -2, 0),		4, 3 },
+	{ "dense_mesh",			Vec3(0, -1, 6),		Vec3(0, -2, 0),		4, 3 },
+	{ "many_lights",		Vec3(0, 1, 9),		Vec3(0, -2, 0),		2, 3 },
+	{ "reflect_refract",	Vec3(0, -1, 8),		Vec3(0, -2, 0),		6, 3 },
+};
+static const int NUM_SCENES = sizeof(SCENES) / sizeof(SCENES[0]);
+
+/// one build of the acceleration structure of a scene
+struct BenchBuild
+{
+	AccelType mAccel;
+	bool mTreelets;
+	int mThreads;
+	double mMs;			// median of the repetitions
+};
+
+/// one render of a scene
+struct BenchRun
+{
+	int mThreads;
+	double mWallMs;		// median of the repetitions
+	RenderStats mStats;	// of the last repetition
+	Real mShadowHitRate;	// percent, of the last repetition
+	unsigned long long mImageHash;
+};
+
+static double _msSince(const std::chrono::steady_clock::time_point& aStart)
+{
+	return std::chrono::duration<double, std::milli>(
+		std::chrono::steady_clock::now() - aStart).count();
+}
+
+static Light* _pointLight(const Vec3& aPos, Real aIntensity)
+{
+	Light *lit = new Light;
+	lit->mType = Light::LT_POINT;
+	lit->mPosition = aPos;
+	lit->setAmbient(0.05f, 0.05f, 0.05f);
+	lit->setDiffuse(aIntensity * Vec3::ONE);
+	lit->setSpecular(aIntensity * Vec3::ONE);
+	return lit;
+}
+
+static Light* _areaLight(const Vec3& aMin, const Vec3& aMax, Real aIntensity)
+{
+	Light *lit = new Light;
+	lit->mType = Light::LT_AREA;
+	lit->mAABB.setMin(aMin);
+	lit->mAABB.setMax(aMax);
+	lit->setAmbient(0.05f, 0.05f, 0.05f);
+	lit->setDiffuse(aIntensity * Vec3::ONE);
+	lit->setSpecular(aIntensity * Vec3::ONE);
+	return lit;
+}
+
+static Primitive* _prim(Primitive* aPrim, const char* aMaterial)
+{
+	aPrim->setMaterial(aMaterial);
+	return aPrim;
+}
+
+static void _setupMaterials()
+{
+	Material *mat = MaterialManager::getInstance().createManual("benchFloor");
+	mat->setDiffuse(0.6f, 0.6f, 0.55f);
+	mat->setAmbient(0.6f, 0.6f, 0.55f);
+
+	mat = MaterialManager::getInstance().createManual("benchPlastic");
+	mat->setDiffuse(0.8f, 0.3f, 0.2f);
+	mat->setSpecular(0.5f * Vec3::ONE);
+	mat->setShininess(30.0f);
+}
+
+/**	A bumpy sphere of 4 * aRings * aRings triangles, written as an OBJ 
+	file so it goes through the same loader as a model. The loader smooths
+	the normals.
+ */
+static bool _writeDenseMesh(const char* aFilename, int aRings)
+{
+	FILE *fp = fopen(aFilename, "w");
+	if (!fp)
+		return false;
+	const int slices = 2 * aRings;
+	const double pi = 3.14159265358979323846;
+	for (int i=0; i<=aRings; ++i) for (int j=0; j<=slices; ++j)
+	{
+		double theta = pi * i / aRings, phi = 2 * pi * j / slices;
+		double n[3] = { sin(theta) * cos(phi), cos(theta), sin(theta) * sin(phi) };
+		double r = 1.5 + 0.08 * sin(12 * theta) * sin(9 * phi);
+		fprintf(fp, "v %.6f %.6f %.6f\n", r * n[0], r * n[1] - 2, r * n[2]);
+	}
+	for (int i=0; i<aRings; ++i) for (int j=0; j<slices; ++j)
+	{
+		int a = i * (slices + 1) + j + 1, b = a + slices + 1;
+		fprintf(fp, "f %d %d %d\n", a, a + 1, b);
+		fprintf(fp, "f %d %d %d\n", a + 1, b + 1, b);
+	}
+	return fclose(fp) == 0;
+}
+
+/**	Replace the engine's scene by one of SCENES, the acceleration structure
+	is built by the caller
+ */
+static bool _setupScene(Engine& aEngine, int aScene, const char* aObjFile)
+{
+	Scene *scene = aEngine.getScene();
+	const String name = SCENES[aScene].mName;
+	if (name == "builtin")
+	{
+		// the engine starts with it
+		return true;
+	}
+
+	scene->clear();
+	if (name == "dense_mesh")
+	{
+		scene->addPrimitive(_prim(new PlanePrim(Vec3::UNIT_Y, 3.6f), "benchFloor"));
+		scene->addLight(_pointLight(Vec3(3, 3, 5), 0.6f));
+		scene->addLight(_areaLight(Vec3(-2, 4, -1), Vec3(-1, 4.1f, 0), 0.4f));
+
+		const char *tmpFile = "rtbench_dense.obj";
+		const char *objFile = aObjFile;
+		if (!objFile)
+		{
+			if (!_writeDenseMesh(tmpFile, 320))
+				return false;
+			objFile = tmpFile;
+		}
+		ObjFile obj;
+		bool ok = obj.load(objFile);
+		if (!aObjFile)
+			remove(tmpFile);
+		if (!ok)
+			return false;
+		scene->loadObjFile(obj);
+	}
+	else if (name == "many_lights")
+	{
+		scene->addPrimitive(_prim(new PlanePrim(Vec3::UNIT_Y, 3.6f), "benchFloor"));
+		scene->addPrimitive(_prim(new PlanePrim(Vec3::UNIT_Z, 6.0f), "benchFloor"));
+		for (int i=0; i<5; ++i) for (int j=0; j<5; ++j)
+		{
+			Vec3 centre(-4.0f + 2 * i, -2.8f, -4.0f + 2 * j);
+			scene->addPrimitive(_prim(new Sphere(centre, 0.7f), "benchPlastic"));
+		}
+		for (int i=0; i<32; ++i)
+		{
+			Real angle = 2 * RT_PI * i / 32;
+			scene->addLight(_pointLight(Vec3(6 * cos(angle), 1.0f + (i % 4), 6 * sin(angle)), 0.06f));
+		}
+		scene->addLight(_areaLight(Vec3(-1, 4, -1), Vec3(1, 4.1f, 1), 0.2f));
+	}
+	else if (name == "reflect_refract")
+	{
+		scene->addPrimitive(_prim(new PlanePrim(Vec3::UNIT_Y, 3.6f), "benchFloor"));
+		scene->addPrimitive(_prim(new PlanePrim(Vec3::UNIT_Z, 8.0f), "cellingMat"));
+		scene->addPrimitive(_prim(new Sphere(Vec3(-2.4f, -2.4f, 0), 1.2f), "reflectMat"));
+		scene->addPrimitive(_prim(new Sphere(Vec3(0, -2.4f, 1.5f), 1.2f), "refraMat"));
+		scene->addPrimitive(_prim(new Sphere(Vec3(2.4f, -2.4f, 0), 1.2f), "blueMat"));
+		scene->addPrimitive(_prim(new Sphere(Vec3(0, -0.5f, -2.5f), 1.0f), "reflectMat"));
+		scene->addPrimitive(_prim(new Box(AABB(Vec3(-0.8f, -3.6f, 3.2f), Vec3(0.8f, -2.8f, 4.0f))), "refraMat"));
+		scene->addLight(_pointLight(Vec3(0, 3, 5), 0.6f));
+		scene->addLight(_areaLight(Vec3(1, 4, -1), Vec3(3, 4.1f, 1), 0.4f));
+	}
+	return true;
+}
+
+static unsigned long long _imageHash(const FrameBuffer& aImage)
+{
+	// FNV-1a
+	unsigned long long hash = 14695981039346656037ull;
+	for (int y=0; y<aImage.getHeight(); ++y) for (int x=0; x<aImage.getWidth(); ++x)
+	{
+		hash ^= aImage.getPixel(x, y);
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+static BenchRun _render(Engine& aEngine, const BenchScene& aScene, int aThreads, int aRepeat)
+{
+	BenchRun run;
+	run.mThreads = aThreads;
+	aEngine.setNumThreads(aThreads);
+
+	std::vector<double> times;
+	for (int i=0; i<aRepeat; ++i)
+	{
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		aEngine.initEngine(aScene.mEyePos, aScene.mTarget);
+		while (!aEngine.render())
+			;
+		times.push_back(_msSince(start));
+	}
+	std::sort(times.begin(), times.end());
+	run.mWallMs = times[times.size() / 2];
+	run.mStats = aEngine.getStats();
+	run.mShadowHitRate = aEngine.getShadowCacheHitRate();
+	run.mImageHash = _imageHash(aEngine.getFrameBuffer());
+	return run;
+}
+
+/// time building the acceleration structure of the scene
+static BenchBuild _build(Scene* aScene, AccelType aAccel, bool aTreelets, int aThreads, int aRepeat)
+{
+	BenchBuild build;
+	build.mAccel = aAccel;
+	build.mTreelets = aTreelets;
+	build.mThreads = aThreads;
+	aScene->setAccelType(aAccel);
+	aScene->setTreelets(aTreelets);
+
+	// NOTE: the workers are started before the clock, as the engine keeps
+	// its pool across rebuilds
+	ThreadPool pool(aThreads);
+	ThreadPool *enginePool = aScene->getBuildPool();
+	aScene->setBuildPool(&pool);
+	std::vector<double> times;
+	for (int i=0; i<aRepeat; ++i)
+	{
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		aScene->buildGrid();
+		times.push_back(_msSince(start));
+	}
+	aScene->setBuildPool(enginePool);
+	std::sort(times.begin(), times.end());
+	build.mMs = times[times.size() / 2];
+	return build;
+}
+
+static void _usage(const char* aExe)
+{
+	printf("usage: %s [options]\n"
+		"options:\n"
+		"  -o <file>         JSON report (default rtbench.json)\n"
+		"  -s <w>x<h>        image size (default 640x480)\n"
+		"  -t <n,n,...>      thread counts (default 1, 2, 4... up to the hardware threads)\n"
+		"  -r <n>            repetitions per run, the median is kept (default 3)\n"
+		"  -scenes <a,b,...> subset of builtin,dense_mesh,many_lights,reflect_refract\n"
+		"  -accel grid|bvh|lbvh\n"
+		"                    acceleration structure (default bvh)\n"
+		"  -treelets 0|1     the linear BVH restructures its treelets (default 0)\n"
+		"  -packet 0|1       packet tracing of primary rays (default 1)\n"
+		"  -aa none|edge|adaptive\n"
+		"                    antialiasing (default edge)\n"
+		"  -aadepth <n>      most splits of a pixel by adaptive antialiasing\n"
+		"  -reuse 0|1        edge antialiasing shades once per surface (default 0)\n"
+		"  -obj <file>       model of the dense_mesh scene instead of the generated one\n"
+		"  -images           also save the image of every scene as rtbench_<scene>.ppm\n",
+		aExe);
+}
+
+int main(int argc, char* argv[])
+{
+	const char *outFile = "rtbench.json";
+	const char *objFile = 0;
+	const char *sceneList = 0;
+	int width = 640, height = 480, repeat = 3, packet = 1, aaDepth = -1;
+	int reuse = 0;
+	bool saveImages = false;
+	AccelType accel = AT_BVH;
+	int treelets = 0;
+	AntiAlias antiAlias = AA_EDGE;
+	std::vector<int> threads;
+
+	for (int i=1; i<argc; ++i)
+	{
+		const char *arg = argv[i];
+		const char *val = (i + 1 < argc) ? argv[i + 1] : 0;
+		if (!strcmp(arg, "-images"))
+		{
+			saveImages = true;
+			continue;
+		}
+		bool ok = (val != 0);
+		if (!ok)
+			;
+		else if (!strcmp(arg, "-o"))
+			outFile = val;
+		else if (!strcmp(arg, "-s"))
+			ok = sscanf(val, "%dx%d", &width, &height) == 2 && width > 0 && height > 0;
+		else if (!strcmp(arg, "-r"))
+			ok = (repeat = atoi(val)) > 0;
+		else if (!strcmp(arg, "-t"))
+		{
+			for (const char *p=val; ok && p; )
+			{
+				threads.push_back(atoi(p));
+				ok = threads.back() > 0;
+				p = strchr(p, ',');
+				if (p)
+					++p;
+			}
+		}
+		else if (!strcmp(arg, "-scenes"))
+			sceneList = val;
+		else if (!strcmp(arg, "-accel"))
+		{
+			ok = false;
+			for (int a=AT_GRID; a<=AT_LBVH; ++a)
+			{
+				if (!strcmp(val, ACCEL_NAMES[a]))
+				{
+					accel = (AccelType)a;
+					ok = true;
+				}
+			}
+		}
+		else if (!strcmp(arg, "-treelets"))
+			treelets = atoi(val);
+		else if (!strcmp(arg, "-packet"))
+			packet = atoi(val);
+		else if (!strcmp(arg, "-aa"))
+		{
+			ok = false;
+			for (int a=AA_NONE; a<=AA_ADAPTIVE; ++a)
+			{
+				if (!strcmp(val, AA_NAMES[a]))
+				{
+					antiAlias = (AntiAlias)a;
+					ok = true;
+				}
+			}
+		}
+		else if (!strcmp(arg, "-aadepth"))
+			ok = (aaDepth = atoi(val)) > 0;
+		else if (!strcmp(arg, "-reuse"))
+			reuse = atoi(val);
+		else if (!strcmp(arg, "-obj"))
+			objFile = val;
+		else
+			ok = false;
+
+		if (!ok)
+		{
+			_usage(argv[0]);
+			return 1;
+		}
+		++i;
+	}
+
+	const int hardwareThreads = std::max(1, (int)std::thread::hardware_concurrency());
+	if (threads.empty())
+	{
+		for (int n=1; n<hardwareThreads; n*=2)
+			threads.push_back(n);
+		threads.push_back(hardwareThreads);
+	}
+
+	FILE *fp = fopen(outFile, "w");
+	if (!fp)
+	{
+		fprintf(stderr, "ERROR: can not write %s\n", outFile);
+		return 1;
+	}
+
+	Engine engine;
+	engine.setRenderTarget(width, height);
+	engine.setPacketTracing(packet != 0);
+	engine.setAntiAlias(antiAlias);
+	if (aaDepth > 0)
+		engine.setAdaptiveDepth(aaDepth);
+	engine.setShadingReuse(reuse != 0);
+	_setupMaterials();
+
+	fprintf(fp, "{\n");
+	fprintf(fp, "  \"width\": %d,\n  \"height\": %d,\n  \"repeat\": %d,\n", width, height, repeat);
+	fprintf(fp, "  \"hardware_threads\": %d,\n", hardwareThreads);
+	fprintf(fp, "  \"precision\": \"%s\",\n", (sizeof(Real) == sizeof(float)) ? "float" : "double");
+	fprintf(fp, "  \"accel\": \"%s\",\n  \"treelets\": %s,\n  \"packet\": %s,\n",
+		ACCEL_NAMES[accel], treelets ? "true" : "false", packet ? "true" : "false");
+	fprintf(fp, "  \"antialias\": \"%s\",\n  \"adaptive_depth\": %d,\n", 
+		AA_NAMES[antiAlias], engine.getAdaptiveDepth());
+	fprintf(fp, "  \"shading_reuse\": %s,\n", reuse ? "true" : "false");
+	fprintf(fp, "  \"scenes\": [");
+
+	bool firstScene = true;
+	for (int s=0; s<NUM_SCENES; ++s)
+	{
+		const BenchScene &bench = SCENES[s];
+		if (sceneList && !strstr(sceneList, bench.mName))
+			continue;
+
+		if (!_setupScene(engine, s, objFile))
+		{
+			fprintf(stderr, "ERROR: can not set up scene %s\n", bench.mName);
+			return 1;
+		}
+		engine.setTraceDepth(bench.mTraceDepth);
+		engine.setRegularSampleSize(bench.mSampleSize);
+
+		// the grid is built by one thread, the BVHs by every thread count
+		Scene *scene = engine.getScene();
+		const double mprims = scene->getNumOfPrimitives() * 1e-6;
+		std::vector<BenchBuild> builds;
+		builds.push_back(_build(scene, AT_GRID, false, 1, repeat));
+		for (size_t t=0; t<threads.size(); ++t)
+		{
+			builds.push_back(_build(scene, AT_BVH, false, threads[t], repeat));
+			builds.push_back(_build(scene, AT_LBVH, false, threads[t], repeat));
+			builds.push_back(_build(scene, AT_LBVH, true, threads[t], repeat));
+		}
+		scene->setTreelets(treelets != 0);
+
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		engine.setAccelType(accel);
+		engine.getScene()->buildGrid();
+		const double buildMs = _msSince(start);
+
+		fprintf(fp, "%s\n    {\n", firstScene ? "" : ",");
+		firstScene = false;
+		fprintf(fp, "      \"name\": \"%s\",\n", bench.mName);
+		fprintf(fp, "      \"primitives\": %d,\n      \"lights\": %d,\n",
+			engine.getScene()->getNumOfPrimitives(), engine.getScene()->getNumOfLights());
+		fprintf(fp, "      \"trace_depth\": %d,\n      \"samples\": %d,\n",
+			bench.mTraceDepth, bench.mSampleSize);
+		fprintf(fp, "      \"build_ms\": %.3f,\n", buildMs);
+		fprintf(fp, "      \"builds\": [");
+		for (size_t b=0; b<builds.size(); ++b)
+		{
+			const BenchBuild &build = builds[b];
+			fprintf(fp, "%s\n        { \"accel\": \"%s\", \"treelets\": %s, \"threads\": %d, "
+				"\"ms\": %.3f, \"ms_per_million_prims\": %.3f }", b ? "," : "", 
+				ACCEL_NAMES[build.mAccel], build.mTreelets ? "true" : "false", build.mThreads,
+				build.mMs, build.mMs / mprims);
+			printf("%-16s %2d threads %10.1f ms %8.1f ms/Mprims  %s%s build\n",
+				bench.mName, build.mThreads, build.mMs, build.mMs / mprims, 
+				ACCEL_NAMES[build.mAccel], build.mTreelets ? "+treelets" : "");
+		}
+		fprintf(fp, "\n      ],\n");
+		fprintf(fp, "      \"runs\": [");
+
+		BenchRun base = BenchRun();
+		for (size_t t=0; t<threads.size(); ++t)
+		{
+			BenchRun run = _render(engine, bench, threads[t], repeat);
+			if (t == 0)
+				base = run;
+			// NOTE: relative to the first thread count, 1 unless -t says otherwise
+			double speedup = base.mWallMs / run.mWallMs;
+			double efficiency = speedup * base.mThreads / run.mThreads;
+			const RenderStats &stats = run.mStats;
+			unsigned long long total = stats.getTotalRays();
+
+			fprintf(fp, "%s\n        {\n", t ? "," : "");
+			fprintf(fp, "          \"threads\": %d,\n", run.mThreads);
+			fprintf(fp, "          \"wall_ms\": %.3f,\n", run.mWallMs);
+			fprintf(fp, "          \"rays\": {");
+			for (int i=0; i<RAY_TYPES; ++i)
+				fprintf(fp, " \"%s\": %llu,", RAY_NAMES[i], stats.getRays((RayType)i));
+			fprintf(fp, " \"total\": %llu },\n", total);
+			fprintf(fp, "          \"rays_per_second\": {");
+			for (int i=0; i<RAY_TYPES; ++i)
+				fprintf(fp, " \"%s\": %.0f,", RAY_NAMES[i], stats.getRays((RayType)i) * 1000.0 / run.mWallMs);
+			fprintf(fp, " \"total\": %.0f },\n", total * 1000.0 / run.mWallMs);
+			if (RenderStats::isEnabled())
+			{
+				// only a build with RT_STATS counts them
+				fprintf(fp, "          \"counters\": {");
+				for (int i=0; i<STAT_TYPES; ++i)
+				{
+					fprintf(fp, "%s \"%s\": %llu", i ? "," : "", 
+						STAT_NAMES[i], stats.get((StatType)i));
+				}
+				fprintf(fp, " },\n");
+			}
+			fprintf(fp, "          \"shadow_cache_hit_rate\": %.2f,\n", run.mShadowHitRate);
+			fprintf(fp, "          \"speedup\": %.3f,\n          \"efficiency\": %.3f,\n",
+				speedup, efficiency);
+			fprintf(fp, "          \"image_hash\": \"%016llx\"\n        }", run.mImageHash);
+
+			printf("%-16s %2d threads %10.1f ms %8.2f Mrays/s  efficiency %.2f  shadow cache %5.1f%%%s\n",
+				bench.mName, run.mThreads, run.mWallMs, total * 1e-3 / run.mWallMs, efficiency,
+				run.mShadowHitRate, (run.mImageHash != base.mImageHash) ? "  IMAGE DIFFERS" : "");
+		}
+		fprintf(fp, "\n      ]\n    }");
+		if (saveImages)
+			engine.getFrameBuffer().save(String("rtbench_") + bench.mName + ".ppm");
+	}
+	fprintf(fp, "\n  ]\n}\n");
+	fclose(fp);
+	return 0;
+}
@@ -0,0 +1,211 @@
+/********************************************************************
+	created:	2026/10/17
+	file name:	rtcli.cpp
+	author:		maxint lnychina@gmail.com
+*********************************************************************/
+
+// Headless renderer: renders an OBJ model, or the default scene, to an image
+// file without Qt, for machines without a display.
+
+#include "raytracer.h"
+#include "scene.h"
+#include "objfile.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+using namespace RayTracer;
+
+static void _usage(const char* aExe)
+{
+	printf("usage: %s [options] [model.obj]\n"
+		"  renders the model, or the default scene without one\n"
+		"options:\n"
+		"  -o <file>         output image, .ppm .bmp or .tga (default out.ppm)\n"
+		"  -s <w>x<h>        image size (default 800x600)\n"
+		"  -d <depth>        trace depth\n"
+		"  -a <n>            n x n regular samples per pixel\n"
+		"  -t <n>            render threads, 0 for one per hardware thread\n"
+		"  -accel grid|bvh|lbvh\n"
+		"                    acceleration structure (default bvh), lbvh is the\n"
+		"                    linear BVH, the fastest to build\n"
+		"  -treelets 0|1     the linear BVH restructures its treelets\n"
+		"  -packet 0|1       packet tracing of primary rays\n"
+		"  -aa none|edge|adaptive\n"
+		"                    antialiasing (default edge)\n"
+		"  -aadepth <n>      most splits of a pixel by adaptive antialiasing\n"
+		"  -reuse 0|1        edge antialiasing shades once per surface\n"
+		"  -cache 0|1        load the model through its binary cache (default 1)\n"
+		"  -eye <x,y,z>      camera position (default 0,-2,4)\n"
+		"  -target <x,y,z>   looking at position (default 0,-2,0)\n",
+		aExe);
+}
+
+static bool _parseVec3(const char* aStr, Vec3& aVec)
+{
+	double x, y, z;
+	if (sscanf(aStr, "%lf,%lf,%lf", &x, &y, &z) != 3)
+		return false;
+	aVec = Vec3(Real(x), Real(y), Real(z));
+	return true;
+}
+
+static double _msSince(const std::chrono::steady_clock::time_point& aStart)
+{
+	return std::chrono::duration<double, std::milli>(
+		std::chrono::steady_clock::now() - aStart).count();
+}
+
+int main(int argc, char* argv[])
+{
+	const char *objFile = 0;
+	const char *outFile = "out.ppm";
+	int width = 800, height = 600;
+	int traceDepth = -1, sampleSize = -1, numThreads = -1, packet = -1, aaDepth = -1;
+	int reuse = -1;
+	bool useCache = true;
+	bool treelets = false;
+	AccelType accel = AT_BVH;
+	AntiAlias antiAlias = AA_EDGE;
+	Vec3 eyePos(0, -2, 4), target(0, -2, 0);
+
+	for (int i=1; i<argc; ++i)
+	{
+		const char *arg = argv[i];
+		const char *val = (i + 1 < argc) ? argv[i + 1] : 0;
+		bool ok = true;
+		if (arg[0] != '-')
+		{
+			objFile = arg;
+			continue;
+		}
+		else if (!val)
+			ok = false;
+		else if (!strcmp(arg, "-o"))
+			outFile = val;
+		else if (!strcmp(arg, "-s"))
+			ok = sscanf(val, "%dx%d", &width, &height) == 2 && width > 0 && height > 0;
+		else if (!strcmp(arg, "-d"))
+			traceDepth = atoi(val);
+		else if (!strcmp(arg, "-a"))
+			sampleSize = atoi(val);
+		else if (!strcmp(arg, "-t"))
+			numThreads = atoi(val);
+		else if (!strcmp(arg, "-packet"))
+			packet = atoi(val);
+		else if (!strcmp(arg, "-accel"))
+		{
+			if (!strcmp(val, "grid"))
+				accel = AT_GRID;
+			else if (!strcmp(val, "bvh"))
+				accel = AT_BVH;
+			else if (!strcmp(val, "lbvh"))
+				accel = AT_LBVH;
+			else
+				ok = false;
+		}
+		else if (!strcmp(arg, "-treelets"))
+			treelets = atoi(val) != 0;
+		else if (!strcmp(arg, "-aa"))
+		{
+			if (!strcmp(val, "none"))
+				antiAlias = AA_NONE;
+			else if (!strcmp(val, "edge"))
+				antiAlias = AA_EDGE;
+			else if (!strcmp(val, "adaptive"))
+				antiAlias = AA_ADAPTIVE;
+			else
+				ok = false;
+		}
+		else if (!strcmp(arg, "-aadepth"))
+			aaDepth = atoi(val);
+		else if (!strcmp(arg, "-reuse"))
+			reuse = atoi(val);
+		else if (!strcmp(arg, "-cache"))
+			useCache = atoi(val) != 0;
+		else if (!strcmp(arg, "-eye"))
+			ok = _parseVec3(val, eyePos);
+		else if (!strcmp(arg, "-target"))
+			ok = _parseVec3(val, target);
+		else
+			ok = false;
+
+		if (!ok)
+		{
+			_usage(argv[0]);
+			return 1;
+		}
+		++i;
+	}
+
+	Engine engine;
+	engine.setRenderTarget(width, height);
+	if (traceDepth >= 0)
+		engine.setTraceDepth(traceDepth);
+	if (sampleSize > 0)
+		engine.setRegularSampleSize(sampleSize);
+	if (numThreads >= 0)
+		engine.setNumThreads(numThreads);
+	if (packet >= 0)
+		engine.setPacketTracing(packet != 0);
+	engine.getScene()->setTreelets(treelets);
+	engine.setAccelType(accel);
+	engine.setAntiAlias(antiAlias);
+	if (aaDepth > 0)
+		engine.setAdaptiveDepth(aaDepth);
+	if (reuse >= 0)
+		engine.setShadingReuse(reuse != 0);
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	if (objFile && useCache)
+	{
+		if (!engine.loadCachedObj(objFile))
+		{
+			fprintf(stderr, "ERROR: can not load %s\n", objFile);
+			return 1;
+		}
+	}
+	else if (objFile)
+	{
+		ObjFile obj;
+		if (!obj.load(objFile))
+		{
+			fprintf(stderr, "ERROR: can not load %s\n", objFile);
+			return 1;
+		}
+		engine.loadObjFile(obj);
+	}
+	const double loadTime = _msSince(start);
+
+	start = std::chrono::steady_clock::now();
+	engine.initEngine(eyePos, target);
+	while (!engine.render())
+		;
+	const double renderTime = _msSince(start);
+
+	if (!engine.getFrameBuffer().save(outFile))
+	{
+		fprintf(stderr, "ERROR: can not write %s\n", outFile);
+		return 1;
+	}
+	printf("%d primitives, load %.1f ms, render %.1f ms, %dx%d written to %s\n",
+		engine.getNumOfPrimitives(), loadTime, renderTime, width, height, outFile);
+	printf("scene memory %.1f MB\n", engine.getScene()->getMemoryUsage() / (1024.0 * 1024.0));
+
+	const RenderStats &stats = engine.getStats();
+	printf("rays: %llu primary, %llu shadow, %llu reflection, %llu refraction, %llu glossy\n",
+		stats.getRays(RAY_PRIMARY), stats.getRays(RAY_SHADOW), stats.getRays(RAY_REFLECTION),
+		stats.getRays(RAY_REFRACTION), stats.getRays(RAY_GLOSSY));
+	printf("shadow cache hits %.1f%% of the blocked shadow rays\n", engine.getShadowCacheHitRate());
+	if (RenderStats::isEnabled())
+	{
+		printf("%llu traversals, %.2f cells, %.2f nodes, %.2f primitive tests, "
+			"%.2f mailbox skips per traversal, %llu area light samples\n",
+			stats.get(STAT_TRAVERSALS), stats.getPerTraversal(STAT_GRID_CELLS),
+			stats.getPerTraversal(STAT_BVH_NODES), stats.getPerTraversal(STAT_PRIM_TESTS),
+			stats.getPerTraversal(STAT_MAILBOX_SKIPS), stats.get(STAT_AREA_SAMPLES));
+	}
+	return 0;
+}
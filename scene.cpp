@@ -1,471 +1,733 @@
-/********************************************************************
-	created:	2010/04/13
-	file name:	scene.cpp
-	author:		maxint lnychina@gmail.com
-*********************************************************************/
-
-#include "scene.h"
-#include "raytracer.h"
-#include "material.h"
-#include "primitive.h"
-#include "AccessObj.h"
-
-#include <sstream>
-
-namespace RayTracer {
-
-using std::min;
-using std::max;
-using std::abs;
-
-// ------------------------------------------------------------------------------
-// Scene class implementation
-// ------------------------------------------------------------------------------
-
-Scene::Scene()
-: mObjLoader(0)
-{}
-
-Scene::~Scene()
-{
-	destroy();
-	destroyLights();
-}
-
-void Scene::destroy()
-{
-	// release primitives
-	PrimListItor it = mPrimitives.begin();
-	PrimListItor it_end = mPrimitives.end();
-	for (; it != it_end; ++it)
-	{
-		SAFE_DELETE(*it);
-	}
-	mPrimitives.clear();
-	mLights.clear();
-
-	// remove regular grid
-	removeGrid();
-
-	// release vertex buffer
-	VertexItor vit = mVerticesPool.begin();
-	VertexItor vit_end = mVerticesPool.end();
-	for (; vit!=vit_end; ++vit)
-	{
-		SAFE_DELETE(*vit);
-	}
-	mVerticesPool.clear();
-}
-
-void Scene::destroyLights()
-{
-	// release lights
-	LightItor lit = mLights.begin();
-	LightItor lit_end = mLights.end();
-	for (; lit!=lit_end; ++lit)
-	{
-		SAFE_DELETE(*lit);
-	}
-	mLights.clear();
-}
-
-void Scene::setupMaterials()
-{
-	// add textures to texture manager
-	TextureManager::getInstance().createFromFile("textures/marble.png", "marble");
-	TextureManager::getInstance().createFromFile("textures/wood.png", "wood");
-	
-	// add materials
-	Material *mat = MaterialManager::getInstance().createManual("woodMat");
-	mat->setReflection(0);
-	mat->setRefraction(0);
-	mat->setDiffuse(0.5f*Vec3::ONE);
-	mat->setUVScale(0.1f, 0.1f);
-	mat->setAmbient(Vec3::ZERO);
-	mat->setTexture("wood");
-
-	mat = MaterialManager::getInstance().createManual("marbleMat");
-	mat->setReflection(0.0f);
-	mat->setRefraction(0.0f);
-	mat->setRefrIndex(1.3f);
-	mat->setDiffuse(Vec3::ONE);
-	mat->setSpecular(0.3f, 0.3f, 0.3f);
-	mat->setShininess(20.0f);
-	//mat->setAmbient(Vec3::ZERO);
-	mat->setTexture("marble");
-
-	mat = MaterialManager::getInstance().createManual("marbleMat2");
-	mat->setReflection(0.0f);
-	mat->setRefraction(0.0f);
-	mat->setSpecular(0.3f, 0.3f, 0.3f);
-	mat->setShininess(20.0f);
-	mat->setDiffuse(0.4f, 0.5f, 0.5f);
-	mat->setUVScale(0.15f, 0.15f);
-	mat->setTexture("marble");
-
-	mat = MaterialManager::getInstance().createManual("reflectMat");
-	mat->setReflection(1.0f);
-	mat->setRefraction(0.0f);
-	mat->setDiffuse(Vec3::ZERO);
-	mat->setAmbient(Vec3::ZERO);
-
-	mat = MaterialManager::getInstance().createManual("refraMat");
-	mat->setReflection(0.0f);
-	mat->setRefraction(1.0f);
-	mat->setRefrIndex(1.2f);
-	mat->setSpecular(0.5f * Vec3::ONE);
-	mat->setShininess(30.0f);
-	mat->setDiffuse(Vec3::ZERO);
-	mat->setAmbient(Vec3::ZERO);
-
-	mat = MaterialManager::getInstance().createManual("cellingMat");
-	mat->setReflection(0.5f);
-	mat->setDiffuse(0.4f, 0.3f, 0.3f);
-
-	mat = MaterialManager::getInstance().createManual("whiteLightMat");
-	mat->setDiffuse(1,1,1);
-
-	mat = MaterialManager::getInstance().createManual("blueMat");
-	mat->setDiffuse(0.2f, 0.2f, 3.0f);
-	mat->setDiffuseRefl(0.2f);
-	mat->setSpecular(0.3f * Vec3::ONE);
-	mat->setShininess(20.0f);
-	mat->setAmbient(Vec3::ZERO);
-
-	mat = MaterialManager::getInstance().createManual("greenSphereMat");
-	mat->setReflection(0);
-	mat->setRefraction(0);
-	mat->setSpecular(0.6f * Vec3::ONE);
-	mat->setShininess(20.0f);
-	mat->setDiffuse(0.3f, 1.0f, 0.4f);
-}
-
-void Scene::setupLights()
-{
-	Light *lit;
-
-	// area lights
-	//lit = new Light;
-	//lit->mType = Light::LT_AREA;
-	//lit->mAABB.setMin(Vec3(-3, 5, -1));
-	//lit->mAABB.setMax(Vec3(-1, 5.1f, 1));
-	//lit->setSpecular(0.2f*Vec3::ONE);
-	//lit->setDiffuse(0.2f*Vec3::ONE);
-	//lit->setAmbient(Vec3::ZERO);
-	//mLights.push_back(lit);
-
-	lit = new Light;
-	lit->mType = Light::LT_AREA;
-	lit->mAABB.setMin(Vec3(1, 5, -1));
-	lit->mAABB.setMax(Vec3(3, 5.1f, 1));
-	lit->setSpecular(0.2f*Vec3::ONE);
-	lit->setDiffuse(0.2f*Vec3::ONE);
-	mLights.push_back(lit);
-
-
-	// point lights
-	lit = new Light;
-	lit->mType = Light::LT_POINT;
-	lit->mPosition = Vec3(0,0,0);
-	lit->setSpecular(0.3f*Vec3::ONE);
-	lit->setDiffuse(0.5f*Vec3::ONE);
-	mLights.push_back(lit);
-
-	lit = new Light;
-	lit->mType = Light::LT_POINT;
-	lit->mPosition = Vec3(0, 1, 0);
-	lit->setSpecular(0.3f*Vec3::ONE);
-	lit->setDiffuse(0.5f*Vec3::ONE);
-	mLights.push_back(lit);
-
-}
-
-void Scene::initScene()
-{
-	setupMaterials();
-	setupLights();
-
-	Primitive *prim;
-
-#if 0
-	// area light
-	prim = new Box(AABB(Vec3(-3, 5, -1), Vec3(-1, 5.1f, 1)));
-	prim->setName("area light 1");
-	prim->setLight(true);
-	prim->setMaterial("whiteLightMat");
-	mPrimitives.push_back(prim);
-
-	// area light
-	prim = new Box(AABB(Vec3(1, 5, -1), Vec3(3, 5.1f, 1)));
-	prim->setName("area light 2");
-	prim->setLight(true);
-	prim->setMaterial("whiteLightMat");
-	mPrimitives.push_back(prim);
-
-	// light source 1
-	prim = new Sphere( Vec3(0, 0, 10), 0.2f);
-	prim->setLight(true);
-	prim->setMaterial("whiteLightMat");
-	mPrimitives.push_back(prim);
-
-	// light source 2
-	prim = new Sphere( Vec3(-3, 5, 1), 0.1f);
-	prim->setLight(true);
-	prim->setMaterial("whiteLightMat");
-	mPrimitives.push_back(prim);
-#endif
-
-#if 1
-	// middle sphere
-	prim = new Sphere(Vec3(0.0f, -2.0f, 0.0f), 1.0f);
-	prim->setName("middle sphere");
-	prim->setMaterial("reflectMat");
-	//prim->setMaterial("refraMat");
-	mPrimitives.push_back(prim);
-#endif
-
-#if 0
-	Vertex *vert1 = new Vertex(Vec3(-1, 1, 1), -Vec3::UNIT_Z, 0, 0);
-	Vertex *vert2 = new Vertex(Vec3(1, 1, 1), -Vec3::UNIT_Z, 0, 1);
-	Vertex *vert3 = new Vertex(Vec3(-2, -2, 1), -Vec3::UNIT_Z, 1, 0);
-	mVerticesPool.push_back(vert1);
-	mVerticesPool.push_back(vert2);
-	mVerticesPool.push_back(vert3);
-	prim = new TrianglePrim(vert1, vert2, vert3);
-	prim->setName("a triangle");
-	prim->setMaterial("marbleMat");
-	mPrimitives.push_back(prim);
-#endif
-
-#if 0
-	// left sphere
-	prim = new Sphere(Vec3(-5.0f, -0.8f, 0.0f), 2.0f);
-	prim->setName("left sphere");
-	prim->setMaterial("blueMat");
-	mPrimitives.push_back(prim);
-
-	// right sphere
-	prim = new Sphere(Vec3(5.0f, -0.8f, 0.0f), 2.0f);
-	prim->setName("right sphere");
-	prim->setMaterial("marbleMat");
-	mPrimitives.push_back(prim);
-
-#endif
-
-#if 0
-	// bottom box
-	prim = new Box(AABB(Vec3(-1.5f, -4.3f, 5.5f), Vec3(1.5f, -3.0f, 8.5f)));
-	prim->setName("middle box");
-	prim->getMaterial()->setDiffuse(0.5f);
-	prim->getMaterial()->setSpecular(0.0f);
-	prim->getMaterial()->setReflection(0.0f);
-	prim->getMaterial()->setRefraction(0.8f);
-	prim->getMaterial()->setRefrIndex(1.3f);
-	prim->getMaterial()->setColor(0.8f, 0.8f, 0.8f);
-	mPrimitives.push_back(prim);
-#endif
-
-#if 0
-	// ground plane
-	prim = new PlanePrim(Vec3::UNIT_Y, 4.4f);
-	prim->setName("plane");
-	prim->setMaterial("woodMat");
-	mPrimitives.push_back(prim);
-
-	// black plane
-	prim = new PlanePrim(-Vec3::UNIT_Z, 5.0f);
-	prim->setName("back plane");
-	prim->setMaterial("marbleMat2");
-	mPrimitives.push_back(prim);
-
-#endif
-#if 0
-	// right plane
-	prim = new PlanePrim(Vec3(-1,0,0), 8.0f);
-	prim->setName("right wall");
-	prim->setMaterial("marbleMat2");
-	mPrimitives.push_back(prim);
-
-	// ceiling plane
-	prim = new PlanePrim(Vec3(0,-1,0), 5.2f);
-	prim->setName("celling plane");
-	prim->setMaterial("cellingMat");
-	mPrimitives.push_back(prim);
-
-	// left plane
-	//prim = new PlanePrim(Vec3(1,0,0), 8.0f);
-	//prim->setName("left wall");
-	//prim->setMaterial("reflectMat");
-	//mPrimitives.push_back(prim);
-#endif
-
-	// build the regular grid
-	buildGrid();
-}
-
-void Scene::removeGrid()
-{
-	GridMapItor git = mGird.begin();
-	GridMapItor git_end = mGird.end();
-	for (; git!=git_end; ++git)
-	{
-		SAFE_DELETE(*git);
-	}
-	mGird.clear();
-}
-
-void Scene::buildGrid()
-{
-	// initialize regular grid
-	removeGrid();
-	mGird.resize(RT_GRIDSIZE * RT_GRIDSIZE * RT_GRIDSIZE, 0);
-
-	updateExtends();
-	Vec3 dv = mExtends.getDim() / RT_GRIDSIZE;
-	Vec3 rdv = 1.0f / dv;
-	Vec3 rMin, rMax;
-	AABB cell;
-
-	// store primitives in the grid cells
-	PrimListItor it = mPrimitives.begin();
-	PrimListItor it_end = mPrimitives.end();
-	Primitive *prim;
-	int count = 0;
-	for (; it!=it_end; ++it)
-	{
-		prim = *it;
-
-		// find out which cells could contain the primitive ( based on aabb)
-		rMin = (prim->getAABB().getMin() - mExtends.getMin()) * rdv;
-		rMax = (prim->getAABB().getMax() - mExtends.getMin()) * rdv + 1.0f;
-		rMin.Max(Vec3::ZERO);
-		rMax.Min(Vec3::ONE * (RT_GRIDSIZE-1));
-		
-		// loop over candidate cells
-		for (int z=static_cast<int>(rMin.z); z<static_cast<int>(rMax.z); ++z)
-			for (int y=static_cast<int>(rMin.y); y<static_cast<int>(rMax.y); ++y)
-				for (int x=static_cast<int>(rMin.x); x<static_cast<int>(rMax.x); ++x)
-		{
-			// construct aabb for current cell
-			int idx = x + y * RT_GRIDSIZE + z * RT_GRIDSIZE * RT_GRIDSIZE;
-			Vec3 pos(mExtends.getMin() + Vec3(static_cast<Real>(x),
-				static_cast<Real>(y), static_cast<Real>(z) ) * dv);
-			cell.setMin(pos);
-			cell.setMax(pos + dv);
-			// do an accurate aabb / primitive intersection test
-			if (prim->intersetBox(cell))
-			{
-				if (mGird[idx] == 0)
-					mGird[idx] = new ObjectList;
-				mGird[idx]->push_back(prim);
-				//std::cout << count << ": " << idx << std::endl;
-				++count;
-			}
-		} // end for cells
-	}// end for primitives
-	count = count;
-}
-
-void Scene::updateExtends()
-{
-	//Vec3 tMin(10000 * Vec3::ONE);
-	//Vec3 tMax(-10000 * Vec3::ONE);
-	Vec3 tMin(-3, -3, -6), tMax( 14, 8, 30 );
-
-	if (mObjLoader)
-	{
-		tMin.x = mObjLoader->m_vMin.x;
-		tMin.y = mObjLoader->m_vMin.y;
-		tMin.z = mObjLoader->m_vMin.z;
-		tMax.x = mObjLoader->m_vMax.x;
-		tMax.y = mObjLoader->m_vMax.y;
-		tMax.z = mObjLoader->m_vMax.z;
-	}
-
-	//PrimListItor it = mPrimitives.begin();
-	//PrimListItor it_end = mPrimitives.end();
-	//for (; it!=it_end; ++it)
-	//{
-	//	if ((*it)->getType() != Primitive::PT_PLANE)
-	//	{
-	//		tMin.Min((*it)->getAABB().getMin());
-	//		tMax.Max((*it)->getAABB().getMax());
-	//	}
-	//}
-	//Vec3 tCentre = 0.5 * (tMin + tMax);
-	//Vec3 tOffset = tMax - tCentre;
-	//tMin -= 2.0f * tOffset;
-	//tMax += 2.0f * tOffset;
-	mExtends.setMin(tMin);
-	mExtends.setMax(tMax);
-}
-
-void Scene::loadObjModel(const trimeshVec::CAccessObj* accessObj)
-{
-	//destroy();
-	mObjLoader = accessObj;
-
-	unsigned int i, k, count = 0;
-	trimeshVec::CPoint3D *vpVertices = accessObj->m_pModel->vpVertices;
-	trimeshVec::CPoint3D *vpNormals = accessObj->m_pModel->vpNormals;
-	trimeshVec::CPoint3D *vpTexCoords = accessObj->m_pModel->vpTexCoords;
-	trimeshVec::COBJmaterial *pMaterials = accessObj->m_pModel->pMaterials;
-	for (i=0; i<accessObj->m_pModel->nMaterials; ++i)
-	{
-		trimeshVec::COBJmaterial &mat = accessObj->m_pModel->pMaterials[i];
-		Material *newmat = MaterialManager::getInstance().createManual(mat.name);
-		Texture *tex = NULL;
-		if (mat.sTexture[0] != '\0')
-		{
-			tex = TextureManager::getInstance().createFromFile(mat.sTexture);
-		}
-		newmat->setTexture(tex);
-		newmat->setAmbient(mat.ambient[0], mat.ambient[1], mat.ambient[2]);
-		newmat->setDiffuse(mat.diffuse[0], mat.diffuse[1], mat.diffuse[2]);
-		newmat->setSpecular(mat.specular[0], mat.specular[1], mat.specular[2]);
-		newmat->setShininess(mat.shininess[0]);
-		newmat->setEmission(mat.emissive[0], mat.emissive[1], mat.emissive[2]);
-	}
-
-	TrianglePrim *prim;
-	for (i=0; i<accessObj->m_pModel->nTriangles; ++i)
-	{
-		trimeshVec::COBJtriangle &tri = accessObj->m_pModel->pTriangles[i];
-		Vertex *v[3];
-		for (k=0; k<3; ++k)
-		{
-			trimeshVec::CPoint3D &pos = vpVertices[tri.vindices[k]];
-			if (vpNormals)
-			{
-				trimeshVec::CPoint3D &norm = vpNormals[tri.nindices[k]];
-				if (vpTexCoords)
-				{
-					trimeshVec::CPoint3D &texcoord = vpTexCoords[tri.tindices[k]];
-					v[k] = new Vertex(Vec3(pos.x, pos.y, pos.z), Vec3(norm.x, norm.y, norm.z),
-						texcoord.x, texcoord.y);
-				}
-				else
-				{
-					v[k] = new Vertex(Vec3(pos.x, pos.y, pos.z), Vec3(norm.x, norm.y, norm.z));
-				}
-			}
-			else
-				v[k] = new Vertex(Vec3(pos.x, pos.y, pos.z));
-			mVerticesPool.push_back(v[k]);
-		}
-		prim = new TrianglePrim(v[0], v[1], v[2], vpNormals==NULL);
-		std::ostringstream oss;
-		oss << "_Triangle" << ++count;
-		prim->setName(oss.str());
-		if (pMaterials)
-		{
-			trimeshVec::COBJmaterial &mat =  pMaterials[tri.mindex];
-			prim->setMaterial(mat.name);
-		}
-		mPrimitives.push_back(prim);
-	}
-
-	buildGrid();
-}
-
+/********************************************************************
+	created:	2010/04/13
+	file name:	scene.cpp
+	author:		maxint lnychina@gmail.com
+*********************************************************************/
+
+#include "scene.h"
+#include "raytracer.h"
+#include "material.h"
+#include "primitive.h"
+#include "AccessObj.h"
+#include "objfile.h"
+#include "scenecache.h"
+#include "bvh.h"
+#include <cstdio>
+
+namespace RayTracer {
+
+using std::min;
+using std::max;
+using std::abs;
+
+// ------------------------------------------------------------------------------
+// Scene class implementation
+// ------------------------------------------------------------------------------
+
+Scene::Scene()
+: mAccelType(AT_GRID)
+, mBuildPool(NULL)
+, mTreelets(false)
+, mBVH(new BVH())
+{
+	mGridSize[0] = mGridSize[1] = mGridSize[2] = 1;
+}
+
+Scene::~Scene()
+{
+	destroy();
+	destroyLights();
+	SAFE_DELETE(mBVH);
+}
+
+void Scene::setAccelType(AccelType val)
+{
+	if (val == mAccelType)
+		return;
+	mAccelType = val;
+	buildGrid();
+}
+
+void Scene::setTreelets(bool val)
+{
+	if (val == mTreelets)
+		return;
+	mTreelets = val;
+	if (mAccelType == AT_LBVH)
+		buildGrid();
+}
+
+void Scene::destroy()
+{
+	// release primitives
+	PrimListItor it = mPrimitives.begin();
+	PrimListItor it_end = mPrimitives.end();
+	for (; it != it_end; ++it)
+	{
+		SAFE_DELETE(*it);
+	}
+	mPrimitives.clear();
+	mLights.clear();
+
+	// remove regular grid
+	removeGrid();
+
+	// release triangle meshes, their arrays go with the arena at once
+	for (size_t i=0; i<mMeshes.size(); ++i)
+	{
+		mMeshes[i]->~TriangleMesh();
+	}
+	mMeshes.clear();
+	mArena.reset();
+
+	// the meshes are gone, unmap the arrays they used
+	for (size_t i=0; i<mCaches.size(); ++i)
+	{
+		SAFE_DELETE(mCaches[i]);
+	}
+	mCaches.clear();
+}
+
+TriangleMesh* Scene::createMesh(int aNumVertices, int aNumTriangles, int aFlags)
+{
+	void *mem = mArena.alloc(sizeof(TriangleMesh));
+	TriangleMesh *mesh = new (mem) TriangleMesh(mArena, aNumVertices, aNumTriangles, aFlags);
+	mMeshes.push_back(mesh);
+	return mesh;
+}
+
+size_t Scene::getMemoryUsage() const
+{
+	return mArena.getUsed() + mAccelArena.getUsed();
+}
+
+int Scene::getNumOfPrimitives() const
+{
+	int num = static_cast<int>(mPrimitives.size());
+	for (size_t i=0; i<mMeshes.size(); ++i)
+		num += mMeshes[i]->getNumOfTriangles();
+	return num;
+}
+
+void Scene::clear()
+{
+	// NOTE: destroy() forgets the lights without deleting them
+	destroyLights();
+	destroy();
+}
+
+void Scene::destroyLights()
+{
+	// release lights
+	LightItor lit = mLights.begin();
+	LightItor lit_end = mLights.end();
+	for (; lit!=lit_end; ++lit)
+	{
+		SAFE_DELETE(*lit);
+	}
+	mLights.clear();
+}
+
+void Scene::setupMaterials()
+{
+	// add textures to texture manager
+	TextureManager::getInstance().createFromFile("textures/marble.png", "marble");
+	TextureManager::getInstance().createFromFile("textures/wood.png", "wood");
+	
+	// add materials
+	Material *mat = MaterialManager::getInstance().createManual("woodMat");
+	mat->setReflection(0);
+	mat->setRefraction(0);
+	mat->setDiffuse(0.5f*Vec3::ONE);
+	mat->setUVScale(0.1f, 0.1f);
+	mat->setAmbient(Vec3::ZERO);
+	mat->setTexture("wood");
+
+	mat = MaterialManager::getInstance().createManual("marbleMat");
+	mat->setReflection(0.0f);
+	mat->setRefraction(0.0f);
+	mat->setRefrIndex(1.3f);
+	mat->setDiffuse(Vec3::ONE);
+	mat->setSpecular(0.3f, 0.3f, 0.3f);
+	mat->setShininess(20.0f);
+	//mat->setAmbient(Vec3::ZERO);
+	mat->setTexture("marble");
+
+	mat = MaterialManager::getInstance().createManual("marbleMat2");
+	mat->setReflection(0.0f);
+	mat->setRefraction(0.0f);
+	mat->setSpecular(0.3f, 0.3f, 0.3f);
+	mat->setShininess(20.0f);
+	mat->setDiffuse(0.4f, 0.5f, 0.5f);
+	mat->setUVScale(0.15f, 0.15f);
+	mat->setTexture("marble");
+
+	mat = MaterialManager::getInstance().createManual("reflectMat");
+	mat->setReflection(1.0f);
+	mat->setRefraction(0.0f);
+	mat->setDiffuse(Vec3::ZERO);
+	mat->setAmbient(Vec3::ZERO);
+
+	mat = MaterialManager::getInstance().createManual("refraMat");
+	mat->setReflection(0.0f);
+	mat->setRefraction(1.0f);
+	mat->setRefrIndex(1.2f);
+	mat->setSpecular(0.5f * Vec3::ONE);
+	mat->setShininess(30.0f);
+	mat->setDiffuse(Vec3::ZERO);
+	mat->setAmbient(Vec3::ZERO);
+
+	mat = MaterialManager::getInstance().createManual("cellingMat");
+	mat->setReflection(0.5f);
+	mat->setDiffuse(0.4f, 0.3f, 0.3f);
+
+	mat = MaterialManager::getInstance().createManual("whiteLightMat");
+	mat->setDiffuse(1,1,1);
+
+	mat = MaterialManager::getInstance().createManual("blueMat");
+	mat->setDiffuse(0.2f, 0.2f, 3.0f);
+	mat->setDiffuseRefl(0.2f);
+	mat->setSpecular(0.3f * Vec3::ONE);
+	mat->setShininess(20.0f);
+	mat->setAmbient(Vec3::ZERO);
+
+	mat = MaterialManager::getInstance().createManual("greenSphereMat");
+	mat->setReflection(0);
+	mat->setRefraction(0);
+	mat->setSpecular(0.6f * Vec3::ONE);
+	mat->setShininess(20.0f);
+	mat->setDiffuse(0.3f, 1.0f, 0.4f);
+}
+
+void Scene::setupLights()
+{
+	Light *lit;
+
+	// area lights
+	//lit = new Light;
+	//lit->mType = Light::LT_AREA;
+	//lit->mAABB.setMin(Vec3(-3, 5, -1));
+	//lit->mAABB.setMax(Vec3(-1, 5.1f, 1));
+	//lit->setSpecular(0.2f*Vec3::ONE);
+	//lit->setDiffuse(0.2f*Vec3::ONE);
+	//lit->setAmbient(Vec3::ZERO);
+	//mLights.push_back(lit);
+
+	lit = new Light;
+	lit->mType = Light::LT_AREA;
+	lit->mAABB.setMin(Vec3(1, 5, -1));
+	lit->mAABB.setMax(Vec3(3, 5.1f, 1));
+	lit->setSpecular(0.2f*Vec3::ONE);
+	lit->setDiffuse(0.2f*Vec3::ONE);
+	mLights.push_back(lit);
+
+
+	// point lights
+	lit = new Light;
+	lit->mType = Light::LT_POINT;
+	lit->mPosition = Vec3(0,0,0);
+	lit->setSpecular(0.3f*Vec3::ONE);
+	lit->setDiffuse(0.5f*Vec3::ONE);
+	mLights.push_back(lit);
+
+	lit = new Light;
+	lit->mType = Light::LT_POINT;
+	lit->mPosition = Vec3(0, 1, 0);
+	lit->setSpecular(0.3f*Vec3::ONE);
+	lit->setDiffuse(0.5f*Vec3::ONE);
+	mLights.push_back(lit);
+
+}
+
+void Scene::initScene()
+{
+	setupMaterials();
+	setupLights();
+
+	ShapePrim *prim;
+
+#if 0
+	// area light
+	prim = new Box(AABB(Vec3(-3, 5, -1), Vec3(-1, 5.1f, 1)));
+	prim->setName("area light 1");
+	prim->setLight(true);
+	prim->setMaterial("whiteLightMat");
+	mPrimitives.push_back(prim);
+
+	// area light
+	prim = new Box(AABB(Vec3(1, 5, -1), Vec3(3, 5.1f, 1)));
+	prim->setName("area light 2");
+	prim->setLight(true);
+	prim->setMaterial("whiteLightMat");
+	mPrimitives.push_back(prim);
+
+	// light source 1
+	prim = new Sphere( Vec3(0, 0, 10), 0.2f);
+	prim->setLight(true);
+	prim->setMaterial("whiteLightMat");
+	mPrimitives.push_back(prim);
+
+	// light source 2
+	prim = new Sphere( Vec3(-3, 5, 1), 0.1f);
+	prim->setLight(true);
+	prim->setMaterial("whiteLightMat");
+	mPrimitives.push_back(prim);
+#endif
+
+#if 1
+	// middle sphere
+	prim = new Sphere(Vec3(0.0f, -2.0f, 0.0f), 1.0f);
+	prim->setName("middle sphere");
+	prim->setMaterial("reflectMat");
+	//prim->setMaterial("refraMat");
+	mPrimitives.push_back(prim);
+#endif
+
+#if 0
+	TriangleMesh *mesh = createMesh(3, 1, TriangleMesh::MESH_NORMALS | TriangleMesh::MESH_TEXCOORDS);
+	mesh->setName("a triangle");
+	int vert1 = mesh->addVertex(Vec3(-1, 1, 1), -Vec3::UNIT_Z, 0, 0);
+	int vert2 = mesh->addVertex(Vec3(1, 1, 1), -Vec3::UNIT_Z, 0, 1);
+	int vert3 = mesh->addVertex(Vec3(-2, -2, 1), -Vec3::UNIT_Z, 1, 0);
+	mesh->addTriangle(vert1, vert2, vert3, MaterialManager::getInstance().getMaterial("marbleMat"));
+#endif
+
+#if 0
+	// left sphere
+	prim = new Sphere(Vec3(-5.0f, -0.8f, 0.0f), 2.0f);
+	prim->setName("left sphere");
+	prim->setMaterial("blueMat");
+	mPrimitives.push_back(prim);
+
+	// right sphere
+	prim = new Sphere(Vec3(5.0f, -0.8f, 0.0f), 2.0f);
+	prim->setName("right sphere");
+	prim->setMaterial("marbleMat");
+	mPrimitives.push_back(prim);
+
+#endif
+
+#if 0
+	// bottom box
+	prim = new Box(AABB(Vec3(-1.5f, -4.3f, 5.5f), Vec3(1.5f, -3.0f, 8.5f)));
+	prim->setName("middle box");
+	prim->getMaterial()->setDiffuse(0.5f);
+	prim->getMaterial()->setSpecular(0.0f);
+	prim->getMaterial()->setReflection(0.0f);
+	prim->getMaterial()->setRefraction(0.8f);
+	prim->getMaterial()->setRefrIndex(1.3f);
+	prim->getMaterial()->setColor(0.8f, 0.8f, 0.8f);
+	mPrimitives.push_back(prim);
+#endif
+
+#if 0
+	// ground plane
+	prim = new PlanePrim(Vec3::UNIT_Y, 4.4f);
+	prim->setName("plane");
+	prim->setMaterial("woodMat");
+	mPrimitives.push_back(prim);
+
+	// black plane
+	prim = new PlanePrim(-Vec3::UNIT_Z, 5.0f);
+	prim->setName("back plane");
+	prim->setMaterial("marbleMat2");
+	mPrimitives.push_back(prim);
+
+#endif
+#if 0
+	// right plane
+	prim = new PlanePrim(Vec3(-1,0,0), 8.0f);
+	prim->setName("right wall");
+	prim->setMaterial("marbleMat2");
+	mPrimitives.push_back(prim);
+
+	// ceiling plane
+	prim = new PlanePrim(Vec3(0,-1,0), 5.2f);
+	prim->setName("celling plane");
+	prim->setMaterial("cellingMat");
+	mPrimitives.push_back(prim);
+
+	// left plane
+	//prim = new PlanePrim(Vec3(1,0,0), 8.0f);
+	//prim->setName("left wall");
+	//prim->setMaterial("reflectMat");
+	//mPrimitives.push_back(prim);
+#endif
+
+	// build the regular grid
+	buildGrid();
+}
+
+void Scene::removeGrid()
+{
+	mCellOffsets.clear();
+	mCellPrims.clear();
+	mPrimTable.clear();
+	mUnbounded.clear();
+	mBVH->clear();
+	mAccelArena.reset();
+}
+
+void Scene::buildGrid()
+{
+	removeGrid();
+
+	PrimArray bounded;
+	buildPrimTable(bounded);
+	updateExtends();
+
+	if (mAccelType == AT_BVH)
+	{
+		mBVH->build(bounded, mAccelArena, mBuildPool);
+	}
+	else if (mAccelType == AT_LBVH)
+	{
+		mBVH->buildLinear(bounded, mAccelArena, mBuildPool, mTreelets);
+	}
+	else
+	{
+		buildRegularGrid();
+	}
+}
+
+void Scene::buildPrimTable(PrimArray& aBounded)
+{
+	// number the primitives for the mailboxes of the render threads, 
+	// the shapes first and then the triangles of the meshes
+	mPrimTable.create(mAccelArena, getNumOfPrimitives());
+	PrimListItor it = mPrimitives.begin();
+	PrimListItor it_end = mPrimitives.end();
+	for (; it!=it_end; ++it)
+	{
+		(*it)->setIndex(mPrimTable.size());
+		mPrimTable.push_back(*it);
+	}
+	for (size_t i=0; i<mMeshes.size(); ++i)
+	{
+		TriangleMesh *mesh = mMeshes[i];
+		for (int k=0; k<mesh->getNumOfTriangles(); ++k)
+		{
+			TrianglePrim *tri = mesh->getTriangle(k);
+			tri->setIndex(mPrimTable.size());
+			mPrimTable.push_back(tri);
+		}
+	}
+
+	aBounded.reserve(mPrimTable.size());
+	for (int i=0; i<mPrimTable.size(); ++i)
+	{
+		if (mPrimTable[i]->isBounded())
+			aBounded.push_back(mPrimTable[i]);
+		else
+			mUnbounded.push_back(mPrimTable[i]);
+	}
+}
+
+void Scene::buildRegularGrid()
+{
+	// initialize regular grid
+	updateGridSize();
+	const int sx = mGridSize[0], sy = mGridSize[1], sz = mGridSize[2];
+	const int numCells = sx * sy * sz;
+
+	Vec3 dv = mExtends.getDim() / Vec3(sx, sy, sz);
+	Vec3 rdv = 1.0f / dv;
+	Vec3 rMin, rMax;
+	AABB cell;
+
+	/*	First pass: find the cells of every primitive and count the 
+		references per cell. The cells are kept so the accurate box test 
+		runs once.
+	 */
+	std::vector<int> refCells, refPrims;
+	refCells.reserve(mPrimTable.size());
+	refPrims.reserve(mPrimTable.size());
+	mCellOffsets.create(mAccelArena, numCells + 1);
+	mCellOffsets.resize(numCells + 1);
+
+	const Primitive *prim;
+	for (int i=0; i<mPrimTable.size(); ++i)
+	{
+		prim = mPrimTable[i];
+		if (!prim->isBounded())
+			continue;
+
+		// find out which cells could contain the primitive ( based on aabb)
+		AABB box = prim->getAABB();
+		rMin = (box.getMin() - mExtends.getMin()) * rdv;
+		rMax = (box.getMax() - mExtends.getMin()) * rdv + 1.0f;
+		rMin.Max(Vec3::ZERO);
+		rMax.Min(Vec3(sx, sy, sz));
+		
+		// loop over candidate cells
+		for (int z=static_cast<int>(rMin.z); z<static_cast<int>(rMax.z); ++z)
+			for (int y=static_cast<int>(rMin.y); y<static_cast<int>(rMax.y); ++y)
+				for (int x=static_cast<int>(rMin.x); x<static_cast<int>(rMax.x); ++x)
+		{
+			// construct aabb for current cell
+			int idx = x + (y + z * sy) * sx;
+			Vec3 pos(mExtends.getMin() + Vec3(static_cast<Real>(x),
+				static_cast<Real>(y), static_cast<Real>(z) ) * dv);
+			cell.setMin(pos);
+			cell.setMax(pos + dv);
+			// do an accurate aabb / primitive intersection test
+			if (prim->intersetBox(cell))
+			{
+				refCells.push_back(idx);
+				refPrims.push_back(prim->getIndex());
+				++mCellOffsets[idx + 1];
+			}
+		} // end for cells
+	}// end for primitives
+
+	// prefix sum turns the counts into the first slot of every cell
+	for (int i=0; i<numCells; ++i)
+		mCellOffsets[i + 1] += mCellOffsets[i];
+
+	// second pass: scatter, a cell keeps the primitives in scene order
+	std::vector<int> cursor(&mCellOffsets[0], &mCellOffsets[0] + numCells);
+	mCellPrims.create(mAccelArena, static_cast<int>(refCells.size()));
+	mCellPrims.resize(static_cast<int>(refCells.size()));
+	for (size_t i=0; i<refCells.size(); ++i)
+		mCellPrims[cursor[refCells[i]]++] = refPrims[i];
+}
+
+void Scene::updateGridSize()
+{
+	/*	N * RT_GRIDDENSITY cells in total, shaped like the extends so the 
+		cells are about cubic. A flat extends still gets one cell on its 
+		thin axis.
+	 */
+	Vec3 dim = mExtends.getDim();
+	Real maxDim = std::max(dim.x, std::max(dim.y, dim.z));
+	if (maxDim <= 0)
+	{
+		mGridSize[0] = mGridSize[1] = mGridSize[2] = 1;
+		return;
+	}
+	dim.Max(Vec3::ONE * (maxDim * 1e-3f));
+	Real cells = static_cast<Real>(RT_GRIDDENSITY * std::max(1, getNumOfPrimitives()));
+	Real k = std::pow(cells / (dim.x * dim.y * dim.z), Real(1.0f / 3.0f));
+	for (int i=0; i<3; ++i)
+	{
+		int size = static_cast<int>(dim[i] * k + 0.5f);
+		mGridSize[i] = std::max(1, std::min(size, RT_GRIDMAXSIZE));
+	}
+}
+
+void Scene::updateExtends()
+{
+	// tight bounds of the bounded primitives
+	Vec3 tMin(Vec3::ZERO), tMax(Vec3::ZERO);
+	bool first = true;
+	for (int i=0; i<mPrimTable.size(); ++i)
+	{
+		if (!mPrimTable[i]->isBounded())
+			continue;
+		AABB box = mPrimTable[i]->getAABB();
+		if (first)
+		{
+			tMin = box.getMin();
+			tMax = box.getMax();
+			first = false;
+		}
+		else
+		{
+			tMin.Min(box.getMin());
+			tMax.Max(box.getMax());
+		}
+	}
+
+	// NOTE: pad a little so primitives on the boundary fall inside the grid
+	Vec3 tPad = (tMax - tMin) * 1e-4f + RT_EPSILON;
+	mExtends.setMin(tMin - tPad);
+	mExtends.setMax(tMax + tPad);
+}
+
+/// whether two attribute indices, -1 for none, refer to the same value
+static bool _sameAttrib(const ObjFile& aObj, bool aNormal, int a, int b)
+{
+	if (a == b)
+		return true;
+	if (a < 0 || b < 0)
+		return false;
+	if (aNormal)
+	{
+		const float *u = aObj.getNormal(a), *v = aObj.getNormal(b);
+		const trimeshVec::CPoint3D pu(u[0], u[1], u[2]), pv(v[0], v[1], v[2]);
+		return trimeshVec::CAccessObj::Equal(&pu, &pv, RT_WELD_EPSILON);
+	}
+	const float *u = aObj.getTexCoord(a), *v = aObj.getTexCoord(b);
+	const trimeshVec::CPoint3D pu(u[0], u[1], 0.0f), pv(v[0], v[1], 0.0f);
+	return trimeshVec::CAccessObj::Equal(&pu, &pv, RT_WELD_EPSILON);
+}
+
+void Scene::loadObjModel(const trimeshVec::CAccessObj* accessObj)
+{
+	ObjFile obj;
+	obj.assign(*accessObj->m_pModel);
+	loadObjFile(obj);
+}
+
+Material* Scene::createMaterial(const ObjMaterial& aMat)
+{
+	Material *newmat = MaterialManager::getInstance().createManual(aMat.mName);
+	Texture *tex = NULL;
+	if (!aMat.mTexture.empty())
+	{
+		tex = TextureManager::getInstance().createFromFile(aMat.mTexture);
+	}
+	newmat->setTexture(tex);
+	newmat->setAmbient(aMat.mAmbient[0], aMat.mAmbient[1], aMat.mAmbient[2]);
+	newmat->setDiffuse(aMat.mDiffuse[0], aMat.mDiffuse[1], aMat.mDiffuse[2]);
+	newmat->setSpecular(aMat.mSpecular[0], aMat.mSpecular[1], aMat.mSpecular[2]);
+	newmat->setShininess(aMat.mShininess);
+	newmat->setEmission(aMat.mEmissive[0], aMat.mEmissive[1], aMat.mEmissive[2]);
+	return newmat;
+}
+
+void Scene::loadObjFile(const ObjFile& aObj)
+{
+	//destroy();
+	int i, k;
+	std::vector<Material*> materials(aObj.getNumOfMaterials(), NULL);
+	for (i=0; i<aObj.getNumOfMaterials(); ++i)
+	{
+		materials[i] = createMaterial(aObj.getMaterial(i));
+	}
+	Material *defaultMat = MaterialManager::getInstance().getMaterial("_default_");
+
+	/*	The obj corners index the position, the normal and the texture
+		coordinate separately. A mesh vertex is made for every distinct
+		triple, the ones sharing a position are chained from it. The normals
+		and texture coordinates are compared by value: generated vertex 
+		normals come one per corner, mostly equal around a smooth vertex.
+		The texture coordinates are only used along with normals.
+	 */
+	const bool hasNormals = aObj.getNumOfNormals() > 0;
+	const bool hasTexCoords = hasNormals && aObj.getNumOfTexCoords() > 0;
+	const int numTris = aObj.getNumOfTriangles();
+	std::vector<int> firstOfPos(aObj.getNumOfPositions(), -1);
+	std::vector<int> nextOfPos, posOf, normOf, texOf;
+	nextOfPos.reserve(aObj.getNumOfPositions());
+	posOf.reserve(aObj.getNumOfPositions());
+	normOf.reserve(aObj.getNumOfPositions());
+	texOf.reserve(aObj.getNumOfPositions());
+	std::vector<int> corners(3 * numTris);
+
+	for (i=0; i<numTris; ++i)
+	{
+		for (k=0; k<3; ++k)
+		{
+			const int *corner = aObj.getCorner(i, k);
+			const int vi = corner[ObjFile::CORNER_POS];
+			const int ni = hasNormals ? corner[ObjFile::CORNER_NORMAL] : -1;
+			const int ti = hasTexCoords ? corner[ObjFile::CORNER_TEX] : -1;
+			int idx = firstOfPos[vi];
+			while (idx >= 0 && !(_sameAttrib(aObj, true, normOf[idx], ni) &&
+				_sameAttrib(aObj, false, texOf[idx], ti)))
+				idx = nextOfPos[idx];
+			if (idx < 0)
+			{
+				idx = static_cast<int>(posOf.size());
+				nextOfPos.push_back(firstOfPos[vi]);
+				posOf.push_back(vi);
+				normOf.push_back(ni);
+				texOf.push_back(ti);
+				firstOfPos[vi] = idx;
+			}
+			corners[3 * i + k] = idx;
+		}
+	}
+
+	// the vertex count is known now, the mesh is allocated at its final size
+	int flags = 0;
+	if (hasNormals)
+		flags |= TriangleMesh::MESH_NORMALS;
+	if (hasTexCoords)
+		flags |= TriangleMesh::MESH_TEXCOORDS;
+	TriangleMesh *mesh = createMesh(static_cast<int>(posOf.size()), numTris, flags);
+	for (size_t n=0; n<posOf.size(); ++n)
+	{
+		const float *pos = aObj.getPosition(posOf[n]);
+		Vec3 norm(Vec3::ZERO);
+		Real u = 0, v = 0;
+		if (normOf[n] >= 0)
+		{
+			const float *normal = aObj.getNormal(normOf[n]);
+			norm = Vec3(normal[0], normal[1], normal[2]);
+		}
+		if (texOf[n] >= 0)
+		{
+			const float *texcoord = aObj.getTexCoord(texOf[n]);
+			u = texcoord[0];
+			v = texcoord[1];
+		}
+		mesh->addVertex(Vec3(pos[0], pos[1], pos[2]), norm, u, v);
+	}
+	for (i=0; i<numTris; ++i)
+	{
+		const int *v = &corners[3 * i];
+		mesh->addTriangle(v[0], v[1], v[2], 
+			materials.empty() ? defaultMat : materials[aObj.getMaterialIndex(i)]);
+	}
+
+	buildGrid();
+}
+
+bool Scene::loadCachedObj(const String& aFilename)
+{
+	const String cacheFile = aFilename + RT_CACHE_SUFFIX;
+	std::vector<ObjMaterial> objMaterials;
+	std::vector<int> materialIds;
+	std::vector<String> libraries;
+
+	SceneCache *cache = new SceneCache;
+	if (cache->open(cacheFile, aFilename))
+	{
+		// the model has not changed, the mesh uses the arrays of the cache
+		std::vector<Material*> materials;
+		for (int i=0; i<cache->getNumOfMaterials(); ++i)
+		{
+			objMaterials.push_back(cache->getMaterial(i));
+			materials.push_back(createMaterial(objMaterials.back()));
+		}
+		if (materials.empty())
+			materials.push_back(MaterialManager::getInstance().getMaterial("_default_"));
+
+		void *mem = mArena.alloc(sizeof(TriangleMesh));
+		TriangleMesh *mesh = new (mem) TriangleMesh(mArena, cache->getNumOfVertices(), 
+			cache->getPositions(), cache->getNormals(), cache->getTexCoords(), 
+			cache->getNumOfTriangles(), cache->getIndices());
+		mesh->addTriangles(cache->getMaterialIds(), &materials[0]);
+		mMeshes.push_back(mesh);
+		mCaches.push_back(cache);
+
+		// NOTE: the acceleration structure covers the other primitives too,
+		// it is only used if they are the same as when it was saved
+		if (cache->attachAccel(*this))
+			return true;
+		buildGrid();
+		materialIds.assign(cache->getMaterialIds(), cache->getMaterialIds() + mesh->getNumOfTriangles());
+		libraries = cache->getMaterialLibs();
+	}
+	else
+	{
+		SAFE_DELETE(cache);
+		ObjFile obj;
+		if (!obj.load(aFilename))
+			return false;
+		loadObjFile(obj);
+		for (int i=0; i<obj.getNumOfMaterials(); ++i)
+			objMaterials.push_back(obj.getMaterial(i));
+		for (int i=0; i<obj.getNumOfTriangles(); ++i)
+			materialIds.push_back(obj.getMaterialIndex(i));
+		libraries = obj.getMaterialLibs();
+	}
+
+	if (!SceneCache::save(cacheFile, aFilename, *this, *mMeshes.back(), objMaterials, materialIds, libraries))
+		fprintf(stderr, "WARNING: can not write the cache file %s\n", cacheFile.c_str());
+	return true;
+}
+
 }; // namespace RayTracer
\ No newline at end of file
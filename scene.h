@@ -1,108 +1,203 @@
-/********************************************************************
-	created:	2010/04/13
-	file name:	scene.h
-	author:		maxint lnychina@gmail.com
-*********************************************************************/
-
-#ifndef _RT_SCENE_H_
-#define _RT_SCENE_H_
-
-#include "common.h"
-#include <vector>
-#include <list>
-
-
-namespace trimeshVec{
-	class CAccessObj;
-}
-
-namespace RayTracer {
-
-class Primitive;
-class Vertex;
-class Light;
-
-// ------------------------------------------------------------------------------
-// Scene class definition
-// ------------------------------------------------------------------------------
-
-class Scene
-{
-public:
-	Scene();
-	~Scene();
-
-	/**	Initialization
-		Create some primitives
-	 */
-	void initScene();
-
-	int getNumOfPrimitives() const
-	{
-		return static_cast<int>(mPrimitives.size());
-	}
-	int getNumOfLights() const
-	{
-		return static_cast<int>(mLights.size());
-	}
-	const AABB& getExtends() const
-	{
-		return mExtends;
-	}
-
-	/**	Load obj model file
-	 */
-	void loadObjModel(const trimeshVec::CAccessObj* accessObj);
-
-	friend class Engine;
-
-private:
-	void setupMaterials();
-
-	/**	Destroy the primitives and release the resources.
-	 */
-	void destroy();
-
-	/**	Setup lights
-	 */
-	void setupLights();
-
-	/**	Destroy lights
-	 */
-	void destroyLights();
-
-	/**	Find extends of the primitives
-	 */
-	void updateExtends();
-
-	/**	Build the grid of the primitives
-	 */
-	void buildGrid();
-
-	void removeGrid();
-
-private:
-	typedef std::list<Primitive*>		PrimitiveList;
-	typedef PrimitiveList::iterator		PrimListItor;
-	typedef std::list<Primitive*>		ObjectList;
-	typedef ObjectList::iterator		ObjectItor;
-	typedef std::vector<ObjectList*>	GridMap;
-	typedef GridMap::iterator			GridMapItor;
-	typedef std::list<Vertex*>			VertexList;
-	typedef VertexList::iterator		VertexItor;
-	typedef std::list<Light*>			LightList;
-	typedef LightList::iterator			LightItor;
-private:
-	PrimitiveList mPrimitives;
-	LightList mLights;
-	GridMap mGird;
-	AABB mExtends;
-
-	/// obj model loader
-	const trimeshVec::CAccessObj* mObjLoader;
-	VertexList mVerticesPool;
-};
-
-}; // namespace RayTracer
-
+/********************************************************************
+	created:	2010/04/13
+	file name:	scene.h
+	author:		maxint lnychina@gmail.com
+*********************************************************************/
+
+#ifndef _RT_SCENE_H_
+#define _RT_SCENE_H_
+
+#include "common.h"
+#include "arena.h"
+#include <vector>
+#include <list>
+
+
+namespace trimeshVec{
+	class CAccessObj;
+}
+
+namespace RayTracer {
+
+class Primitive;
+class Material;
+class TriangleMesh;
+class ObjFile;
+class ObjMaterial;
+class SceneCache;
+class ThreadPool;
+class Light;
+class BVH;
+
+// ------------------------------------------------------------------------------
+// Scene class definition
+// ------------------------------------------------------------------------------
+
+class Scene
+{
+public:
+	Scene();
+	~Scene();
+
+	/**	Initialization
+		Create some primitives
+	 */
+	void initScene();
+
+	int getNumOfPrimitives() const;
+	int getNumOfLights() const
+	{
+		return static_cast<int>(mLights.size());
+	}
+	const AABB& getExtends() const
+	{
+		return mExtends;
+	}
+
+	/**	Number of cells of the regular grid on the axis
+	 */
+	int getGridSize(int aAxis) const
+	{
+		return mGridSize[aAxis];
+	}
+
+	/**	Load obj model file, the triangles are copied into a TriangleMesh 
+		so the loader can be released afterwards
+	 */
+	void loadObjModel(const trimeshVec::CAccessObj* accessObj);
+
+	/**	Load an obj model read by ObjFile
+	 */
+	void loadObjFile(const ObjFile& aObj);
+
+	/**	Load an obj model through its cache file, see SceneCache. While the
+		cache is valid the mesh and the acceleration structure are mapped 
+		from it, otherwise the model is read and the cache written again.
+	\return
+		false if the model can not be read
+	 */
+	bool loadCachedObj(const String& aFilename);
+
+	/**	Add a primitive or a light, the scene owns and deletes them.
+		Call buildGrid() once all primitives are added.
+	 */
+	void addPrimitive(Primitive* aPrim) { mPrimitives.push_back(aPrim); }
+	void addLight(Light* aLight) { mLights.push_back(aLight); }
+
+	/**	Create an empty mesh in the arena of the scene, see TriangleMesh.
+		The scene owns it, fill it before buildGrid().
+	 */
+	TriangleMesh* createMesh(int aNumVertices, int aNumTriangles, int aFlags);
+
+	/**	Remove all primitives and lights
+	 */
+	void clear();
+
+	/**	Build the acceleration structure of the primitives
+	 */
+	void buildGrid();
+
+	/**	Bytes of the geometry and of the acceleration structure in the arenas
+	 */
+	size_t getMemoryUsage() const;
+
+	/**	Get and set the acceleration structure, setting another one rebuilds it
+	 */
+	AccelType getAccelType() const { return mAccelType; }
+	void setAccelType(AccelType val);
+
+	/**	Whether the rays go through the BVH, built by either builder
+	 */
+	bool usesBVH() const { return mAccelType == AT_BVH || mAccelType == AT_LBVH; }
+
+	/**	Get and set the pool building the BVH, NULL builds it on the
+		calling thread. The engine sets its render pool, which is idle
+		while the scene is rebuilt.
+	 */
+	ThreadPool* getBuildPool() const { return mBuildPool; }
+	void setBuildPool(ThreadPool* val) { mBuildPool = val; }
+
+	/**	Get and set whether the linear BVH restructures its treelets, 
+		setting it rebuilds a linear BVH
+	 */
+	bool getTreelets() const { return mTreelets; }
+	void setTreelets(bool val);
+
+	friend class Engine;
+	friend class SceneCache;
+
+private:
+	void setupMaterials();
+
+	/**	Create a material of an obj model
+	 */
+	static Material* createMaterial(const ObjMaterial& aMat);
+
+	/**	Destroy the primitives and release the resources.
+	 */
+	void destroy();
+
+	/**	Setup lights
+	 */
+	void setupLights();
+
+	/**	Destroy lights
+	 */
+	void destroyLights();
+
+	/**	Number the primitives into mPrimTable and sort out the unbounded ones
+	 */
+	void buildPrimTable(std::vector<const Primitive*>& aBounded);
+
+	/**	Find extends of the primitives
+	 */
+	void updateExtends();
+
+	/**	Fill the regular grid
+	 */
+	void buildRegularGrid();
+
+	/**	Choose the resolution of the regular grid from the number of 
+		primitives and the shape of the extends
+	 */
+	void updateGridSize();
+
+	void removeGrid();
+
+private:
+	typedef std::list<Primitive*>		PrimitiveList;
+	typedef PrimitiveList::iterator		PrimListItor;
+	typedef std::vector<const Primitive*>	PrimArray;
+	typedef ArenaArray<int>				IndexArray;
+	typedef std::vector<TriangleMesh*>	MeshArray;
+	typedef std::list<Light*>			LightList;
+	typedef LightList::iterator			LightItor;
+private:
+	PrimitiveList mPrimitives;
+	LightList mLights;
+	MeshArray mMeshes;
+	/// mapped cache files the meshes refer to, closed by destroy()
+	std::vector<SceneCache*> mCaches;
+	/// the meshes and their arrays, reset by destroy()
+	MemoryArena mArena;
+	/// the grid, the BVH and the primitive table, reset by removeGrid()
+	MemoryArena mAccelArena;
+	/// regular grid, the primitives of cell i are 
+	/// mCellPrims[mCellOffsets[i]] ~ mCellPrims[mCellOffsets[i+1]-1]
+	IndexArray mCellOffsets;
+	IndexArray mCellPrims;
+	int mGridSize[3];
+	/// primitives by their index
+	ArenaArray<const Primitive*> mPrimTable;
+	/// planes etc., tested once per ray outside the grid and the BVH
+	PrimArray mUnbounded;
+	AABB mExtends;
+	AccelType mAccelType;
+	ThreadPool* mBuildPool;
+	bool mTreelets;
+	BVH* mBVH;
+};
+
+}; // namespace RayTracer
+
 #endif // _RT_SCENE_H_
\ No newline at end of file
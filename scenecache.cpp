@@ -0,0 +1,625 @@
+/********************************************************************
+	created:	2026/10/17
+	file name:	scenecache.cpp
+	author:		maxint lnychina@gmail.com
+*********************************************************************/
+
+#include "scenecache.h"
+#include "scene.h"
+#include "primitive.h"
+#include "objfile.h"
+#include "bvh.h"
+#include "arena.h"
+
+#include <cstdio>
+#include <cstring>
+#include <cstddef>
+
+namespace RayTracer {
+
+static const char CACHE_MAGIC[8] = { 'R', 'T', 'C', 'A', 'C', 'H', 'E', 0 };
+static const unsigned int BYTE_ORDER_MARK = 0x01020304;
+
+/// FNV-1a over 8 byte words, then the bytes left
+static unsigned long long _hash(const void* aData, size_t aSize, unsigned long long aHash)
+{
+	const unsigned long long PRIME = 1099511628211ULL;
+	const unsigned char *p = static_cast<const unsigned char*>(aData);
+	for (; aSize >= 8; p += 8, aSize -= 8)
+	{
+		unsigned long long word;
+		memcpy(&word, p, 8);
+		aHash = (aHash ^ word) * PRIME;
+	}
+	for (; aSize > 0; ++p, --aSize)
+		aHash = (aHash ^ *p) * PRIME;
+	return aHash;
+}
+
+static const unsigned long long HASH_SEED = 14695981039346656037ULL;
+
+/// hash of the contents of a file, false if it can not be read
+static bool _hashFile(const String& aFilename, unsigned long long& aHash)
+{
+	MappedFile file;
+	if (!file.open(aFilename))
+		return false;
+	aHash = _hash(file.getData(), file.getSize(), HASH_SEED);
+	return true;
+}
+
+/**	Write over a value in the cache file, the mapping is private and
+	keeps the old one
+ */
+static void _writeAt(const String& aCacheFile, unsigned long long aOffset,
+					 const void* aData, size_t aSize)
+{
+	FILE *fp = fopen(aCacheFile.c_str(), "r+b");
+	if (fp)
+	{
+		fseek(fp, static_cast<long>(aOffset), SEEK_SET);
+		fwrite(aData, aSize, 1, fp);
+		fclose(fp);
+	}
+}
+
+/// the BVH is saved by either builder
+static bool _isBVH(int aAccelType)
+{
+	return aAccelType == AT_BVH || aAccelType == AT_LBVH;
+}
+
+/// fixed part at the start of the file
+struct SceneCache::Header
+{
+	char mMagic[8];
+	unsigned int mVersion;
+	unsigned int mByteOrder;
+	unsigned int mRealSize;
+	unsigned int mNodeSize;
+
+	// the model the cache was made of
+	unsigned long long mSourceSize;
+	long long mSourceModified;
+	unsigned long long mSourceHash;
+
+	int mNumVertices;
+	int mNumTriangles;
+	int mNumMaterials;
+
+	// the acceleration structure, -1 for none
+	int mAccelType;
+	int mTreelets;			// the linear BVH was restructured
+	int mNumPrims;			// primitives of the scene, the mesh comes last
+	int mGridSize[3];
+	unsigned long long mPrefixHash;	// primitives before the mesh
+	Real mExtends[6];
+
+	Section mSections[NUM_SECTIONS];
+};
+
+/// a material, the names are offsets into SEC_STRINGS
+struct SceneCache::Material
+{
+	float mAmbient[3];
+	float mDiffuse[3];
+	float mSpecular[3];
+	float mEmissive[3];
+	float mShininess;
+	unsigned int mName;
+	unsigned int mTexture;
+};
+
+/// a material library of the model, the path is an offset into SEC_STRINGS
+struct SceneCache::Library
+{
+	unsigned long long mSize;
+	long long mModified;
+	unsigned long long mHash;
+	unsigned int mPath;
+	unsigned int mFound;	// 0 if the model refers to a missing file
+};
+
+// ------------------------------------------------------------------------------
+// SceneCache class implementation
+// ------------------------------------------------------------------------------
+
+SceneCache::SceneCache()
+{
+}
+
+SceneCache::~SceneCache()
+{
+	close();
+}
+
+void SceneCache::close()
+{
+	mFile.close();
+}
+
+const SceneCache::Header& SceneCache::_header() const
+{
+	return *reinterpret_cast<const Header*>(mFile.getData());
+}
+
+const char* SceneCache::_section(int aType) const
+{
+	const Section &sec = _header().mSections[aType];
+	return sec.mSize > 0 ? mFile.getData() + sec.mOffset : NULL;
+}
+
+bool SceneCache::open(const String& aCacheFile, const String& aSource)
+{
+	close();
+	unsigned long long sourceSize;
+	long long sourceModified;
+	if (!MappedFile::getFileInfo(aSource, sourceSize, sourceModified) ||
+		!mFile.open(aCacheFile))
+	{
+		close();
+		return false;
+	}
+
+	const Header &header = _header();
+	if (mFile.getSize() < sizeof(Header) ||
+		memcmp(header.mMagic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0 ||
+		header.mVersion != RT_CACHE_VERSION ||
+		header.mByteOrder != BYTE_ORDER_MARK ||
+		header.mRealSize != sizeof(Real) ||
+		header.mNodeSize != sizeof(BVH::Node) ||
+		header.mSourceSize != sourceSize ||
+		!_checkSections())
+	{
+		close();
+		return false;
+	}
+
+	if (header.mSourceModified != sourceModified)
+	{
+		// touched or copied, the contents decide
+		unsigned long long hash;
+		if (!_hashFile(aSource, hash) || hash != header.mSourceHash)
+		{
+			close();
+			return false;
+		}
+
+		// NOTE: the time is updated in place, the mapping is private
+		_writeAt(aCacheFile, offsetof(Header, mSourceModified),
+			&sourceModified, sizeof(sourceModified));
+	}
+	if (!_checkLibraries(aCacheFile))
+	{
+		close();
+		return false;
+	}
+	return true;
+}
+
+bool SceneCache::_checkLibraries(const String& aCacheFile) const
+{
+	const Section &sec = _header().mSections[SEC_LIBRARIES];
+	const Library *libs = reinterpret_cast<const Library*>(_section(SEC_LIBRARIES));
+	const int numLibs = static_cast<int>(sec.mSize / sizeof(Library));
+	for (int i=0; i<numLibs; ++i)
+	{
+		const Library &lib = libs[i];
+		const String path = _section(SEC_STRINGS) + lib.mPath;
+		unsigned long long size;
+		long long modified;
+		const bool found = MappedFile::getFileInfo(path, size, modified);
+		if (found != (lib.mFound != 0))
+			return false;
+		if (!found || (size == lib.mSize && modified == lib.mModified))
+			continue;
+
+		// touched or copied, the contents decide as for the model
+		unsigned long long hash;
+		if (size != lib.mSize || !_hashFile(path, hash) || hash != lib.mHash)
+			return false;
+		_writeAt(aCacheFile, sec.mOffset + i * sizeof(Library) + offsetof(Library, mModified),
+			&modified, sizeof(modified));
+	}
+	return true;
+}
+
+bool SceneCache::_checkSections() const
+{
+	const Header &header = _header();
+	const unsigned long long numVerts = header.mNumVertices;
+	const unsigned long long numTris = header.mNumTriangles;
+	if (header.mNumVertices < 0 || header.mNumTriangles < 0 || header.mNumMaterials < 0)
+		return false;
+
+	for (int i=0; i<NUM_SECTIONS; ++i)
+	{
+		const Section &sec = header.mSections[i];
+		if (sec.mOffset % RT_ARENA_ALIGN != 0 || sec.mOffset > mFile.getSize() ||
+			sec.mSize > mFile.getSize() - sec.mOffset)
+			return false;
+	}
+
+	const Section *sec = header.mSections;
+	if (sec[SEC_POSITIONS].mSize != numVerts * sizeof(Vec3) ||
+		(sec[SEC_NORMALS].mSize != 0 && sec[SEC_NORMALS].mSize != numVerts * sizeof(Vec3)) ||
+		(sec[SEC_TEXCOORDS].mSize != 0 && sec[SEC_TEXCOORDS].mSize != 2 * numVerts * sizeof(Real)) ||
+		sec[SEC_INDICES].mSize != 3 * numTris * sizeof(int) ||
+		sec[SEC_MATERIAL_IDS].mSize != numTris * sizeof(int) ||
+		sec[SEC_MATERIALS].mSize != header.mNumMaterials * sizeof(Material))
+		return false;
+
+	// the indices must not lead out of the arrays
+	const int *indices = getIndices();
+	for (unsigned long long i=0; i<3*numTris; ++i)
+	{
+		if (indices[i] < 0 || indices[i] >= header.mNumVertices)
+			return false;
+	}
+	const int *ids = getMaterialIds();
+	for (unsigned long long i=0; i<numTris; ++i)
+	{
+		if (ids[i] < 0 || ids[i] >= (header.mNumMaterials > 0 ? header.mNumMaterials : 1))
+			return false;
+	}
+	// the names end in the string section
+	const unsigned long long numChars = sec[SEC_STRINGS].mSize;
+	if (numChars > 0 && _section(SEC_STRINGS)[numChars - 1] != '\0')
+		return false;
+	const Material *materials = reinterpret_cast<const Material*>(_section(SEC_MATERIALS));
+	for (int i=0; i<header.mNumMaterials; ++i)
+	{
+		if (materials[i].mName >= numChars || materials[i].mTexture >= numChars)
+			return false;
+	}
+	if (sec[SEC_LIBRARIES].mSize % sizeof(Library) != 0)
+		return false;
+	const Library *libs = reinterpret_cast<const Library*>(_section(SEC_LIBRARIES));
+	for (unsigned long long i=0; i<sec[SEC_LIBRARIES].mSize / sizeof(Library); ++i)
+	{
+		if (libs[i].mPath >= numChars)
+			return false;
+	}
+	return true;
+}
+
+int SceneCache::getNumOfVertices() const
+{
+	return _header().mNumVertices;
+}
+
+int SceneCache::getNumOfTriangles() const
+{
+	return _header().mNumTriangles;
+}
+
+int SceneCache::getNumOfMaterials() const
+{
+	return _header().mNumMaterials;
+}
+
+const Vec3* SceneCache::getPositions() const
+{
+	return reinterpret_cast<const Vec3*>(_section(SEC_POSITIONS));
+}
+
+const Vec3* SceneCache::getNormals() const
+{
+	return reinterpret_cast<const Vec3*>(_section(SEC_NORMALS));
+}
+
+const Real* SceneCache::getTexCoords() const
+{
+	return reinterpret_cast<const Real*>(_section(SEC_TEXCOORDS));
+}
+
+const int* SceneCache::getIndices() const
+{
+	return reinterpret_cast<const int*>(_section(SEC_INDICES));
+}
+
+const int* SceneCache::getMaterialIds() const
+{
+	return reinterpret_cast<const int*>(_section(SEC_MATERIAL_IDS));
+}
+
+ObjMaterial SceneCache::getMaterial(int i) const
+{
+	const Material &src = reinterpret_cast<const Material*>(_section(SEC_MATERIALS))[i];
+	const char *strings = _section(SEC_STRINGS);
+	ObjMaterial mat;
+	mat.mName = strings + src.mName;
+	mat.mTexture = strings + src.mTexture;
+	for (int k=0; k<3; ++k)
+	{
+		mat.mAmbient[k] = src.mAmbient[k];
+		mat.mDiffuse[k] = src.mDiffuse[k];
+		mat.mSpecular[k] = src.mSpecular[k];
+		mat.mEmissive[k] = src.mEmissive[k];
+	}
+	mat.mShininess = src.mShininess;
+	return mat;
+}
+
+std::vector<String> SceneCache::getMaterialLibs() const
+{
+	const Library *libs = reinterpret_cast<const Library*>(_section(SEC_LIBRARIES));
+	const size_t numLibs = static_cast<size_t>(_header().mSections[SEC_LIBRARIES].mSize / sizeof(Library));
+	std::vector<String> paths(numLibs);
+	for (size_t i=0; i<numLibs; ++i)
+		paths[i] = _section(SEC_STRINGS) + libs[i].mPath;
+	return paths;
+}
+
+unsigned long long SceneCache::_hashPrims(const Scene& aScene, int aFirst)
+{
+	unsigned long long hash = HASH_SEED;
+	for (int i=0; i<aFirst; ++i)
+	{
+		const Primitive *prim = aScene.mPrimTable[i];
+		const int type[2] = { prim->getType(), prim->isBounded() };
+		hash = _hash(type, sizeof(type), hash);
+		if (!prim->isBounded())
+			continue;
+		const AABB box = prim->getAABB();
+		const Real bounds[6] = {
+			box.getMin().x, box.getMin().y, box.getMin().z,
+			box.getMax().x, box.getMax().y, box.getMax().z
+		};
+		hash = _hash(bounds, sizeof(bounds), hash);
+	}
+	return hash;
+}
+
+bool SceneCache::attachAccel(Scene& aScene) const
+{
+	const Header &header = _header();
+	if (header.mAccelType != aScene.mAccelType)
+		return false;
+	if (header.mAccelType == AT_LBVH && (header.mTreelets != 0) != aScene.mTreelets)
+		return false;
+
+	aScene.removeGrid();
+	Scene::PrimArray bounded;
+	aScene.buildPrimTable(bounded);
+	const int numPrims = aScene.mPrimTable.size();
+	const int first = numPrims - header.mNumTriangles;
+	if (numPrims != header.mNumPrims || _hashPrims(aScene, first) != header.mPrefixHash)
+		return false;
+
+	aScene.mExtends.setMin(Vec3(header.mExtends[0], header.mExtends[1], header.mExtends[2]));
+	aScene.mExtends.setMax(Vec3(header.mExtends[3], header.mExtends[4], header.mExtends[5]));
+	const Section *sec = header.mSections;
+	if (_isBVH(header.mAccelType))
+	{
+		const int numNodes = static_cast<int>(sec[SEC_BVH_NODES].mSize / sizeof(BVH::Node));
+		const int numLeafPrims = static_cast<int>(sec[SEC_BVH_PRIMS].mSize / sizeof(int));
+		const int *prims = reinterpret_cast<const int*>(_section(SEC_BVH_PRIMS));
+		for (int i=0; i<numLeafPrims; ++i)
+		{
+			if (prims[i] < 0 || prims[i] >= numPrims)
+				return false;
+		}
+		return aScene.mBVH->_attach(reinterpret_cast<const BVH::Node*>(_section(SEC_BVH_NODES)),
+			numNodes, prims, numLeafPrims, aScene.mPrimTable, aScene.mAccelArena);
+	}
+	else
+	{
+		unsigned long long numCells = 1;
+		for (int k=0; k<3; ++k)
+		{
+			if (header.mGridSize[k] <= 0 || header.mGridSize[k] > RT_GRIDMAXSIZE)
+				return false;
+			numCells *= header.mGridSize[k];
+		}
+		if (sec[SEC_CELL_OFFSETS].mSize != (numCells + 1) * sizeof(int))
+			return false;
+
+		// the cells are ranges of the references in order, which lead to
+		// the primitives of the table
+		const int numRefs = static_cast<int>(sec[SEC_CELL_PRIMS].mSize / sizeof(int));
+		const int *offsets = reinterpret_cast<const int*>(_section(SEC_CELL_OFFSETS));
+		const int *prims = reinterpret_cast<const int*>(_section(SEC_CELL_PRIMS));
+		if (offsets[0] != 0 || offsets[numCells] != numRefs)
+			return false;
+		for (unsigned long long i=0; i<numCells; ++i)
+		{
+			if (offsets[i + 1] < offsets[i])
+				return false;
+		}
+		for (int i=0; i<numRefs; ++i)
+		{
+			if (prims[i] < 0 || prims[i] >= numPrims)
+				return false;
+		}
+
+		for (int k=0; k<3; ++k)
+			aScene.mGridSize[k] = header.mGridSize[k];
+		aScene.mCellOffsets.attach(offsets, static_cast<int>(numCells + 1));
+		aScene.mCellPrims.attach(prims, numRefs);
+	}
+	return true;
+}
+
+// ------------------------------------------------------------------------------
+// Cache writing
+// ------------------------------------------------------------------------------
+
+/// the elements of an array, NULL if it is empty
+template <typename T>
+static const T* _data(const ArenaArray<T>& aArray)
+{
+	return aArray.empty() ? NULL : &aArray[0];
+}
+
+/// sections are written one after another, each on an aligned offset
+class CacheWriter
+{
+public:
+	explicit CacheWriter(FILE* aFile) : mFile(aFile), mOffset(0), mOk(true) {}
+
+	void write(const void* aData, size_t aSize)
+	{
+		if (aSize > 0 && fwrite(aData, 1, aSize, mFile) != aSize)
+			mOk = false;
+		mOffset += aSize;
+	}
+
+	/// pad to the alignment and write @aSize bytes as a section
+	template <typename T>
+	void writeSection(const T* aData, size_t aSize, unsigned long long* aSection)
+	{
+		static const char ZEROS[RT_ARENA_ALIGN] = { 0 };
+		write(ZEROS, static_cast<size_t>((RT_ARENA_ALIGN - mOffset % RT_ARENA_ALIGN) % RT_ARENA_ALIGN));
+		aSection[0] = mOffset;
+		aSection[1] = aSize;
+		if (aSize > 0)
+			write(aData, aSize);
+	}
+
+	bool isOk() const { return mOk; }
+
+private:
+	FILE* mFile;
+	unsigned long long mOffset;
+	bool mOk;
+};
+
+bool SceneCache::save(const String& aCacheFile, const String& aSource,
+					  const Scene& aScene, const TriangleMesh& aMesh,
+					  const std::vector<ObjMaterial>& aMaterials, const std::vector<int>& aMaterialIds,
+					  const std::vector<String>& aLibraries)
+{
+	Header header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.mMagic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+	header.mVersion = RT_CACHE_VERSION;
+	header.mByteOrder = BYTE_ORDER_MARK;
+	header.mRealSize = sizeof(Real);
+	header.mNodeSize = sizeof(BVH::Node);
+	if (!MappedFile::getFileInfo(aSource, header.mSourceSize, header.mSourceModified) ||
+		!_hashFile(aSource, header.mSourceHash))
+		return false;
+
+	const int numVerts = aMesh.getNumOfVertices();
+	const int numTris = aMesh.getNumOfTriangles();
+	header.mNumVertices = numVerts;
+	header.mNumTriangles = numTris;
+	header.mNumMaterials = static_cast<int>(aMaterials.size());
+
+	// the mesh must be the last one numbered in the table
+	const int numPrims = aScene.mPrimTable.size();
+	header.mAccelType = -1;
+	if (numPrims >= numTris && numTris > 0 &&
+		aScene.mPrimTable[numPrims - numTris] == aMesh.getTriangle(0))
+	{
+		header.mAccelType = aScene.mAccelType;
+		header.mTreelets = aScene.mTreelets ? 1 : 0;
+		header.mNumPrims = numPrims;
+		header.mPrefixHash = _hashPrims(aScene, numPrims - numTris);
+		for (int k=0; k<3; ++k)
+		{
+			header.mGridSize[k] = aScene.mGridSize[k];
+			header.mExtends[k] = aScene.mExtends.getMin()[k];
+			header.mExtends[k + 3] = aScene.mExtends.getMax()[k];
+		}
+	}
+
+	std::vector<Material> materials(aMaterials.size());
+	String strings;
+	for (size_t i=0; i<aMaterials.size(); ++i)
+	{
+		const ObjMaterial &src = aMaterials[i];
+		Material &mat = materials[i];
+		for (int k=0; k<3; ++k)
+		{
+			mat.mAmbient[k] = src.mAmbient[k];
+			mat.mDiffuse[k] = src.mDiffuse[k];
+			mat.mSpecular[k] = src.mSpecular[k];
+			mat.mEmissive[k] = src.mEmissive[k];
+		}
+		mat.mShininess = src.mShininess;
+		mat.mName = static_cast<unsigned int>(strings.size());
+		strings.append(src.mName.c_str(), src.mName.size() + 1);
+		mat.mTexture = static_cast<unsigned int>(strings.size());
+		strings.append(src.mTexture.c_str(), src.mTexture.size() + 1);
+	}
+
+	// a library found later makes the cache stale as well
+	std::vector<Library> libs(aLibraries.size());
+	for (size_t i=0; i<aLibraries.size(); ++i)
+	{
+		Library &lib = libs[i];
+		lib.mFound = MappedFile::getFileInfo(aLibraries[i], lib.mSize, lib.mModified) &&
+			_hashFile(aLibraries[i], lib.mHash);
+		if (!lib.mFound)
+			lib.mSize = lib.mModified = lib.mHash = 0;
+		lib.mPath = static_cast<unsigned int>(strings.size());
+		strings.append(aLibraries[i].c_str(), aLibraries[i].size() + 1);
+	}
+
+	// the leaves refer to the primitives by their numbers
+	std::vector<int> bvhPrims;
+	const BVH &bvh = *aScene.mBVH;
+	if (_isBVH(header.mAccelType))
+	{
+		bvhPrims.resize(bvh.mPrims.size());
+		for (int i=0; i<bvh.mPrims.size(); ++i)
+			bvhPrims[i] = bvh.mPrims[i]->getIndex();
+	}
+
+	const String tmpFile = aCacheFile + ".tmp";
+	FILE *fp = fopen(tmpFile.c_str(), "wb");
+	if (!fp)
+		return false;
+
+	Section *sec = header.mSections;
+	CacheWriter writer(fp);
+	writer.write(&header, sizeof(header));
+	writer.writeSection(_data(aMesh.mPositions), numVerts * sizeof(Vec3), &sec[SEC_POSITIONS].mOffset);
+	writer.writeSection(_data(aMesh.mNormals), aMesh.mNormals.size() * sizeof(Vec3),
+		&sec[SEC_NORMALS].mOffset);
+	writer.writeSection(_data(aMesh.mTexCoords), aMesh.mTexCoords.size() * sizeof(Real),
+		&sec[SEC_TEXCOORDS].mOffset);
+	writer.writeSection(_data(aMesh.mIndices), 3 * numTris * sizeof(int), &sec[SEC_INDICES].mOffset);
+	writer.writeSection(aMaterialIds.empty() ? NULL : &aMaterialIds[0], aMaterialIds.size() * sizeof(int),
+		&sec[SEC_MATERIAL_IDS].mOffset);
+	writer.writeSection(materials.empty() ? NULL : &materials[0], materials.size() * sizeof(Material),
+		&sec[SEC_MATERIALS].mOffset);
+	writer.writeSection(strings.data(), strings.size(), &sec[SEC_STRINGS].mOffset);
+	writer.writeSection(libs.empty() ? NULL : &libs[0], libs.size() * sizeof(Library),
+		&sec[SEC_LIBRARIES].mOffset);
+	if (header.mAccelType == AT_GRID)
+	{
+		writer.writeSection(_data(aScene.mCellOffsets), aScene.mCellOffsets.size() * sizeof(int),
+			&sec[SEC_CELL_OFFSETS].mOffset);
+		writer.writeSection(_data(aScene.mCellPrims), aScene.mCellPrims.size() * sizeof(int),
+			&sec[SEC_CELL_PRIMS].mOffset);
+	}
+	else if (_isBVH(header.mAccelType))
+	{
+		writer.writeSection(_data(bvh.mNodes), bvh.mNodes.size() * sizeof(BVH::Node),
+			&sec[SEC_BVH_NODES].mOffset);
+		writer.writeSection(bvhPrims.empty() ? NULL : &bvhPrims[0], bvhPrims.size() * sizeof(int),
+			&sec[SEC_BVH_PRIMS].mOffset);
+	}
+
+	// the section table is known now
+	bool ok = writer.isOk() && fseek(fp, 0, SEEK_SET) == 0 &&
+		fwrite(&header, sizeof(header), 1, fp) == 1;
+	ok = (fclose(fp) == 0) && ok;
+	if (ok)
+	{
+#ifdef _WIN32
+		// NOTE: rename() does not replace a file here, and a mapped one can
+		// not be removed, the old cache is kept then
+		remove(aCacheFile.c_str());
+#endif
+		ok = rename(tmpFile.c_str(), aCacheFile.c_str()) == 0;
+	}
+	if (!ok)
+		remove(tmpFile.c_str());
+	return ok;
+}
+
+}; // namespace RayTracer
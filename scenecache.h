@@ -0,0 +1,145 @@
+/********************************************************************
+	created:	2026/10/17
+	file name:	scenecache.h
+	author:		maxint lnychina@gmail.com
+*********************************************************************/
+
+#ifndef _RT_SCENECACHE_H_
+#define _RT_SCENECACHE_H_
+
+#include "common.h"
+#include "mappedfile.h"
+#include <vector>
+
+#define RT_CACHE_SUFFIX		".rtc"		// appended to the model file name
+#define RT_CACHE_VERSION	3			// raise when the layout changes
+
+namespace RayTracer {
+
+class Scene;
+class TriangleMesh;
+class ObjMaterial;
+
+// ------------------------------------------------------------------------------
+// Binary cache of a loaded obj model
+// ------------------------------------------------------------------------------
+
+/**	A file holding the welded mesh of a model, its materials and the
+	acceleration structure built over the scene. Every array is stored at
+	an aligned offset from the start of the file, so the mapped file is
+	used as it is: the vertices, the indices, the grid cells and the BVH
+	nodes are never copied. Only what holds pointers, the triangles, the
+	primitive table and the triangle blocks, is made again on loading.
+
+	The cache belongs to one build: the version, the byte order and the
+	sizes of Real and of a BVH node are checked. It is stale once the model
+	or one of its material libraries changes, which is found by the size
+	and time of the file, or by a hash of its contents when only the time
+	differs.
+ */
+class SceneCache
+{
+public:
+	SceneCache();
+	~SceneCache();
+
+	/**	Map the cache file of a model
+	\return
+		false if it is missing, of another build or older than the model
+		or its material libraries
+	 */
+	bool open(const String& aCacheFile, const String& aSource);
+	void close();
+
+	int getNumOfVertices() const;
+	int getNumOfTriangles() const;
+	int getNumOfMaterials() const;
+
+	const Vec3* getPositions() const;
+	/// NULL without normals
+	const Vec3* getNormals() const;
+	/// u, v per vertex, NULL without texture coordinates
+	const Real* getTexCoords() const;
+	/// three vertices per triangle
+	const int* getIndices() const;
+	/// material of each triangle
+	const int* getMaterialIds() const;
+	ObjMaterial getMaterial(int i) const;
+	/// paths of the material libraries of the model
+	std::vector<String> getMaterialLibs() const;
+
+	/**	Use the acceleration structure of the cache for @aScene, whose last
+		mesh is the one of the cache
+	\return
+		false if it was saved for another acceleration type or other
+		primitives besides the mesh, the scene must build its own then
+	 */
+	bool attachAccel(Scene& aScene) const;
+
+	/**	Write the cache of @aMesh, the last mesh of @aScene, and of the
+		acceleration structure built for the scene. The file is replaced
+		at once, a mapped old one stays valid.
+	\param
+		aMaterials		materials of the model
+		aMaterialIds	material of each triangle
+		aLibraries		paths of the material libraries of the model, also
+						of those not found
+	 */
+	static bool save(const String& aCacheFile, const String& aSource,
+		const Scene& aScene, const TriangleMesh& aMesh,
+		const std::vector<ObjMaterial>& aMaterials, const std::vector<int>& aMaterialIds,
+		const std::vector<String>& aLibraries);
+
+private:
+	struct Header;
+	struct Material;
+	struct Library;
+
+	/// a region of the file
+	struct Section
+	{
+		unsigned long long mOffset;
+		unsigned long long mSize;	// bytes
+	};
+
+	enum SectionType
+	{
+		SEC_POSITIONS = 0,
+		SEC_NORMALS,
+		SEC_TEXCOORDS,
+		SEC_INDICES,
+		SEC_MATERIAL_IDS,
+		SEC_MATERIALS,
+		SEC_STRINGS,
+		SEC_CELL_OFFSETS,
+		SEC_CELL_PRIMS,
+		SEC_BVH_NODES,
+		SEC_BVH_PRIMS,
+		SEC_LIBRARIES,
+		NUM_SECTIONS
+	};
+
+	const Header& _header() const;
+	/// the start of a section, NULL if it is empty
+	const char* _section(int aType) const;
+	/// whether the sections lie in the file and match the counts
+	bool _checkSections() const;
+	/// whether the material libraries are the ones the cache was made of
+	bool _checkLibraries(const String& aCacheFile) const;
+
+	/**	Hash of the primitives of @aScene numbered before @aFirst,
+		by their type and bounds
+	 */
+	static unsigned long long _hashPrims(const Scene& aScene, int aFirst);
+
+private:
+	MappedFile mFile;
+
+	// non-copyable
+	SceneCache(const SceneCache&);
+	SceneCache& operator=(const SceneCache&);
+};
+
+}; // namespace RayTracer
+
+#endif // _RT_SCENECACHE_H_
@@ -0,0 +1,126 @@
+/********************************************************************
+	created:	2026/10/17
+	file name:	simd.h
+	author:		maxint lnychina@gmail.com
+*********************************************************************/
+
+#ifndef _RT_SIMD_H_
+#define _RT_SIMD_H_
+
+#include "common.h"
+
+// ------------------------------------------------------------------------------
+// Thin wrapper of the SSE2 / AVX registers holding RT_SIMD_WIDTH Reals.
+// Without either instruction set it degrades to one Real per register.
+// ------------------------------------------------------------------------------
+
+#if defined(__AVX__)
+#define RT_SIMD_AVX
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define RT_SIMD_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace RayTracer {
+
+#if defined(RT_SIMD_AVX)
+#	ifdef HIGH_PRECISION
+		typedef __m256d SimdNative;
+#		define RT_SIMD_WIDTH	4
+#		define RT_SIMD_OP(op)	_mm256_##op##_pd
+#	else
+		typedef __m256 SimdNative;
+#		define RT_SIMD_WIDTH	8
+#		define RT_SIMD_OP(op)	_mm256_##op##_ps
+#	endif
+#	define RT_SIMD_CMP(a, b, pred)	RT_SIMD_OP(cmp)(a, b, pred)
+#elif defined(RT_SIMD_SSE2)
+#	ifdef HIGH_PRECISION
+		typedef __m128d SimdNative;
+#		define RT_SIMD_WIDTH	2
+#		define RT_SIMD_OP(op)	_mm_##op##_pd
+#	else
+		typedef __m128 SimdNative;
+#		define RT_SIMD_WIDTH	4
+#		define RT_SIMD_OP(op)	_mm_##op##_ps
+#	endif
+#else
+	typedef Real SimdNative;
+#	define RT_SIMD_WIDTH	1
+#endif
+
+/**	RT_SIMD_WIDTH Reals, a comparison gives a lane mask of the same type
+ */
+class SimdReal
+{
+public:
+	SimdReal() {}
+	SimdReal(SimdNative aVal) : v(aVal) {}
+
+#if RT_SIMD_WIDTH > 1
+	explicit SimdReal(Real aVal) : v(RT_SIMD_OP(set1)(aVal)) {}
+
+	static SimdReal load(const Real* aPtr)	{ return RT_SIMD_OP(loadu)(aPtr); }
+	void store(Real* aPtr) const			{ RT_SIMD_OP(storeu)(aPtr, v); }
+
+	friend SimdReal operator + (SimdReal a, SimdReal b)	{ return RT_SIMD_OP(add)(a.v, b.v); }
+	friend SimdReal operator - (SimdReal a, SimdReal b)	{ return RT_SIMD_OP(sub)(a.v, b.v); }
+	friend SimdReal operator * (SimdReal a, SimdReal b)	{ return RT_SIMD_OP(mul)(a.v, b.v); }
+	friend SimdReal operator / (SimdReal a, SimdReal b)	{ return RT_SIMD_OP(div)(a.v, b.v); }
+	friend SimdReal operator & (SimdReal a, SimdReal b)	{ return RT_SIMD_OP(and)(a.v, b.v); }
+	friend SimdReal operator | (SimdReal a, SimdReal b)	{ return RT_SIMD_OP(or)(a.v, b.v); }
+
+	/// lanes of @b where @a is not set
+	friend SimdReal andNot(SimdReal a, SimdReal b)		{ return RT_SIMD_OP(andnot)(a.v, b.v); }
+	/// NOTE: a NaN in either operand yields @b, as with the instructions
+	friend SimdReal simdMin(SimdReal a, SimdReal b)		{ return RT_SIMD_OP(min)(a.v, b.v); }
+	friend SimdReal simdMax(SimdReal a, SimdReal b)		{ return RT_SIMD_OP(max)(a.v, b.v); }
+	/// one bit per lane
+	friend int movemask(SimdReal m)						{ return RT_SIMD_OP(movemask)(m.v); }
+
+#	if defined(RT_SIMD_AVX)
+	friend SimdReal operator < (SimdReal a, SimdReal b)	{ return RT_SIMD_CMP(a.v, b.v, _CMP_LT_OQ); }
+	friend SimdReal operator > (SimdReal a, SimdReal b)	{ return RT_SIMD_CMP(a.v, b.v, _CMP_GT_OQ); }
+	friend SimdReal operator <= (SimdReal a, SimdReal b)	{ return RT_SIMD_CMP(a.v, b.v, _CMP_LE_OQ); }
+#	else
+	friend SimdReal operator < (SimdReal a, SimdReal b)	{ return RT_SIMD_OP(cmplt)(a.v, b.v); }
+	friend SimdReal operator > (SimdReal a, SimdReal b)	{ return RT_SIMD_OP(cmpgt)(a.v, b.v); }
+	friend SimdReal operator <= (SimdReal a, SimdReal b)	{ return RT_SIMD_OP(cmple)(a.v, b.v); }
+#	endif
+
+	/// lanes of @a where @m is set, otherwise lanes of @b
+	friend SimdReal select(SimdReal m, SimdReal a, SimdReal b)
+	{
+		return (m & a) | andNot(m, b);
+	}
+#else
+	// scalar fallback, a mask is 1 or 0
+	static SimdReal load(const Real* aPtr)	{ return *aPtr; }
+	void store(Real* aPtr) const			{ *aPtr = v; }
+
+	friend SimdReal operator + (SimdReal a, SimdReal b)	{ return a.v + b.v; }
+	friend SimdReal operator - (SimdReal a, SimdReal b)	{ return a.v - b.v; }
+	friend SimdReal operator * (SimdReal a, SimdReal b)	{ return a.v * b.v; }
+	friend SimdReal operator / (SimdReal a, SimdReal b)	{ return a.v / b.v; }
+	friend SimdReal operator & (SimdReal a, SimdReal b)	{ return Real(a.v != 0 && b.v != 0); }
+	friend SimdReal operator | (SimdReal a, SimdReal b)	{ return Real(a.v != 0 || b.v != 0); }
+	friend SimdReal andNot(SimdReal a, SimdReal b)		{ return Real(a.v == 0 && b.v != 0); }
+	friend SimdReal simdMin(SimdReal a, SimdReal b)		{ return (a.v < b.v) ? a.v : b.v; }
+	friend SimdReal simdMax(SimdReal a, SimdReal b)		{ return (a.v > b.v) ? a.v : b.v; }
+	friend int movemask(SimdReal m)						{ return m.v != 0; }
+	friend SimdReal operator < (SimdReal a, SimdReal b)	{ return Real(a.v < b.v); }
+	friend SimdReal operator > (SimdReal a, SimdReal b)	{ return Real(a.v > b.v); }
+	friend SimdReal operator <= (SimdReal a, SimdReal b)	{ return Real(a.v <= b.v); }
+	friend SimdReal select(SimdReal m, SimdReal a, SimdReal b)
+	{
+		return (m.v != 0) ? a.v : b.v;
+	}
+#endif
+
+	SimdNative v;
+};
+
+}; // namespace RayTracer
+
+#endif // _RT_SIMD_H_
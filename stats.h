@@ -0,0 +1,101 @@
+/********************************************************************
+	created:	2026/10/17
+	file name:	stats.h
+	author:		maxint lnychina@gmail.com
+*********************************************************************/
+
+#ifndef _RT_STATS_H_
+#define _RT_STATS_H_
+
+#include "common.h"
+
+namespace RayTracer {
+
+/// Traversal counters, only counted in a build with RT_STATS defined
+enum StatType
+{
+	STAT_TRAVERSALS		= 0,	// rays or packets walking the grid or the BVH
+	STAT_GRID_CELLS		= 1,	// grid cells visited
+	STAT_BVH_NODES		= 2,	// BVH nodes visited, once per packet
+	STAT_PRIM_TESTS		= 3,	// ray / primitive intersection tests
+	STAT_MAILBOX_SKIPS	= 4,	// tests skipped by the mailbox of the grid
+	STAT_AREA_SAMPLES	= 5,	// jittered shadow rays towards area lights
+	STAT_TYPES			= 6
+};
+
+// ------------------------------------------------------------------------------
+// Per-thread render statistics
+// ------------------------------------------------------------------------------
+
+/**	Counters of a render thread, merged by the engine when a frame ends.
+	The rays are always counted, one increment per ray. The traversal
+	counters sit in the inner loops, RT_STAT() compiles to nothing unless
+	RT_STATS is defined.
+ */
+class RenderStats
+{
+public:
+	RenderStats()
+	{
+		clear();
+	}
+
+	void clear()
+	{
+		int i;
+		for (i=0; i<RAY_TYPES; ++i)
+			mRays[i] = 0;
+		for (i=0; i<STAT_TYPES; ++i)
+			mCounts[i] = 0;
+	}
+
+	void merge(const RenderStats& aOther)
+	{
+		int i;
+		for (i=0; i<RAY_TYPES; ++i)
+			mRays[i] += aOther.mRays[i];
+		for (i=0; i<STAT_TYPES; ++i)
+			mCounts[i] += aOther.mCounts[i];
+	}
+
+	unsigned long long getRays(RayType aType) const { return mRays[aType]; }
+	unsigned long long getTotalRays() const
+	{
+		unsigned long long total = 0;
+		for (int i=0; i<RAY_TYPES; ++i)
+			total += mRays[i];
+		return total;
+	}
+
+	unsigned long long get(StatType aType) const { return mCounts[aType]; }
+
+	/// @aType per traversal, 0 without traversals
+	double getPerTraversal(StatType aType) const
+	{
+		unsigned long long n = mCounts[STAT_TRAVERSALS];
+		return n ? static_cast<double>(mCounts[aType]) / n : 0;
+	}
+
+	/// whether the traversal counters are counted in this build
+	static bool isEnabled()
+	{
+#ifdef RT_STATS
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	unsigned long long mRays[RAY_TYPES];
+	unsigned long long mCounts[STAT_TYPES];
+};
+
+}; // namespace RayTracer
+
+#ifdef RT_STATS
+#define RT_STAT(aStats, aType, aCount)	((aStats).mCounts[aType] += (aCount))
+#else
+#define RT_STAT(aStats, aType, aCount)	((void)(aStats))	// keeps @aStats used
+#endif
+
+#endif // _RT_STATS_H_
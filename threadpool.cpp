@@ -0,0 +1,154 @@
+/********************************************************************
+	created:	2026/10/17
+	file name:	threadpool.cpp
+	author:		maxint lnychina@gmail.com
+*********************************************************************/
+
+#include "threadpool.h"
+#include "common.h"
+
+#include <chrono>
+
+namespace RayTracer {
+
+// ------------------------------------------------------------------------------
+// ThreadPool class implementation
+// ------------------------------------------------------------------------------
+
+ThreadPool::ThreadPool(int aNumThreads)
+: mNumThreads(0)
+, mQueued(0)
+, mPending(0)
+, mNextQueue(0)
+, mQuit(false)
+{
+	if (aNumThreads <= 0)
+		aNumThreads = getHardwareThreads();
+	mNumThreads = aNumThreads;
+
+	// NOTE: the queues must be complete before any worker starts stealing
+	for (int i=0; i<aNumThreads; ++i)
+		mQueues.push_back(new WorkQueue);
+	mWorkers.reserve(aNumThreads);
+	for (int i=0; i<aNumThreads; ++i)
+		mWorkers.push_back(std::thread(&ThreadPool::_workerLoop, this, i));
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mQuit = true;
+	}
+	mWorkCond.notify_all();
+
+	for (size_t i=0; i<mWorkers.size(); ++i)
+		mWorkers[i].join();
+	for (size_t i=0; i<mQueues.size(); ++i)
+		SAFE_DELETE(mQueues[i]);
+}
+
+int ThreadPool::getHardwareThreads()
+{
+	int n = static_cast<int>(std::thread::hardware_concurrency());
+	return std::max(1, n);
+}
+
+void ThreadPool::submit(const Task& aTask)
+{
+	++mPending;
+
+	int idx;
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		idx = mNextQueue;
+		mNextQueue = (mNextQueue + 1) % getNumThreads();
+	}
+	{
+		WorkQueue *queue = mQueues[idx];
+		std::lock_guard<std::mutex> lock(queue->mMutex);
+		queue->mTasks.push_back(aTask);
+	}
+	{
+		// NOTE: count under the lock so a sleeping worker cannot miss the wakeup
+		std::lock_guard<std::mutex> lock(mMutex);
+		++mQueued;
+	}
+	mWorkCond.notify_one();
+}
+
+void ThreadPool::wait()
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+	while (mPending > 0)
+		mDoneCond.wait(lock);
+}
+
+bool ThreadPool::waitFor(int aMilliseconds)
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+	std::chrono::steady_clock::time_point deadline =
+		std::chrono::steady_clock::now() + std::chrono::milliseconds(aMilliseconds);
+	while (mPending > 0)
+	{
+		if (mDoneCond.wait_until(lock, deadline) == std::cv_status::timeout)
+			return mPending == 0;
+	}
+	return true;
+}
+
+bool ThreadPool::_pop(int aIndex, Task& aTask)
+{
+	WorkQueue *queue = mQueues[aIndex];
+	std::lock_guard<std::mutex> lock(queue->mMutex);
+	if (queue->mTasks.empty())
+		return false;
+	aTask = queue->mTasks.back();
+	queue->mTasks.pop_back();
+	--mQueued;
+	return true;
+}
+
+bool ThreadPool::_steal(int aIndex, Task& aTask)
+{
+	int n = getNumThreads();
+	for (int i=1; i<n; ++i)
+	{
+		WorkQueue *queue = mQueues[(aIndex + i) % n];
+		std::lock_guard<std::mutex> lock(queue->mMutex);
+		if (queue->mTasks.empty())
+			continue;
+		aTask = queue->mTasks.front();
+		queue->mTasks.pop_front();
+		--mQueued;
+		return true;
+	}
+	return false;
+}
+
+void ThreadPool::_workerLoop(int aIndex)
+{
+	Task task;
+	while (1)
+	{
+		if (_pop(aIndex, task) || _steal(aIndex, task))
+		{
+			task(aIndex);
+			task = Task();
+			if (--mPending == 0)
+			{
+				std::lock_guard<std::mutex> lock(mMutex);
+				mDoneCond.notify_all();
+			}
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(mMutex);
+		while (!mQuit && mQueued == 0)
+			mWorkCond.wait(lock);
+		if (mQuit)
+			return;
+	}
+}
+
+}; // namespace RayTracer
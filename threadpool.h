@@ -0,0 +1,92 @@
+/********************************************************************
+	created:	2026/10/17
+	file name:	threadpool.h
+	author:		maxint lnychina@gmail.com
+*********************************************************************/
+
+#ifndef _RT_THREADPOOL_H_
+#define _RT_THREADPOOL_H_
+
+#include <vector>
+#include <deque>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+namespace RayTracer {
+
+// ------------------------------------------------------------------------------
+// Persistent thread pool with work-stealing deques
+// ------------------------------------------------------------------------------
+
+class ThreadPool
+{
+public:
+	/**	A task receives the index of the worker running it, so callers can
+		keep per-worker state without locking.
+	 */
+	typedef std::function<void(int)> Task;
+
+	/**	Create the worker threads
+	\param
+		aNumThreads	number of workers, 0 means one per hardware thread
+	 */
+	explicit ThreadPool(int aNumThreads = 0);
+	~ThreadPool();
+
+	int getNumThreads() const { return mNumThreads; }
+
+	/**	Queue a task, deques are filled round-robin and idle workers steal
+		from the front of the others.
+	 */
+	void submit(const Task& aTask);
+
+	/**	Block until every submitted task has finished
+	 */
+	void wait();
+
+	/**	Block at most @aMilliseconds
+	\return
+		true	every submitted task has finished
+		false	time out
+	 */
+	bool waitFor(int aMilliseconds);
+
+	/**	Default number of workers of this machine
+	 */
+	static int getHardwareThreads();
+
+private:
+	ThreadPool(const ThreadPool&);
+	ThreadPool& operator=(const ThreadPool&);
+
+	void _workerLoop(int aIndex);
+	bool _pop(int aIndex, Task& aTask);
+	bool _steal(int aIndex, Task& aTask);
+
+private:
+	/// one deque per worker, the owner works LIFO at the back
+	struct WorkQueue
+	{
+		std::mutex mMutex;
+		std::deque<Task> mTasks;
+	};
+
+	int mNumThreads;
+	std::vector<std::thread> mWorkers;
+	std::vector<WorkQueue*> mQueues;
+	std::atomic<int> mQueued;	// tasks waiting in the deques
+	std::atomic<int> mPending;	// tasks submitted but not finished
+	int mNextQueue;
+	bool mQuit;
+
+	std::mutex mMutex;
+	std::condition_variable mWorkCond;
+	std::condition_variable mDoneCond;
+};
+
+}; // namespace RayTracer
+
+#endif // _RT_THREADPOOL_H_